@@ -89,6 +89,14 @@ auto Demo_Stats = [](Application& app)
         buf = util::format(u8"%lld us", average(&record, over, f));
         ImGuiLTable::PlotLines("Record", get_timings, &record, frame_count, f, buf.c_str(), 0.0f, 10.0f);
 
+        buf = util::format("%d ran, %d waiting, %lld / %lld us", (int)app.stats.updatesRun, (int)app.stats.updateQueue,
+            (long long)app.stats.updateBudgetUsed.count(), (long long)app.vsgcontext->updateBudget.count());
+        ImGuiLTable::Text("Update queue", "%s", buf.c_str());
+
+        buf = util::format("%.1f KB queued, %.1f KB streamed",
+            (double)app.stats.uploadBytes / 1024.0, (double)app.stats.streamBytes / 1024.0);
+        ImGuiLTable::Text("Uploads", "%s", buf.c_str());
+
         ImGuiLTable::End();
     }
 
@@ -132,12 +140,11 @@ auto Demo_Stats = [](Application& app)
     {
         ImGuiLTable::Text("Last frame rendered", "%s", std::to_string(app.frameCount()).c_str());
 
-        if (!app.mapNode->profile.isComposite())
-        {
-            //auto& engine = app.mapNode->terrainNode->->engine;
-            //ImGuiLTable::Text("Terrain tiles resident", "%s", std::to_string(engine->tiles.size()).c_str());
-            //ImGuiLTable::Text("Terrain geometry pool", "%s", std::to_string(engine->geometryPool.size()).c_str());
-        }
+        auto usage = app.mapNode->terrainNode->usage();
+        ImGuiLTable::Text("Terrain tiles resident", "%s", std::to_string(usage.tiles).c_str());
+        ImGuiLTable::Text("Terrain CPU memory", "%.1f MB", (double)usage.memory.cpu / 1048576.0);
+        ImGuiLTable::Text("Terrain GPU memory", "%.1f MB", (double)usage.memory.gpu / 1048576.0);
+        ImGuiLTable::Text("Terrain tiles evicted", "%s", std::to_string(usage.evicted).c_str());
         ImGuiLTable::End();
     }
 
@@ -153,9 +160,9 @@ auto Demo_Stats = [](Application& app)
         auto contentCache = app.io().services().contentCache;
         if (contentCache)
         {
-            ImGui::TableNextColumn(); ImGui::Text("%s", "URI cache");
-            ImGui::TableNextColumn(); ImGui::Text("%ld", contentCache->capacity());
-            ImGui::TableNextColumn(); ImGui::Text("%ld", contentCache->size());
+            ImGui::TableNextColumn(); ImGui::Text("%s", "URI cache (MB)");
+            ImGui::TableNextColumn(); ImGui::Text("%ld", contentCache->capacity() / 1048576);
+            ImGui::TableNextColumn(); ImGui::Text("%.1f", (double)contentCache->size() / 1048576.0);
             ImGui::TableNextColumn(); ImGui::Text("%d", contentCache->hits());
             ImGui::TableNextColumn(); ImGui::Text("%d", contentCache->misses());
         }
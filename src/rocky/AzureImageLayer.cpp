@@ -119,7 +119,7 @@ AzureImageLayer::createTileImplementation(const TileKey& key, const IOOptions& i
         return fetch.error();
     }
 
-    std::istringstream stream(fetch->content.data);
+    util::imemstream stream(fetch->content.data);
     auto image_rr = io.services().readImageFromStream(stream, fetch->content.type, io);
 
     if (image_rr.failed())
@@ -135,7 +135,7 @@ BingImageLayer::createTileImplementation(const TileKey& key, const IOOptions& io
     }
 
     // Decode the stream:
-    std::istringstream stream(fetch->content.data);
+    util::imemstream stream(fetch->content.data);
     auto image_rr = io.services().readImageFromStream(stream, fetch->content.type, io);
 
     if (image_rr.failed())
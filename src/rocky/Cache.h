@@ -7,10 +7,14 @@
 
 #include <rocky/Common.h>
 #include <rocky/Utils.h>
-#include <mutex>
-#include <shared_mutex>
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <shared_mutex>
 #include <unordered_map>
 
 namespace ROCKY_NAMESPACE
@@ -47,8 +51,8 @@ namespace ROCKY_NAMESPACE
             using entry_t = std::pair<std::weak_ptr<V>, METADATA>;
             mutable std::unordered_map<K, entry_t> _lut;
             mutable std::shared_mutex _mutex;
-            std::uint32_t _hits = 0;
-            std::uint32_t _misses = 0;
+            std::atomic_uint32_t _hits = { 0u };
+            std::atomic_uint32_t _misses = { 0u };
             std::uint32_t _puts = 0;
 
             using data_t = std::pair<std::shared_ptr<V>, METADATA>;
@@ -111,43 +115,67 @@ namespace ROCKY_NAMESPACE
         };
 
         /**
-        * LRUCache is a thread-safe implementation of a Least Recently Used (LRU) cache.
-        * It stores key-value pairs and evicts the least recently used item when the cache reaches its capacity.
-        * The cache is protected by a mutex to ensure thread safety.
-        * Adapted from https://www.geeksforgeeks.org/lru-cache-implementation
-        * Optimized by Copilot
+        * LRUCache is a thread-safe, sharded Least Recently Used (LRU) cache.
+        *
+        * Keys are hashed into N independent shards, each with its own lock and
+        * LRU list, so concurrent readers of different keys rarely contend.
+        * Each shard holds 1/N of the total capacity and evicts its own least
+        * recently used entries, so the eviction order is LRU per shard and
+        * approximately LRU overall.
+        *
+        * By default every entry costs 1, and capacity is an entry count. Supply
+        * a cost function to budget by something else (like bytes) instead.
+        * Since a single entry must fit in its shard, a cost-budgeted cache is
+        * not sharded unless you ask for shards explicitly.
         */
-        template<class K, class V>
+        template<class K, class V, class HASH = std::hash<K>>
         class LRUCache : public rocky::Cache<K, V>
         {
-        private:
-            mutable std::mutex _mutex;
-            size_t _capacity;
-            using E = typename std::pair<K, V>;
-            mutable typename std::list<E> _cache;
-            mutable vector_map<K, typename std::list<E>::iterator> _map;
-            std::uint32_t _hits = 0, _misses = 0;
-
         public:
+            //! Function that returns the cost of a value (in capacity units)
+            using CostFunction = std::function<std::size_t(const V&)>;
 
             //! Constructs an LRUCache with the specified capacity.
-            //! \param capacity_ The maximum number of items the cache can hold.
-            LRUCache(size_t capacity = 32) : _capacity(capacity)
+            //! \param capacity The maximum total cost the cache can hold.
+            //! \param cost Cost of each value; if empty, every entry costs 1.
+            //! \param shards Number of shards (rounded up to a power of two); 0 = automatic.
+            //!   Each shard holds 1/shards of the capacity, which caps the largest cacheable entry.
+            LRUCache(size_t capacity = 32, CostFunction cost = {}, unsigned shards = 0) :
+                _cost(cost)
             {
-                _map._container.reserve(capacity);
+                if (shards == 0)
+                {
+                    // With a cost function the capacity says nothing about how many entries
+                    // to expect, and any shard split would shrink the largest entry we can
+                    // hold, so don't shard. With entry counts, don't shard caches that are
+                    // too small to split evenly.
+                    shards = _cost ? 1u : (unsigned)std::min(capacity / 32, (size_t)16);
+                }
+
+                _numShards = 1;
+                while (_numShards < shards && _numShards < 64)
+                    _numShards <<= 1;
+
+                _shards = std::make_unique<Shard[]>(_numShards);
+                setCapacity(capacity);
             }
 
             //! Sets the cache capacity and clears all current entries and statistics.
-            //! \param value The new maximum number of items the cache can hold.
+            //! \param value The new maximum total cost the cache can hold.
             inline void setCapacity(size_t value)
             {
-                std::scoped_lock L(_mutex);
-                _cache.clear();
-                _map.clear();
-                _capacity = std::max((size_t)0, value);
-                _map._container.reserve(_capacity);
-                _hits = 0;
-                _misses = 0;
+                _capacity = value;
+                for (unsigned i = 0; i < _numShards; ++i)
+                {
+                    auto& shard = _shards[i];
+                    std::scoped_lock L(shard.mutex);
+                    shard.list.clear();
+                    shard.map.clear();
+                    shard.cost = 0;
+                    // distribute the remainder so the shard capacities sum to the total
+                    shard.capacity = value / _numShards + (i < value % _numShards ? 1 : 0);
+                }
+                _hits = 0, _misses = 0;
             }
 
             //! Retrieves the value associated with the given key, if present.
@@ -158,75 +186,147 @@ namespace ROCKY_NAMESPACE
             {
                 if (_capacity == 0)
                     return {};
-                std::scoped_lock L(_mutex);
-                auto it = _map.find(key);
-                if (it == _map.end()) {
-                    ++_misses;
+
+                auto& shard = shardFor(key);
+                std::scoped_lock L(shard.mutex);
+                auto it = shard.map.find(key);
+                if (it == shard.map.end())
+                {
+                    _misses.fetch_add(1, std::memory_order_relaxed);
                     return {};
                 }
-                if (it->second != std::prev(_cache.end()))
-                    _cache.splice(_cache.end(), _cache, it->second);
-                ++_hits;
-                return it->second->second;
+                if (it->second != std::prev(shard.list.end()))
+                    shard.list.splice(shard.list.end(), shard.list, it->second);
+                _hits.fetch_add(1, std::memory_order_relaxed);
+                return it->second->value;
             }
 
             //! Inserts or updates the value for the given key.
             //! If the key already exists, updates its value and moves it to the most recently used position.
-            //! If the cache is full, evicts the least recently used item.
+            //! Evicts least recently used items until the new item fits; an item that
+            //! costs more than the entire shard is not cached at all.
             //! \param key The key to insert or update.
             //! \param value The value to associate with the key.
             inline void put(const K& key, const V& value) override
             {
                 if (_capacity == 0)
                     return;
-                std::scoped_lock L(_mutex);
-                auto it = _map.find(key);
-                if (it != _map.end()) {
-                    // Update value and move to back
-                    it->second->second = value;
-                    _cache.splice(_cache.end(), _cache, it->second);
+
+                auto cost = _cost ? _cost(value) : 1;
+                auto& shard = shardFor(key);
+                std::scoped_lock L(shard.mutex);
+
+                auto it = shard.map.find(key);
+                if (it != shard.map.end())
+                {
+                    shard.cost -= it->second->cost;
+                    shard.list.erase(it->second);
+                    shard.map.erase(it);
                 }
-                else {
-                    if (_cache.size() == _capacity) {
-                        auto first_key = _cache.front().first;
-                        _cache.pop_front();
-                        _map.erase(first_key);
-                    }
-                    _cache.emplace_back(key, value);
-                    _map[key] = std::prev(_cache.end());
+
+                if (cost > shard.capacity)
+                    return;
+
+                while (shard.cost + cost > shard.capacity && !shard.list.empty())
+                {
+                    auto& lru = shard.list.front();
+                    shard.cost -= lru.cost;
+                    shard.map.erase(lru.key);
+                    shard.list.pop_front();
                 }
+
+                shard.list.push_back(Entry{ key, value, cost });
+                shard.map[key] = std::prev(shard.list.end());
+                shard.cost += cost;
             }
 
-            //! Returns the maximum number of items the cache can hold.
+            //! Returns the maximum total cost the cache can hold.
             inline std::size_t capacity() const override
             {
                 return _capacity;
             }
 
+            //! Returns the total cost of all entries in the cache.
             std::size_t size() const override
             {
-                std::scoped_lock lock(_mutex);
-                return _map.size();
+                std::size_t total = 0;
+                for (unsigned i = 0; i < _numShards; ++i)
+                {
+                    std::scoped_lock L(_shards[i].mutex);
+                    total += _shards[i].cost;
+                }
+                return total;
+            }
+
+            //! Returns the number of entries in the cache.
+            std::size_t count() const
+            {
+                std::size_t total = 0;
+                for (unsigned i = 0; i < _numShards; ++i)
+                {
+                    std::scoped_lock L(_shards[i].mutex);
+                    total += _shards[i].map.size();
+                }
+                return total;
             }
 
             std::uint32_t hits() const override
             {
-                return _hits;
+                return _hits.load(std::memory_order_relaxed);
             }
 
             std::uint32_t misses() const override
             {
-                return _misses;
+                return _misses.load(std::memory_order_relaxed);
             }
 
             //! Clears all entries from the cache and resets statistics.
-            inline void clear()
+            inline void clear() override
             {
-                std::scoped_lock L(_mutex);
-                _cache.clear();
-                _map.clear();
+                for (unsigned i = 0; i < _numShards; ++i)
+                {
+                    auto& shard = _shards[i];
+                    std::scoped_lock L(shard.mutex);
+                    shard.list.clear();
+                    shard.map.clear();
+                    shard.cost = 0;
+                }
                 _hits = 0, _misses = 0;
             }
+
+        private:
+            struct Entry
+            {
+                K key;
+                V value;
+                std::size_t cost;
+            };
+
+            struct Shard
+            {
+                mutable std::mutex mutex;
+                std::list<Entry> list;
+                std::unordered_map<K, typename std::list<Entry>::iterator, HASH> map;
+                std::size_t cost = 0;
+                std::size_t capacity = 0;
+            };
+
+            inline Shard& shardFor(const K& key)
+            {
+                // mix the hash so keys with poor low bits still spread out
+                std::uint64_t h = (std::uint64_t)HASH()(key);
+                h ^= h >> 33;
+                h *= 0xff51afd7ed558ccdull;
+                h ^= h >> 33;
+                return _shards[h & (_numShards - 1)];
+            }
+
+            std::unique_ptr<Shard[]> _shards;
+            unsigned _numShards = 1;
+            std::size_t _capacity = 0;
+            CostFunction _cost;
+            std::atomic_uint32_t _hits = { 0u };
+            std::atomic_uint32_t _misses = { 0u };
         };
     }
-}
\ No newline at end of file
+}
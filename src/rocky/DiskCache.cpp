@@ -0,0 +1,422 @@
+/**
+ * rocky c++
+ * Copyright 2025 Pelican Mapping
+ * MIT License
+ */
+#include "DiskCache.h"
+#include "Utils.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+using namespace ROCKY_NAMESPACE;
+
+#define LC "[DiskCache] "
+
+namespace
+{
+    // identifies a cache file and its format version
+    constexpr char MAGIC[4] = { 'R', 'K', 'C', '1' };
+
+    // once the cache exceeds capacity, evict down to this fraction of it
+    constexpr double EVICTION_TARGET = 0.9;
+
+    // FNV-1a; unlike std::hash, stable across runs and platforms,
+    // which is what we need for a persistent file name.
+    inline std::uint64_t hashKey(const std::string& key)
+    {
+        std::uint64_t h = 0xcbf29ce484222325ull;
+        for (auto c : key)
+        {
+            h ^= (std::uint8_t)c;
+            h *= 0x100000001b3ull;
+        }
+        return h;
+    }
+
+    template<typename T>
+    inline void write_pod(std::ostream& out, const T& value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    inline bool read_pod(std::istream& in, T& value)
+    {
+        return (bool)in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+
+    inline void write_string(std::ostream& out, const std::string& value)
+    {
+        write_pod(out, (std::uint64_t)value.size());
+        out.write(value.data(), value.size());
+    }
+
+    inline bool read_string(std::istream& in, std::string& value, std::uint64_t maxSize)
+    {
+        std::uint64_t size = 0;
+        if (!read_pod(in, size) || size > maxSize)
+            return false;
+        value.resize(size);
+        return size == 0 || (bool)in.read(value.data(), size);
+    }
+
+    inline std::int64_t to_seconds(std::chrono::system_clock::time_point t)
+    {
+        return std::chrono::duration_cast<std::chrono::seconds>(t.time_since_epoch()).count();
+    }
+}
+
+struct DiskCache::Impl
+{
+    struct Entry
+    {
+        std::size_t bytes = 0;
+        std::uint64_t lastAccess = 0;
+    };
+
+    struct Pending
+    {
+        std::string key;
+        Content content;
+        std::uint64_t sequence = 0;
+        std::int64_t expires = 0; // seconds since the epoch
+    };
+
+    std::filesystem::path root;
+    std::size_t capacity = 0;
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::uint64_t, Entry> index;
+    std::unordered_map<std::uint64_t, Pending> pending;
+    std::size_t totalBytes = 0;
+    std::uint64_t clock = 0;
+
+    jobs::jobpool* pool = nullptr;
+    std::shared_ptr<jobs::jobgroup> writes = jobs::jobgroup::create();
+
+    std::filesystem::path pathFor(std::uint64_t hash) const
+    {
+        auto name = util::format("%016llx", (unsigned long long)hash);
+        return root / name.substr(0, 2) / name;
+    }
+
+    // Must hold the mutex.
+    void touch(std::uint64_t hash, std::size_t bytes, std::uint64_t sequence)
+    {
+        auto& entry = index[hash];
+        totalBytes = totalBytes - entry.bytes + bytes;
+        entry.bytes = bytes;
+        entry.lastAccess = std::max(entry.lastAccess, sequence);
+    }
+
+    // Must hold the mutex.
+    void forget(std::uint64_t hash)
+    {
+        auto i = index.find(hash);
+        if (i != index.end())
+        {
+            totalBytes -= i->second.bytes;
+            index.erase(i);
+        }
+    }
+
+    // Must hold the mutex. Returns the files to delete; the caller deletes them
+    // after releasing the lock.
+    std::vector<std::uint64_t> selectEvictions()
+    {
+        std::vector<std::uint64_t> victims;
+        if (totalBytes <= capacity)
+            return victims;
+
+        std::vector<std::pair<std::uint64_t, std::uint64_t>> byAge; // lastAccess, hash
+        byAge.reserve(index.size());
+        for (auto& i : index)
+            byAge.emplace_back(i.second.lastAccess, i.first);
+        std::sort(byAge.begin(), byAge.end());
+
+        auto target = (std::size_t)(EVICTION_TARGET * (double)capacity);
+        for (auto& [age, hash] : byAge)
+        {
+            if (totalBytes <= target)
+                break;
+            victims.push_back(hash);
+            forget(hash);
+        }
+        return victims;
+    }
+
+    void scan()
+    {
+        std::error_code ec;
+        std::vector<std::pair<std::filesystem::file_time_type, std::uint64_t>> found;
+
+        for (auto& de : std::filesystem::recursive_directory_iterator(root, ec))
+        {
+            if (!de.is_regular_file(ec))
+                continue;
+
+            auto name = de.path().filename().string();
+            if (name.size() != 16)
+                continue;
+
+            char* end = nullptr;
+            std::uint64_t hash = std::strtoull(name.c_str(), &end, 16);
+            if (end != name.c_str() + name.size())
+                continue;
+
+            index[hash].bytes = (std::size_t)de.file_size(ec);
+            totalBytes += index[hash].bytes;
+            found.emplace_back(de.last_write_time(ec), hash);
+        }
+
+        // seed the LRU order from the file times so the oldest files go first
+        std::sort(found.begin(), found.end());
+        for (auto& f : found)
+            index[f.second].lastAccess = ++clock;
+    }
+
+    void write(std::uint64_t hash, const Pending& entry)
+    {
+        auto& content = entry.content;
+        auto path = pathFor(hash);
+        auto temp = path;
+        temp += ".tmp";
+
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+
+        {
+            std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+            if (!out)
+            {
+                Log()->debug(LC "Failed to open {} for writing", temp.string());
+                return;
+            }
+
+            out.write(MAGIC, sizeof(MAGIC));
+            write_pod(out, entry.expires);
+            write_pod(out, to_seconds(content.timestamp));
+            write_string(out, entry.key);
+            write_string(out, content.type);
+            write_string(out, content.data);
+
+            if (!out)
+            {
+                out.close();
+                std::filesystem::remove(temp, ec);
+                return;
+            }
+        }
+
+        // rename is atomic, so readers never see a partial file
+        std::filesystem::rename(temp, path, ec);
+        if (ec)
+        {
+            std::filesystem::remove(temp, ec);
+            return;
+        }
+
+        std::vector<std::uint64_t> victims;
+        {
+            std::scoped_lock lock(mutex);
+            touch(hash, (std::size_t)std::filesystem::file_size(path, ec), entry.sequence);
+            victims = selectEvictions();
+        }
+
+        for (auto victim : victims)
+            std::filesystem::remove(pathFor(victim), ec);
+    }
+};
+
+DiskCache::DiskCache(const std::string& path, std::size_t capacityBytes) :
+    _impl(std::make_shared<Impl>())
+{
+    _impl->root = path;
+    _impl->capacity = capacityBytes;
+
+    std::error_code ec;
+    std::filesystem::create_directories(_impl->root, ec);
+    if (!std::filesystem::is_directory(_impl->root, ec))
+    {
+        status = Failure(Failure::ResourceUnavailable, "Cannot create cache folder " + path);
+        return;
+    }
+
+    _impl->scan();
+
+    // one writer thread is plenty; the disk is the bottleneck.
+    _impl->pool = jobs::get_pool("rocky::disk_cache", 1u);
+
+    Log()->info(LC "Using {} ({} MB of {} MB used)", path,
+        _impl->totalBytes / 1048576u, _impl->capacity / 1048576u);
+}
+
+DiskCache::~DiskCache()
+{
+    flush();
+}
+
+std::optional<Content>
+DiskCache::get(const std::string& key)
+{
+    if (status.failed())
+        return {};
+
+    auto hash = hashKey(key);
+
+    {
+        std::scoped_lock lock(_impl->mutex);
+
+        // still waiting to be written?
+        auto p = _impl->pending.find(hash);
+        if (p != _impl->pending.end() && p->second.key == key)
+        {
+            ++_hits;
+            return p->second.content;
+        }
+
+        if (_impl->index.count(hash) == 0)
+        {
+            ++_misses;
+            return {};
+        }
+    }
+
+    auto path = _impl->pathFor(hash);
+    std::ifstream in(path, std::ios::binary);
+
+    char magic[sizeof(MAGIC)];
+    std::int64_t expires = 0, timestamp = 0;
+    std::string storedKey;
+    Content content;
+
+    bool ok =
+        in &&
+        in.read(magic, sizeof(magic)) &&
+        std::equal(magic, magic + sizeof(magic), MAGIC) &&
+        read_pod(in, expires) &&
+        read_pod(in, timestamp) &&
+        read_string(in, storedKey, 65536u) &&
+        storedKey == key &&
+        read_string(in, content.type, 1024u) &&
+        read_string(in, content.data, _impl->capacity);
+
+    in.close();
+
+    if (!ok || expires <= to_seconds(std::chrono::system_clock::now()))
+    {
+        // expired or corrupt; but if it's a hash collision, leave the
+        // other key's file alone.
+        bool collision = !storedKey.empty() && storedKey != key;
+        if (!collision)
+        {
+            remove(key);
+        }
+        ++_misses;
+        return {};
+    }
+
+    content.timestamp = std::chrono::system_clock::time_point(std::chrono::seconds(timestamp));
+
+    {
+        std::scoped_lock lock(_impl->mutex);
+        auto i = _impl->index.find(hash);
+        if (i != _impl->index.end())
+            i->second.lastAccess = ++_impl->clock;
+    }
+
+    ++_hits;
+    return content;
+}
+
+void
+DiskCache::put(const std::string& key, const Content& value)
+{
+    put(key, value, defaultTTL);
+}
+
+void
+DiskCache::put(const std::string& key, const Content& value, std::chrono::seconds ttl)
+{
+    if (status.failed() || ttl.count() <= 0 || value.data.size() > _impl->capacity)
+        return;
+
+    auto hash = hashKey(key);
+    auto expires = to_seconds(std::chrono::system_clock::now()) + ttl.count();
+
+    {
+        // stamp the LRU order now, since writes may complete out of order
+        std::scoped_lock lock(_impl->mutex);
+        _impl->pending[hash] = Impl::Pending{ key, value, ++_impl->clock, expires };
+    }
+
+    // write-behind. The job holds a reference to the impl so it's safe even
+    // if the cache object goes away first.
+    auto impl = _impl;
+    auto write = [impl, hash]()
+        {
+            Impl::Pending entry;
+            {
+                std::scoped_lock lock(impl->mutex);
+                auto p = impl->pending.find(hash);
+                if (p == impl->pending.end())
+                    return; // already written by a newer put, or cleared
+                entry = std::move(p->second);
+                impl->pending.erase(p);
+            }
+            impl->write(hash, entry);
+        };
+
+    jobs::dispatch(write, jobs::context{ "disk cache write", _impl->pool, {}, _impl->writes });
+}
+
+void
+DiskCache::remove(const std::string& key)
+{
+    auto hash = hashKey(key);
+    {
+        std::scoped_lock lock(_impl->mutex);
+        _impl->pending.erase(hash);
+        _impl->forget(hash);
+    }
+    std::error_code ec;
+    std::filesystem::remove(_impl->pathFor(hash), ec);
+}
+
+void
+DiskCache::clear()
+{
+    flush();
+
+    std::scoped_lock lock(_impl->mutex);
+    std::error_code ec;
+    for (auto& entry : _impl->index)
+        std::filesystem::remove(_impl->pathFor(entry.first), ec);
+    _impl->index.clear();
+    _impl->pending.clear();
+    _impl->totalBytes = 0;
+    _hits = 0, _misses = 0;
+}
+
+std::size_t
+DiskCache::capacity() const
+{
+    return _impl->capacity;
+}
+
+std::size_t
+DiskCache::size() const
+{
+    std::scoped_lock lock(_impl->mutex);
+    return _impl->totalBytes;
+}
+
+void
+DiskCache::flush()
+{
+    if (_impl->pool)
+        _impl->writes->join();
+}
@@ -0,0 +1,83 @@
+/**
+ * rocky c++
+ * Copyright 2025 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+
+#include <rocky/Common.h>
+#include <rocky/IOTypes.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace ROCKY_NAMESPACE
+{
+    /**
+    * Persistent, file-based cache of Content objects keyed by URI.
+    *
+    * This is the second tier behind the in-memory ContentCache: URI::read checks
+    * it before going to the network, so data fetched in a previous session does
+    * not need to be downloaded again.
+    *
+    * Each entry lives in its own file, named by a hash of its key. Entries carry
+    * an expiration time (usually derived from the HTTP caching headers) and the
+    * total size of the cache is held under a byte budget by evicting the least
+    * recently used files. Writes happen asynchronously in a background job so
+    * put() never blocks on the disk.
+    */
+    class ROCKY_EXPORT DiskCache : public Cache<std::string, Content>
+    {
+    public:
+        //! Create a disk cache rooted at the given folder.
+        //! @param path Folder in which to store cached files (created if necessary)
+        //! @param capacityBytes Maximum number of bytes to store on disk
+        DiskCache(const std::string& path, std::size_t capacityBytes = 1024u * 1024u * 1024u);
+
+        //! Waits for pending writes to complete before destructing.
+        ~DiskCache();
+
+        //! Whether the cache initialized properly and is usable
+        Status status;
+
+        //! Lifetime of entries stored without an explicit TTL
+        std::chrono::seconds defaultTTL = std::chrono::hours(24 * 7);
+
+        //! Fetch an unexpired entry from the cache.
+        std::optional<Content> get(const std::string& key) override;
+
+        //! Store an entry with the default TTL.
+        void put(const std::string& key, const Content& value) override;
+
+        //! Store an entry that expires after the specified TTL.
+        //! A TTL of zero means "do not cache".
+        void put(const std::string& key, const Content& value, std::chrono::seconds ttl);
+
+        //! Remove an entry from the cache.
+        void remove(const std::string& key);
+
+        //! Remove all entries from the cache.
+        void clear() override;
+
+        //! Maximum number of bytes the cache will store.
+        std::size_t capacity() const override;
+
+        //! Number of bytes currently stored.
+        std::size_t size() const override;
+
+        std::uint32_t hits() const override { return _hits; }
+
+        std::uint32_t misses() const override { return _misses; }
+
+        //! Block until all pending writes are on disk.
+        void flush();
+
+    private:
+        struct Impl;
+        std::shared_ptr<Impl> _impl;
+        std::atomic_uint32_t _hits = { 0u };
+        std::atomic_uint32_t _misses = { 0u };
+    };
+}
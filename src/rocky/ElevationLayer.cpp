@@ -151,44 +151,59 @@ ElevationLayer::assembleTile(const TileKey& key, const IOOptions& io) const
         auto keyExtent = key.extent();
         unsigned numSourcesAtFullResolution = 0;
 
-        for (auto& localKey : localKeys)
-        {
-            // resolve an image for each local key.
-            TileKey actualKey = localKey;
+        // resolve an image for each local key. The sources are often remote, so
+        // fetch them concurrently to overlap the round trips.
+        std::vector<std::optional<GeoImage>> localTiles(localKeys.size());
+        std::vector<char> fullResolution(localKeys.size(), 0);
 
-            auto create = [&]() -> Result<GeoImage>
-                {
-                    // not found in the resident cache; go to the source, and fall back until we get
-                    // a usable image tile.
-                    while (actualKey.valid())
+        auto fetch = [&](unsigned i, const IOOptions& io)
+            {
+                TileKey actualKey = localKeys[i];
+
+                auto create = [&]() -> Result<GeoImage>
                     {
-                        auto r = createTileImplementation_internal(actualKey, io);
-
-                        if (io.canceled())
-                            return Failure_OperationCanceled;
-                        else if (r.ok() && r.value().image())
-                            return r;
-                        else
-                            actualKey.makeParent();
-                    }
+                        // not found in the resident cache; go to the source, and fall back until we get
+                        // a usable image tile.
+                        while (actualKey.valid())
+                        {
+                            auto r = createTileImplementation_internal(actualKey, io);
+
+                            if (io.canceled())
+                                return Failure_OperationCanceled;
+                            else if (r.ok() && r.value().image())
+                                return r;
+                            else
+                                actualKey.makeParent();
+                        }
 
-                    return Failure_ResourceUnavailable;
-                };
+                        return Failure_ResourceUnavailable;
+                    };
 
-            auto localTile = getOrCreateTile(localKey, io, create);
+                auto localTile = getOrCreateTile(localKeys[i], io, create);
 
-            if (localTile.ok())
+                if (localTile.ok())
+                {
+                    localTiles[i] = std::move(localTile.value());
+                    fullResolution[i] = (actualKey.level == localKeys[i].level);
+                }
+            };
+
+        detail::concurrentIO((unsigned)localKeys.size(), fetch, io);
+
+        if (io.canceled())
+            return {};
+
+        for (unsigned i = 0; i < localKeys.size(); ++i)
+        {
+            if (localTiles[i].has_value())
             {
-                sources.emplace_back(std::move(localTile.value()));
+                sources.emplace_back(std::move(localTiles[i].value()));
 
-                if (actualKey.level == localKey.level)
+                if (fullResolution[i])
                 {
                     ++numSourcesAtFullResolution;
                 }
             }
-
-            if (io.canceled())
-                return {};
         }
 
         // If we actually got at least one piece of usable data,
@@ -251,7 +266,8 @@ ElevationLayer::assembleTile(const TileKey& key, const IOOptions& io) const
             // Note, point.z will hold a vdatum offset if applicable.
             if (xform.valid())
             {
-                xform.transformArray(&points[0], points.size());
+                double maxError = maxReprojectionError.value() * sources[0].extent().width() / (double)sources[0].image()->width();
+                xform.transformGrid(&points[0], cols, rows, maxError);
             }
 
             // indirect indexing is a trick that minimized the number of sources we
@@ -19,6 +19,12 @@
 
 using namespace ROCKY_NAMESPACE;
 
+namespace
+{
+    // maximum reprojection error (in source pixels) when compositing
+    constexpr double COMPOSITE_MAX_ERROR = 0.125;
+}
+
 GeoImage::GeoImage() :
     _image(nullptr),
     _extent(GeoExtent::INVALID)
@@ -115,47 +121,116 @@ GeoImage::composite(const std::vector<GeoImage>& sources, const std::vector<floa
 {
     double x, y;
     bool have_opacities = opacities.size() == sources.size();
+    unsigned width = _image->width(), height = _image->height();
+
+    // Transform our sample grid into each source's SRS up front. An approximate
+    // transform is plenty since we're resampling anyway.
+    std::vector<std::vector<glm::dvec3>> grids(sources.size());
+    std::vector<char> usable(sources.size(), 1);
+    for (unsigned i = 0; i < sources.size(); ++i)
+    {
+        auto xform = srs().to(sources[i].srs());
+        if (xform.noop())
+            continue;
+
+        if (!xform.valid())
+        {
+            usable[i] = 0;
+            continue;
+        }
 
-    std::vector<SRSOperation> xforms;
-    xforms.reserve(sources.size());
-    for (auto& source : sources)
-        xforms.emplace_back(srs().to(source.srs()));
+        auto& grid = grids[i];
+        grid.resize(width * height);
+        for (unsigned t = 0; t < height; ++t)
+        {
+            for (unsigned s = 0; s < width; ++s)
+            {
+                getCoord(s, t, x, y);
+                grid[t * width + s] = { x, y, 0.0 };
+            }
+        }
 
-    std::vector<glm::fvec4> pixels;
-    pixels.reserve(sources.size());
+        double maxError = COMPOSITE_MAX_ERROR * sources[i].extent().width() / (double)sources[i].image()->width();
+        xform.transformGrid(grid.data(), width, height, maxError);
+    }
 
-    for (unsigned s = 0; s < _image->width(); ++s)
+    // Work a row at a time. For each pixel, read sources from the top down until
+    // one is opaque, then blend what we found from the bottom up.
+    auto n = (unsigned)sources.size();
+    std::vector<glm::dvec3> coords(width);
+    std::vector<Image::Pixel> samples(n * width), row(width);
+    std::vector<char> ok(n * width), opaque(width);
+    std::vector<glm::dvec3> remaining(width);
+    std::vector<unsigned> index(width);
+    std::vector<Image::Pixel> found(width);
+    std::vector<char> found_ok(width);
+
+    for (unsigned layer = 0; layer < _image->depth(); ++layer)
     {
-        for (unsigned t = 0; t < _image->height(); ++t)
+        for (unsigned t = 0; t < height; ++t)
         {
-            getCoord(s, t, x, y);
+            for (unsigned s = 0; s < width; ++s)
+            {
+                getCoord(s, t, x, y);
+                coords[s] = { x, y, 0.0 };
+            }
 
-            for (unsigned layer = 0; layer < _image->depth(); ++layer)
+            std::fill(ok.begin(), ok.end(), 0);
+            std::fill(opaque.begin(), opaque.end(), 0);
+
+            for (int i = (int)n - 1; i >= 0; --i)
             {
-                pixels.clear();
+                if (!usable[i])
+                    continue;
 
-                for (int i = (int)sources.size() - 1; i >= 0; --i)
+                // sample the pixels that aren't covered yet
+                unsigned count = 0;
+                for (unsigned s = 0; s < width; ++s)
                 {
-                    auto r = sources[i].read(xforms[i], x, y, layer);
-                    if (r.ok())
+                    if (!opaque[s])
                     {
-                        r.value().a *= opacities[i];
-                        float a = r.value().a;
-                        pixels.emplace_back(std::move(r.value()));
-                        if (a >= 1.0f)
-                            break;
+                        remaining[count] = grids[i].empty() ? coords[s] : grids[i][t * width + s];
+                        index[count++] = s;
                     }
                 }
-                
-                glm::fvec4 pixel(0, 0, 0, 0);
-                auto n = (int)pixels.size();
-                for (int i = n - 1; i >= 0; --i)
+
+                if (count == 0)
+                    break;
+
+                sources[i].read(remaining.data(), count, found.data(), found_ok.data(), layer);
+
+                for (unsigned k = 0; k < count; ++k)
                 {
-                    pixel = i == (n - 1) ? pixels[i] : glm::mix(pixel, pixels[i], pixels[i].a);
+                    if (found_ok[k])
+                    {
+                        auto s = index[k];
+                        auto& pixel = samples[i * width + s];
+                        pixel = found[k];
+                        pixel.a *= have_opacities ? opacities[i] : 1.0f;
+                        ok[i * width + s] = 1;
+                        if (pixel.a >= 1.0f)
+                            opaque[s] = 1;
+                    }
                 }
+            }
 
-                _image->write(pixel, s, t, layer);
+            for (unsigned s = 0; s < width; ++s)
+            {
+                glm::fvec4 pixel(0, 0, 0, 0);
+                bool first = true;
+                for (unsigned i = 0; i < n; ++i)
+                {
+                    if (ok[i * width + s])
+                    {
+                        auto& p = samples[i * width + s];
+                        pixel = first ? p : glm::mix(pixel, p, p.a);
+                        first = false;
+                    }
+                }
+                row[s] = pixel;
             }
+
+            _image->writeRow(row.data(), width, 0, t, layer);
         }
     }
 }
@@ -207,6 +282,48 @@ GeoImage::read(double x, double y, int layer) const
     return _image->read_bilinear((float)u, (float)v, layer);
 }
 
+unsigned
+GeoImage::read(const glm::dvec3* points, unsigned count, Image::Pixel* out, char* ok, int layer) const
+{
+    if (!valid() || layer >= (int)_image->depth())
+    {
+        std::fill(ok, ok + count, 0);
+        return 0;
+    }
+
+    // gather the in-bounds points and sample them all at once:
+    std::vector<glm::fvec2> uv;
+    std::vector<unsigned> index;
+    uv.reserve(count);
+    index.reserve(count);
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        double u = (points[i].x - _extent.xmin()) / _extent.width();
+        double v = (points[i].y - _extent.ymin()) / _extent.height();
+        ok[i] = (u >= 0.0 && u <= 1.0 && v >= 0.0 && v <= 1.0) ? 1 : 0;
+        if (ok[i])
+        {
+            uv.emplace_back((float)u, (float)v);
+            index.emplace_back(i);
+        }
+    }
+
+    if (index.size() == count)
+    {
+        _image->read_bilinear(uv.data(), count, out, layer);
+    }
+    else if (!index.empty())
+    {
+        std::vector<Image::Pixel> samples(index.size());
+        _image->read_bilinear(uv.data(), (unsigned)index.size(), samples.data(), layer);
+        for (unsigned k = 0; k < index.size(); ++k)
+            out[index[k]] = samples[k];
+    }
+
+    return (unsigned)index.size();
+}
+
 GeoImage::ReadResult
 GeoImage::read_clamped(double x, double y, int layer) const
 {
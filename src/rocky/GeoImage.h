@@ -76,6 +76,15 @@ namespace ROCKY_NAMESPACE
         //! assumed to be in this GeoImage's SRS.
         ReadResult read(double x, double y, int layer=0) const;
 
+        //! Read the values of many pixels at coordinates in this GeoImage's SRS.
+        //! Same results as calling read(x, y, layer) for each one, but much faster.
+        //! @param points Coordinates to sample (z is ignored)
+        //! @param count Number of points
+        //! @param out Output pixels, one per point; only set where "ok" is set
+        //! @param ok Output flags, one per point; nonzero where the read succeeded
+        //! @return Number of successful reads
+        unsigned read(const glm::dvec3* points, unsigned count, Image::Pixel* out, char* ok, int layer = 0) const;
+
         //! Clamp the input coordinate to the image's valid extent and then
         //! read the value of a pixel at the coordinate (x, y) which is
         //! assumed to be in the GeoImage's SRS.
@@ -5,10 +5,98 @@
  */
 #include "IOTypes.h"
 #include "Context.h"
+#include "Utils.h"
 #include "json.h"
 
 using namespace ROCKY_NAMESPACE;
 
+jobs::jobpool*
+detail::ioPool()
+{
+    static jobs::jobpool* pool = nullptr;
+    static std::once_flag init;
+    std::call_once(init, []()
+        {
+            unsigned concurrency = 16u;
+            auto value = util::getEnvVar("ROCKY_IO_CONCURRENCY");
+            if (value.has_value())
+                concurrency = std::max(1, std::atoi(value->c_str()));
+
+            pool = jobs::get_pool("rocky::io", concurrency);
+
+            // keep these threads free for I/O
+            pool->set_can_steal_work(false);
+        });
+    return pool;
+}
+
+void
+detail::concurrentIO(unsigned count, const std::function<void(unsigned, const IOOptions&)>& func, const IOOptions& io, unsigned maxConcurrency)
+{
+    if (count == 0)
+        return;
+
+    auto width = std::min(count, std::max(maxConcurrency, 1u));
+
+    if (width == 1)
+    {
+        for (unsigned i = 0; i < count && !io.canceled(); ++i)
+            func(i, io);
+        return;
+    }
+
+    // Participants claim the next index until none are left, so no more than
+    // "width" calls are ever in flight. The calling thread takes index 0 and
+    // then keeps claiming, so it never sits idle waiting on the pool; that makes
+    // nested calls from I/O threads safe, and they still fan out whenever other
+    // I/O threads are free. Helpers that start after every index is claimed
+    // exit without touching func or io, so those can live on our stack.
+    struct State
+    {
+        std::atomic_uint next = { 1u };
+        unsigned count = 0u;
+        const std::function<void(unsigned, const IOOptions&)>* func = nullptr;
+        const IOOptions* io = nullptr;
+        std::mutex mutex;
+        std::condition_variable finished;
+        unsigned done = 0u;
+
+        void run(unsigned i)
+        {
+            if (!io->canceled())
+                (*func)(i, *io);
+            {
+                std::scoped_lock lock(mutex);
+                ++done;
+            }
+            finished.notify_all();
+        }
+
+        void work()
+        {
+            for (unsigned i = next++; i < count; i = next++)
+                run(i);
+        }
+    };
+
+    auto state = std::make_shared<State>();
+    state->count = count;
+    state->func = &func;
+    state->io = &io;
+
+    for (unsigned j = 1; j < width; ++j)
+    {
+        jobs::dispatch([state]() { state->work(); }, jobs::context{ "concurrent io", ioPool() });
+    }
+
+    state->run(0);
+    state->work();
+
+    // wait for the calls other threads claimed
+    std::unique_lock lock(state->mutex);
+    state->finished.wait(lock, [&]() { return state->done == count; });
+}
+
 IOOptions::IOOptions()
 {
     _services = std::make_shared<Services>();
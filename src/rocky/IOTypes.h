@@ -8,10 +8,13 @@
 #include <rocky/Result.h>
 #include <rocky/Threading.h>
 #include <rocky/Cache.h>
+#include <rocky/TileKey.h>
 #include <optional>
 #include <string>
 #include <cstdint>
 #include <chrono>
+#include <mutex>
+#include <vector>
 
 /**
  * A collection of types used by the various I/O systems.
@@ -23,6 +26,8 @@ namespace ROCKY_NAMESPACE
     class Layer;
     class ContextImpl;
     class GeoExtent;
+    class DiskCache;
+    struct URIResponse;
 
     //! Service for reading an image from a URI
     using ReadImageURIService = std::function<
@@ -49,6 +54,43 @@ namespace ROCKY_NAMESPACE
     //! A cache that stores Content objects by URI.
     using ContentCache = rocky::util::LRUCache<std::string, Result<Content>>;
 
+    /**
+    * Compact key identifying one tile of one layer at one revision.
+    * Used by tile-keyed caches so the lookup path never allocates.
+    */
+    struct TileCacheKey
+    {
+        TileID tile;
+        std::int32_t layerUID = -1;
+        std::int32_t revision = 0;
+
+        inline bool operator == (const TileCacheKey& rhs) const {
+            return tile == rhs.tile && layerUID == rhs.layerUID && revision == rhs.revision;
+        }
+        inline bool operator != (const TileCacheKey& rhs) const {
+            return !operator==(rhs);
+        }
+    };
+
+    //! A weak cache of resident images, keyed by tile.
+    using ResidentImageCache = util::ResidentCache<TileCacheKey, Image, GeoExtent>;
+
+    /**
+    * Holds strong references to the tile images created during a batch of
+    * related operations, so they stay in the (weak) ResidentImageCache and
+    * later members of the batch can share them.
+    */
+    struct ImageRetainer
+    {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<Image>> images;
+
+        inline void retain(const std::shared_ptr<Image>& image) {
+            std::scoped_lock lock(mutex);
+            images.emplace_back(image);
+        }
+    };
+
     /**
     * Collection of service available to rocky classes that perform IO operations.
     */
@@ -70,14 +112,17 @@ namespace ROCKY_NAMESPACE
         //! Encodes an Image::Ptr to a std::ostream
         WriteImageStreamService writeImageToStream;
 
-        //! Serializes reads from identical URIs
-        detail::Gate<std::string> uriGate;
+        //! Coalesces concurrent reads of identical URIs into one
+        detail::SingleFlight<std::string, Result<URIResponse>> uriReads;
 
         //! Caches raw context coming from a URI (like a browser cache)
         std::shared_ptr<ContentCache> contentCache;
 
+        //! Persistent second-tier cache behind contentCache (optional)
+        std::shared_ptr<DiskCache> diskCache;
+
         //! Provides fast access to Image data that is resident somwehere in memory
-        std::shared_ptr<util::ResidentCache<std::string, Image, GeoExtent>> residentImageCache;
+        std::shared_ptr<ResidentImageCache> residentImageCache;
 
         //! URI deadpool; URI will use this if available.
         std::shared_ptr<DealpoolService> deadpool;
@@ -113,6 +158,9 @@ namespace ROCKY_NAMESPACE
         //! Referring location for an operation using these options
         std::optional<std::string> referrer;
 
+        //! Optional retainer that keeps tile images alive for the scope of a batch
+        std::shared_ptr<ImageRetainer> retainer;
+
         //! Access to shared services
         inline Services& services() const;
 
@@ -125,6 +173,23 @@ namespace ROCKY_NAMESPACE
     };
 
 
+    namespace detail
+    {
+        //! Shared job pool for latency-bound I/O like network fetches. It runs more
+        //! threads than the CPU-bound pools since they spend most of their time waiting.
+        //! Set the thread count with the ROCKY_IO_CONCURRENCY environment variable.
+        extern ROCKY_EXPORT jobs::jobpool* ioPool();
+
+        //! Calls func(i, io) for each i in [0, count), concurrently in the calling thread
+        //! and the I/O pool so their I/O waits overlap. The calling thread always runs
+        //! index 0 itself, so put work that fans out further there. At most
+        //! maxConcurrency calls run at once. Blocks until all calls complete. Calls
+        //! that haven't started when "io" is canceled are skipped. Safe to nest.
+        extern ROCKY_EXPORT void concurrentIO(unsigned count,
+            const std::function<void(unsigned, const IOOptions&)>& func, const IOOptions& io,
+            unsigned maxConcurrency = ~0u);
+    }
+
     // inlines
     IOOptions& IOOptions::operator = (IOOptions&& rhs) noexcept
     {
@@ -133,6 +198,7 @@ namespace ROCKY_NAMESPACE
             Cancelable::operator=(rhs);
             maxNetworkAttempts = rhs.maxNetworkAttempts;
             referrer = std::move(rhs.referrer);
+            retainer = std::move(rhs.retainer);
             _services = rhs._services;
             _cancelable = rhs._cancelable;
             rhs._cancelable = nullptr;
@@ -160,3 +226,18 @@ namespace ROCKY_NAMESPACE
         return *_services;
     }
 }
+
+namespace std {
+    // std::hash specialization for TileCacheKey
+    template<> struct hash<rocky::TileCacheKey> {
+        inline size_t operator()(const rocky::TileCacheKey& k) const {
+            // 64-bit mix of all fields (splitmix64 finalizer)
+            std::uint64_t h = k.tile.value;
+            h ^= ((std::uint64_t)(std::uint32_t)k.layerUID << 32) ^ (std::uint64_t)(std::uint32_t)k.revision;
+            h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ull;
+            h ^= h >> 27; h *= 0x94d049bb133111ebull;
+            h ^= h >> 31;
+            return (size_t)h;
+        }
+    };
+}
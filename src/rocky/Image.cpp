@@ -4,6 +4,8 @@
  * MIT License
  */
 #include "Image.h"
+#include <array>
+#include <cfloat>
 #include <cstring>
 
 using namespace ROCKY_NAMESPACE;
@@ -90,8 +92,558 @@ namespace
     };
 }
 
+namespace
+{
+    // Format-specialized pixel codecs for the batch kernels below. Unlike the _layouts
+    // table these inline completely, so there's no indirect call or per-component
+    // branching per pixel. Results match the corresponding _layouts entries exactly.
+
+    struct RGBA8_UNORM_codec
+    {
+        static constexpr unsigned bytes = 4;
+        inline Image::Pixel decode(const uchar* p) const {
+            return Image::Pixel((float)p[0], (float)p[1], (float)p[2], (float)p[3]) * denorm_u8;
+        }
+        inline void encode(const Image::Pixel& v, uchar* p) const {
+            p[0] = (uchar)(v.r * norm_u8), p[1] = (uchar)(v.g * norm_u8), p[2] = (uchar)(v.b * norm_u8), p[3] = (uchar)(v.a * norm_u8);
+        }
+    };
+
+    struct RGBA8_SRGB_codec
+    {
+        static constexpr unsigned bytes = 4;
+        const float* to_linear; // 256 entries
+        inline Image::Pixel decode(const uchar* p) const {
+            return Image::Pixel(to_linear[p[0]], to_linear[p[1]], to_linear[p[2]], (float)p[3] * denorm_u8);
+        }
+        inline void encode(const Image::Pixel& v, uchar* p) const {
+            p[0] = (uchar)(detail::linear_to_sRGB(v.r) * norm_u8);
+            p[1] = (uchar)(detail::linear_to_sRGB(v.g) * norm_u8);
+            p[2] = (uchar)(detail::linear_to_sRGB(v.b) * norm_u8);
+            p[3] = (uchar)(v.a * norm_u8);
+        }
+    };
+
+    struct R16_UNORM_codec
+    {
+        static constexpr unsigned bytes = 2;
+        inline Image::Pixel decode(const uchar* p) const {
+            return Image::Pixel((float)*reinterpret_cast<const ushort*>(p) * denorm_u16, 1.0f, 1.0f, 1.0f);
+        }
+        inline void encode(const Image::Pixel& v, uchar* p) const {
+            *reinterpret_cast<ushort*>(p) = (ushort)(v.r * norm_u16);
+        }
+    };
+
+    struct R32_SFLOAT_codec
+    {
+        static constexpr unsigned bytes = 4;
+        inline Image::Pixel decode(const uchar* p) const {
+            return Image::Pixel(*reinterpret_cast<const float*>(p), 1.0f, 1.0f, 1.0f);
+        }
+        inline void encode(const Image::Pixel& v, uchar* p) const {
+            *reinterpret_cast<float*>(p) = v.r;
+        }
+    };
+
+    // Fallback for everything else
+    struct generic_codec
+    {
+        Image::Pixel(*read)(unsigned char*, int);
+        void(*write)(const Image::Pixel&, unsigned char*, int);
+        int num_components;
+        unsigned bytes;
+        inline Image::Pixel decode(const uchar* p) const {
+            return read(const_cast<uchar*>(p), num_components);
+        }
+        inline void encode(const Image::Pixel& v, uchar* p) const {
+            write(v, p, num_components);
+        }
+    };
+
+    const float* sRGB_to_linear_table()
+    {
+        static const auto table = []()
+            {
+                std::array<float, 256> t;
+                for (unsigned i = 0; i < 256; ++i)
+                    t[i] = detail::sRGB_to_linear((float)i * denorm_u8);
+                return t;
+            }();
+        return table.data();
+    }
+
+    template<class CODEC>
+    void read_bilinear_kernel(const CODEC& codec, const uchar* layer, unsigned width, unsigned height,
+        float noData, const glm::fvec2* uv, unsigned count, Image::Pixel* out)
+    {
+        // same math as Image::read_bilinear
+        const float sizeS = (float)(width - 1);
+        const float sizeT = (float)(height - 1);
+
+        for (unsigned i = 0; i < count; ++i)
+        {
+            float u = std::clamp(uv[i].x, 0.0f, 1.0f);
+            float v = std::clamp(uv[i].y, 0.0f, 1.0f);
+
+            float s = u * sizeS;
+            float s0 = std::max(std::floor(s), 0.0f);
+            float s1 = std::min(s0 + 1.0f, sizeS);
+            float smix = s0 < s1 ? (s - s0) / (s1 - s0) : 0.0f;
+
+            float t = v * sizeT;
+            float t0 = std::max(std::floor(t), 0.0f);
+            float t1 = std::min(t0 + 1.0f, sizeT);
+            float tmix = t0 < t1 ? (t - t0) / (t1 - t0) : 0.0f;
+
+            auto row0 = layer + (std::size_t)t0 * width * codec.bytes;
+            auto row1 = layer + (std::size_t)t1 * width * codec.bytes;
+            auto UL = codec.decode(row0 + (unsigned)s0 * codec.bytes);
+            auto UR = codec.decode(row0 + (unsigned)s1 * codec.bytes);
+            auto LL = codec.decode(row1 + (unsigned)s0 * codec.bytes);
+            auto LR = codec.decode(row1 + (unsigned)s1 * codec.bytes);
+
+            Image::Pixel TOP = UL.r == noData ? UR : UR.r == noData ? UL : UL * (1.0f - smix) + UR * smix;
+            Image::Pixel BOT = LL.r == noData ? LR : LR.r == noData ? LL : LL * (1.0f - smix) + LR * smix;
+
+            out[i] =
+                TOP.r == noData && BOT.r == noData ? Image::Pixel(noData) :
+                TOP.r == noData ? BOT :
+                BOT.r == noData ? TOP :
+                TOP * (1.0f - tmix) + BOT * tmix;
+        }
+    }
+
+    template<class CODEC>
+    void read_row_kernel(const CODEC& codec, const uchar* src, unsigned count, Image::Pixel* out)
+    {
+        for (unsigned i = 0; i < count; ++i, src += codec.bytes)
+            out[i] = codec.decode(src);
+    }
+
+    template<class CODEC>
+    void write_row_kernel(const CODEC& codec, const Image::Pixel* in, unsigned count, uchar* dst)
+    {
+        for (unsigned i = 0; i < count; ++i, dst += codec.bytes)
+            codec.encode(in[i], dst);
+    }
+
+    template<class CODEC>
+    void convolve_kernel(const CODEC& codec, const uchar* src, uchar* dst,
+        unsigned width, unsigned height, unsigned depth, const float* kernel)
+    {
+        // Decode each source row once into a 3-row window. Edge pixels repeat,
+        // same as Image::convolve always did.
+        std::vector<Image::Pixel> window[3];
+        int cached[3] = { -1, -1, -1 };
+        for (auto& w : window)
+            w.resize(width);
+
+        std::vector<Image::Pixel> result(width);
+        const std::size_t rowBytes = (std::size_t)width * codec.bytes;
+
+        for (unsigned r = 0; r < depth; ++r)
+        {
+            auto layer = src + (std::size_t)r * height * rowBytes;
+            cached[0] = cached[1] = cached[2] = -1;
+
+            auto row = [&](unsigned t) -> const Image::Pixel*
+                {
+                    auto& slot = window[t % 3];
+                    if (cached[t % 3] != (int)t)
+                    {
+                        read_row_kernel(codec, layer + t * rowBytes, width, slot.data());
+                        cached[t % 3] = (int)t;
+                    }
+                    return slot.data();
+                };
+
+            for (unsigned t = 0; t < height; ++t)
+            {
+                auto above = row(t > 0 ? t - 1 : t);
+                auto center = row(t);
+                auto below = row(t < height - 1 ? t + 1 : t);
+
+                for (unsigned s = 0; s < width; ++s)
+                {
+                    unsigned sm = s > 0 ? s - 1 : s;
+                    unsigned sp = s < width - 1 ? s + 1 : s;
+
+                    glm::fvec4 pixel(0, 0, 0, 0);
+                    pixel += above[sm] * kernel[0];
+                    pixel += above[s] * kernel[1];
+                    pixel += above[sp] * kernel[2];
+                    pixel += center[sm] * kernel[3];
+                    pixel += center[s] * kernel[4];
+                    pixel += center[sp] * kernel[5];
+                    pixel += below[sm] * kernel[6];
+                    pixel += below[s] * kernel[7];
+                    pixel += below[sp] * kernel[8];
+                    result[s] = glm::clamp(pixel, 0.0f, 1.0f);
+                }
+
+                write_row_kernel(codec, result.data(), width,
+                    dst + ((std::size_t)r * height + t) * rowBytes);
+            }
+        }
+    }
+
+    // Calls func(codec) with the fastest codec for the pixel format.
+    template<typename FUNC>
+    inline void with_codec(Image::PixelFormat format, const generic_codec& fallback, FUNC&& func)
+    {
+        switch (format)
+        {
+        case Image::R8G8B8A8_UNORM:
+            func(RGBA8_UNORM_codec{});
+            break;
+        case Image::R8G8B8A8_SRGB:
+            func(RGBA8_SRGB_codec{ sRGB_to_linear_table() });
+            break;
+        case Image::R16_UNORM:
+            func(R16_UNORM_codec{});
+            break;
+        case Image::R32_SFLOAT:
+            func(R32_SFLOAT_codec{});
+            break;
+        default:
+            func(fallback);
+            break;
+        }
+    }
+}
+
+namespace
+{
+    // Block compression (BC1 and BC3, a.k.a. DXT1 and DXT5). Each 4x4 block of
+    // pixels stores two RGB565 endpoints and a 2-bit palette index per pixel; BC3
+    // adds two alpha endpoints and a 3-bit alpha index per pixel. The encoder fits
+    // the endpoints along the principal axis of the block's colors and then
+    // refines them with a least-squares pass, keeping whichever fits better.
+
+    struct BlockColors
+    {
+        glm::fvec3 color[16];
+        uchar alpha[16];
+        bool opaque[16]; // BC1 only: false pixels use the transparent index
+    };
+
+    inline ushort to_565(const glm::fvec3& c)
+    {
+        auto r = (unsigned)std::clamp(c.r * (31.0f / 255.0f) + 0.5f, 0.0f, 31.0f);
+        auto g = (unsigned)std::clamp(c.g * (63.0f / 255.0f) + 0.5f, 0.0f, 63.0f);
+        auto b = (unsigned)std::clamp(c.b * (31.0f / 255.0f) + 0.5f, 0.0f, 31.0f);
+        return (ushort)((r << 11) | (g << 5) | b);
+    }
+
+    inline glm::fvec3 from_565(ushort v)
+    {
+        unsigned r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+        return glm::fvec3((float)((r << 3) | (r >> 2)), (float)((g << 2) | (g >> 4)), (float)((b << 3) | (b >> 2)));
+    }
+
+    // Fills the 4-entry palette for a pair of 565 endpoints.
+    // four_color: c0 > c1 ordering (or any BC3 color block); otherwise entry 3 is transparent.
+    inline void make_palette(ushort c0, ushort c1, bool four_color, glm::fvec3* palette)
+    {
+        palette[0] = from_565(c0);
+        palette[1] = from_565(c1);
+        if (four_color)
+        {
+            palette[2] = glm::floor((2.0f * palette[0] + palette[1]) / 3.0f + 0.5f);
+            palette[3] = glm::floor((palette[0] + 2.0f * palette[1]) / 3.0f + 0.5f);
+        }
+        else
+        {
+            palette[2] = glm::floor((palette[0] + palette[1]) * 0.5f + 0.5f);
+            palette[3] = glm::fvec3(0.0f);
+        }
+    }
+
+    inline float distance2(const glm::fvec3& a, const glm::fvec3& b)
+    {
+        auto d = a - b;
+        return glm::dot(d, d);
+    }
+
+    // Chooses the best palette index for each pixel and returns the total squared error.
+    float assign_indices(const BlockColors& block, const glm::fvec3* palette, bool four_color, unsigned char* indices)
+    {
+        float total = 0.0f;
+        unsigned usable = four_color ? 4 : 3;
+        for (unsigned i = 0; i < 16; ++i)
+        {
+            if (!block.opaque[i])
+            {
+                indices[i] = 3;
+                continue;
+            }
+
+            unsigned best = 0;
+            float bestError = distance2(block.color[i], palette[0]);
+            for (unsigned p = 1; p < usable; ++p)
+            {
+                float e = distance2(block.color[i], palette[p]);
+                if (e < bestError)
+                    best = p, bestError = e;
+            }
+            indices[i] = (unsigned char)best;
+            total += bestError;
+        }
+        return total;
+    }
+
+    // Least-squares endpoints for a fixed index assignment.
+    // Returns false if the system is degenerate (e.g. all pixels share one index).
+    bool refine_endpoints(const BlockColors& block, const unsigned char* indices, bool four_color,
+        glm::fvec3& e0, glm::fvec3& e1)
+    {
+        // weight of endpoint 0 for each palette index:
+        const float w4[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+        const float w3[4] = { 1.0f, 0.0f, 0.5f, 0.0f };
+        auto* weights = four_color ? w4 : w3;
+
+        float aa = 0.0f, bb = 0.0f, ab = 0.0f;
+        glm::fvec3 ax(0.0f), bx(0.0f);
+
+        for (unsigned i = 0; i < 16; ++i)
+        {
+            if (!block.opaque[i])
+                continue;
+
+            float a = weights[indices[i]], b = 1.0f - a;
+            aa += a * a, bb += b * b, ab += a * b;
+            ax += a * block.color[i];
+            bx += b * block.color[i];
+        }
+
+        float det = aa * bb - ab * ab;
+        if (std::abs(det) < 1e-6f)
+            return false;
+
+        e0 = glm::clamp((ax * bb - bx * ab) / det, 0.0f, 255.0f);
+        e1 = glm::clamp((bx * aa - ax * ab) / det, 0.0f, 255.0f);
+        return true;
+    }
+
+    // Writes one 8-byte color block.
+    void encode_color_block(const BlockColors& block, bool allow_transparent, uchar* out)
+    {
+        bool has_transparent = false;
+        unsigned count = 0;
+        glm::fvec3 mean(0.0f);
+
+        for (unsigned i = 0; i < 16; ++i)
+        {
+            if (block.opaque[i])
+            {
+                mean += block.color[i];
+                ++count;
+            }
+            else has_transparent = true;
+        }
+
+        has_transparent = has_transparent && allow_transparent;
+        bool four_color = !has_transparent;
+
+        ushort c0 = 0, c1 = 0;
+        unsigned char indices[16];
+
+        if (count == 0)
+        {
+            // fully transparent: 3-color mode with every index transparent
+            std::fill(std::begin(indices), std::end(indices), (unsigned char)3);
+        }
+        else
+        {
+            mean /= (float)count;
+
+            // principal axis by power iteration on the covariance matrix.
+            float cov[6] = { 0, 0, 0, 0, 0, 0 };
+            for (unsigned i = 0; i < 16; ++i)
+            {
+                if (!block.opaque[i])
+                    continue;
+                auto d = block.color[i] - mean;
+                cov[0] += d.r * d.r, cov[1] += d.r * d.g, cov[2] += d.r * d.b;
+                cov[3] += d.g * d.g, cov[4] += d.g * d.b, cov[5] += d.b * d.b;
+            }
+
+            // start from the covariance column with the most energy; a plain
+            // (hi - lo) guess can be orthogonal to the true axis.
+            glm::fvec3 axis(0.0f);
+            for (auto& column : {
+                glm::fvec3(cov[0], cov[1], cov[2]),
+                glm::fvec3(cov[1], cov[3], cov[4]),
+                glm::fvec3(cov[2], cov[4], cov[5]) })
+            {
+                if (glm::dot(column, column) > glm::dot(axis, axis))
+                    axis = column;
+            }
+
+            for (int iter = 0; iter < 8; ++iter)
+            {
+                glm::fvec3 next(
+                    axis.r * cov[0] + axis.g * cov[1] + axis.b * cov[2],
+                    axis.r * cov[1] + axis.g * cov[3] + axis.b * cov[4],
+                    axis.r * cov[2] + axis.g * cov[4] + axis.b * cov[5]);
+                float len = glm::length(next);
+                if (len < 1e-6f)
+                    break;
+                axis = next / len;
+            }
+
+            // endpoints are the extreme projections along the axis.
+            glm::fvec3 e0 = mean, e1 = mean;
+            if (glm::dot(axis, axis) > 0.0f)
+            {
+                float pmin = FLT_MAX, pmax = -FLT_MAX;
+                for (unsigned i = 0; i < 16; ++i)
+                {
+                    if (!block.opaque[i])
+                        continue;
+                    float p = glm::dot(block.color[i] - mean, axis);
+                    if (p < pmin) pmin = p, e1 = block.color[i];
+                    if (p > pmax) pmax = p, e0 = block.color[i];
+                }
+            }
+
+            // try the fitted endpoints, then a least-squares refinement of them.
+            float bestError = FLT_MAX;
+            for (int pass = 0; pass < 3; ++pass)
+            {
+                if (pass > 0 && !refine_endpoints(block, indices, four_color, e0, e1))
+                    break;
+
+                ushort a = to_565(e0), b = to_565(e1);
+
+                // 4-color mode needs a > b, 3-color mode needs a <= b
+                if (four_color ? a < b : a > b)
+                    std::swap(a, b);
+
+                // equal endpoints can't express 4-color mode; everything maps to index 0
+                glm::fvec3 palette[4];
+                make_palette(a, b, four_color && a != b, palette);
+
+                unsigned char trial[16];
+                float error = assign_indices(block, palette, four_color && a != b, trial);
+
+                if (error < bestError)
+                {
+                    bestError = error;
+                    c0 = a, c1 = b;
+                    std::copy(std::begin(trial), std::end(trial), std::begin(indices));
+
+                    if (four_color && a == b)
+                    {
+                        for (auto& i : indices)
+                            i = 0;
+                    }
+                }
+
+                // re-derive float endpoints from the chosen ones for the next pass
+                e0 = from_565(c0), e1 = from_565(c1);
+            }
+        }
+
+        std::uint32_t bits = 0;
+        for (unsigned i = 0; i < 16; ++i)
+            bits |= (std::uint32_t)(indices[i] & 3) << (2 * i);
+
+        out[0] = (uchar)(c0 & 0xff), out[1] = (uchar)(c0 >> 8);
+        out[2] = (uchar)(c1 & 0xff), out[3] = (uchar)(c1 >> 8);
+        out[4] = (uchar)(bits), out[5] = (uchar)(bits >> 8), out[6] = (uchar)(bits >> 16), out[7] = (uchar)(bits >> 24);
+    }
+
+    // Writes one 8-byte BC3 alpha block (8-value interpolated mode).
+    void encode_alpha_block(const BlockColors& block, uchar* out)
+    {
+        uchar a0 = 0, a1 = 255;
+        for (unsigned i = 0; i < 16; ++i)
+        {
+            a0 = std::max(a0, block.alpha[i]);
+            a1 = std::min(a1, block.alpha[i]);
+        }
+
+        std::uint64_t bits = 0;
+        if (a0 > a1)
+        {
+            float palette[8];
+            palette[0] = a0, palette[1] = a1;
+            for (unsigned p = 1; p < 7; ++p)
+                palette[p + 1] = std::floor(((7 - p) * a0 + p * a1) / 7.0f + 0.5f);
+
+            for (unsigned i = 0; i < 16; ++i)
+            {
+                unsigned best = 0;
+                float bestError = FLT_MAX;
+                for (unsigned p = 0; p < 8; ++p)
+                {
+                    float e = std::abs(palette[p] - (float)block.alpha[i]);
+                    if (e < bestError)
+                        best = p, bestError = e;
+                }
+                bits |= (std::uint64_t)best << (3 * i);
+            }
+        }
+
+        out[0] = a0, out[1] = a1;
+        for (unsigned b = 0; b < 6; ++b)
+            out[2 + b] = (uchar)(bits >> (8 * b));
+    }
+
+    void decode_color_block(const uchar* in, bool force_four_color, uchar* rgba, unsigned stride)
+    {
+        ushort c0 = (ushort)(in[0] | (in[1] << 8));
+        ushort c1 = (ushort)(in[2] | (in[3] << 8));
+        std::uint32_t bits = in[4] | (in[5] << 8) | (in[6] << 16) | ((std::uint32_t)in[7] << 24);
+
+        bool four_color = force_four_color || c0 > c1;
+        glm::fvec3 palette[4];
+        make_palette(c0, c1, four_color, palette);
+
+        for (unsigned i = 0; i < 16; ++i)
+        {
+            unsigned index = (bits >> (2 * i)) & 3;
+            auto p = rgba + (i / 4) * stride + (i % 4) * 4;
+            p[0] = (uchar)palette[index].r, p[1] = (uchar)palette[index].g, p[2] = (uchar)palette[index].b;
+            p[3] = (!four_color && index == 3) ? 0 : 255;
+        }
+    }
+
+    void decode_alpha_block(const uchar* in, uchar* rgba, unsigned stride)
+    {
+        unsigned a0 = in[0], a1 = in[1];
+        unsigned palette[8] = { a0, a1 };
+        if (a0 > a1)
+        {
+            for (unsigned p = 1; p < 7; ++p)
+                palette[p + 1] = (unsigned)std::floor(((7 - p) * a0 + p * a1) / 7.0f + 0.5f);
+        }
+        else
+        {
+            for (unsigned p = 1; p < 5; ++p)
+                palette[p + 1] = (unsigned)std::floor(((5 - p) * a0 + p * a1) / 5.0f + 0.5f);
+            palette[6] = 0, palette[7] = 255;
+        }
+
+        std::uint64_t bits = 0;
+        for (unsigned b = 0; b < 6; ++b)
+            bits |= (std::uint64_t)in[2 + b] << (8 * b);
+
+        for (unsigned i = 0; i < 16; ++i)
+            rgba[(i / 4) * stride + (i % 4) * 4 + 3] = (uchar)palette[(bits >> (3 * i)) & 7];
+    }
+
+    // Stand-in pixel accessors for compressed formats, which don't support them.
+    struct COMPRESSED {
+        static Image::Pixel read(unsigned char*, int) { return Image::Pixel(0.0f); }
+        static void write(const Image::Pixel&, unsigned char*, int) { }
+    };
+}
+
 // static member
-Image::Layout Image::_layouts[11] =
+Image::Layout Image::_layouts[NUM_PIXEL_FORMATS] =
 {
     { &UNORM8<uchar>::read, &UNORM8<uchar>::write, 1, 1, R8_UNORM },
     { &SRGB8<uchar>::read, &SRGB8<uchar>::write, 1, 1, R8_SRGB },
@@ -103,7 +655,11 @@ Image::Layout Image::_layouts[11] =
     { &SRGB8<uchar>::read, &SRGB8<uchar>::write, 4, 4, R8G8B8A8_SRGB },
     { &UNORM16<ushort>::read, &UNORM16<ushort>::write, 1, 2, R16_UNORM },
     { &FLOAT<float>::read, &FLOAT<float>::write, 1, 4, R32_SFLOAT },
-    { &FLOAT<double>::read, &FLOAT<double>::write, 1, 8, R64_SFLOAT }
+    { &FLOAT<double>::read, &FLOAT<double>::write, 1, 8, R64_SFLOAT },
+    { &COMPRESSED::read, &COMPRESSED::write, 4, 0, BC1_RGBA_UNORM, 8 },
+    { &COMPRESSED::read, &COMPRESSED::write, 4, 0, BC1_RGBA_SRGB, 8 },
+    { &COMPRESSED::read, &COMPRESSED::write, 4, 0, BC3_RGBA_UNORM, 16 },
+    { &COMPRESSED::read, &COMPRESSED::write, 4, 0, BC3_RGBA_SRGB, 16 }
 };
 
 Image::Image(PixelFormat format, unsigned cols, unsigned rows, unsigned depth) :    
@@ -115,6 +671,18 @@ Image::Image(PixelFormat format, unsigned cols, unsigned rows, unsigned depth) :
     allocate(format, cols, rows, depth);
 }
 
+Image::Image(PixelFormat format, unsigned cols, unsigned rows, unsigned depth,
+    unsigned char* data, std::shared_ptr<void> owner) :
+    super(),
+    _width(cols), _height(rows), _depth(depth),
+    _pixelFormat(format),
+    _data(data),
+    _ownsData(false),
+    _dataOwner(owner)
+{
+    //nop
+}
+
 Image::Image(const Image& rhs) :
     super(rhs)
 {
@@ -134,7 +702,12 @@ Image::Image(Image&& rhs) noexcept :
         _height = rhs._height;
         _depth = rhs._depth;
         _pixelFormat = rhs._pixelFormat;
-        _data = rhs.releaseData();
+        _noDataValue = rhs._noDataValue;
+        _ownsData = rhs._ownsData;
+        _dataOwner = std::move(rhs._dataOwner);
+        _data = rhs._data;
+        rhs._data = nullptr;
+        rhs._width = rhs._height = rhs._depth = 0;
     }
 }
 
@@ -149,7 +722,7 @@ Image::~Image()
 bool
 Image::hasAlphaChannel() const
 {
-    return pixelFormat() == R8G8B8A8_UNORM || pixelFormat() == R8G8B8A8_SRGB;
+    return pixelFormat() == R8G8B8A8_UNORM || pixelFormat() == R8G8B8A8_SRGB || compressed();
 }
 
 std::shared_ptr<Image>
@@ -187,9 +760,12 @@ Image::allocate(
 
     _data = new unsigned char[sizeInBytes()];
     _ownsData = true;
+    _dataOwner = nullptr;
 
     // simple init for one-byte images
-    if (sizeInBytes() > 0)
+    if (compressed())
+        std::memset(_data, 0, sizeInBytes());
+    else if (sizeInBytes() > 0)
         write(glm::fvec4(0, 0, 0, 0), 0, 0);
 }
 
@@ -197,6 +773,16 @@ unsigned char*
 Image::releaseData()
 {
     auto released = _data;
+
+    // adopted memory isn't ours to give away
+    if (released && !_ownsData)
+    {
+        released = new unsigned char[sizeInBytes()];
+        memcpy(released, _data, sizeInBytes());
+        _dataOwner = nullptr;
+        _ownsData = true;
+    }
+
     _data = nullptr;
     _width = 0;
     _height = 0;
@@ -208,6 +794,8 @@ void
 Image::flipVerticalInPlace()
 {
     ROCKY_TODO("handle compressed pixel formats");
+    if (compressed())
+        return;
 
     auto layerBytes = sizeInBytes() / depth();
     auto rowBytes = rowSizeInBytes();
@@ -230,52 +818,70 @@ Image::flipVerticalInPlace()
 void
 Image::fill(const Image::Pixel& value)
 {
-    for (unsigned r = 0; r < depth(); ++r)
-        for (unsigned t = 0; t < height(); ++t)
-            for (unsigned s = 0; s < width(); ++s)
-                write(value, s, t, r);
+    if (!valid() || compressed())
+        return;
+
+    // encode the value once, then replicate it.
+    write(value, 0, 0, 0);
+    auto bpp = _layouts[pixelFormat()].bytes_per_pixel;
+    for (unsigned i = 1; i < sizeInPixels(); ++i)
+        std::memcpy(_data + i * bpp, _data, bpp);
 }
 
+void
+Image::read_bilinear(const glm::fvec2* uv, unsigned count, Pixel* out, unsigned layer) const
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(valid() && !compressed() && layer < depth(), void());
 
-std::shared_ptr<Image>
-Image::convolve(const float* kernel) const
+    auto& l = _layouts[pixelFormat()];
+    auto base = _data + (std::size_t)layer * width() * height() * l.bytes_per_pixel;
+
+    with_codec(pixelFormat(), { l.read, l.write, l.num_components, (unsigned)l.bytes_per_pixel }, [&](auto&& codec)
+        {
+            read_bilinear_kernel(codec, base, width(), height(), _noDataValue, uv, count, out);
+        });
+}
+
+void
+Image::readRow(Pixel* out, unsigned count, unsigned s, unsigned t, unsigned layer) const
 {
-    glm::fvec4 samples[9];
+    ROCKY_SOFT_ASSERT_AND_RETURN(valid() && !compressed() && s + count <= width() && t < height() && layer < depth(), void());
 
-    auto output = clone();
+    auto& l = _layouts[pixelFormat()];
+    auto src = _data + ((std::size_t)layer * width() * height() + (std::size_t)t * width() + s) * l.bytes_per_pixel;
 
-    for (unsigned r = 0; r < depth(); ++r)
-    {
-        for (unsigned t = 0; t < height(); ++t)
+    with_codec(pixelFormat(), { l.read, l.write, l.num_components, (unsigned)l.bytes_per_pixel }, [&](auto&& codec)
         {
-            for (unsigned s = 0; s < width(); ++s)
-            {
-                unsigned t_minus_1 = t > 0 ? t - 1 : t;
-                unsigned t_plus_1 = t < height() - 1 ? t + 1 : t;
-                unsigned s_minus_1 = s > 0 ? s - 1 : s;
-                unsigned s_plus_1 = s < width() - 1 ? s + 1 : s;
+            read_row_kernel(codec, src, count, out);
+        });
+}
 
-                samples[0] = read(s_minus_1, t_minus_1, r);
-                samples[1] = read(s, t_minus_1, r);
-                samples[2] = read(s_plus_1, t_minus_1, r);
+void
+Image::writeRow(const Pixel* pixels, unsigned count, unsigned s, unsigned t, unsigned layer)
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(valid() && !compressed() && s + count <= width() && t < height() && layer < depth(), void());
 
-                samples[3] = read(s_minus_1, t, r);
-                samples[4] = read(s, t, r);
-                samples[5] = read(s_plus_1, t, r);
+    auto& l = _layouts[pixelFormat()];
+    auto dst = _data + ((std::size_t)layer * width() * height() + (std::size_t)t * width() + s) * l.bytes_per_pixel;
 
-                samples[6] = read(s_minus_1, t_plus_1, r);
-                samples[7] = read(s, t_plus_1, r);
-                samples[8] = read(s_plus_1, t_plus_1, r);
+    with_codec(pixelFormat(), { l.read, l.write, l.num_components, (unsigned)l.bytes_per_pixel }, [&](auto&& codec)
+        {
+            write_row_kernel(codec, pixels, count, dst);
+        });
+}
 
-                glm::fvec4 pixel(0, 0, 0, 0);
-                for (int i = 0; i < 9; ++i)
-                {
-                    pixel += (samples[i] * kernel[i]);
-                }
-                output->write(clamp(pixel, 0.0f, 1.0f), s, t, r);
-            }
-        }
-    }
+std::shared_ptr<Image>
+Image::convolve(const float* kernel) const
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(valid() && !compressed(), nullptr);
+
+    auto output = Image::create(pixelFormat(), width(), height(), depth());
+
+    auto& l = _layouts[pixelFormat()];
+    with_codec(pixelFormat(), { l.read, l.write, l.num_components, (unsigned)l.bytes_per_pixel }, [&](auto&& codec)
+        {
+            convolve_kernel(codec, _data, output->_data, width(), height(), depth(), kernel);
+        });
 
     return output;
 }
@@ -306,6 +912,119 @@ Image::sharpen(float k) const
     return convolve(kernel);
 }
 
+std::shared_ptr<Image>
+Image::compress(PixelFormat format) const
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(valid() && !compressed(), nullptr);
+
+    bool bc3 = format == BC3_RGBA_UNORM || format == BC3_RGBA_SRGB;
+    bool srgb = format == BC1_RGBA_SRGB || format == BC3_RGBA_SRGB;
+    if (!bc3 && format != BC1_RGBA_UNORM && format != BC1_RGBA_SRGB)
+        return nullptr;
+
+    // The encoder works on 8-bit RGBA in the target color space.
+    const Image* source = this;
+    std::shared_ptr<Image> converted;
+    auto rgbaFormat = srgb ? R8G8B8A8_SRGB : R8G8B8A8_UNORM;
+    if (pixelFormat() != rgbaFormat)
+    {
+        converted = Image::create(rgbaFormat, width(), height(), depth());
+        std::vector<Pixel> row(width());
+        for (unsigned r = 0; r < depth(); ++r)
+        {
+            for (unsigned t = 0; t < height(); ++t)
+            {
+                readRow(row.data(), width(), 0, t, r);
+                converted->writeRow(row.data(), width(), 0, t, r);
+            }
+        }
+        source = converted.get();
+    }
+
+    auto output = Image::create(format, width(), height(), depth());
+    auto out = output->data<uchar>();
+    auto blockBytes = _layouts[format].bytes_per_block;
+    auto in = source->data<uchar>();
+    BlockColors block;
+
+    for (unsigned r = 0; r < depth(); ++r)
+    {
+        for (unsigned by = 0; by < height(); by += 4)
+        {
+            for (unsigned bx = 0; bx < width(); bx += 4, out += blockBytes)
+            {
+                // partial blocks at the right and bottom edges repeat the last pixel
+                for (unsigned i = 0; i < 16; ++i)
+                {
+                    unsigned s = std::min(bx + i % 4, width() - 1);
+                    unsigned t = std::min(by + i / 4, height() - 1);
+                    auto p = in + (((std::size_t)r * height() + t) * width() + s) * 4;
+                    block.color[i] = glm::fvec3(p[0], p[1], p[2]);
+                    block.alpha[i] = p[3];
+                    block.opaque[i] = bc3 || p[3] >= 128;
+                }
+
+                if (bc3)
+                {
+                    encode_alpha_block(block, out);
+                    encode_color_block(block, false, out + 8);
+                }
+                else
+                {
+                    encode_color_block(block, true, out);
+                }
+            }
+        }
+    }
+
+    return output;
+}
+
+std::shared_ptr<Image>
+Image::decompress() const
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(valid() && compressed(), nullptr);
+
+    bool bc3 = pixelFormat() == BC3_RGBA_UNORM || pixelFormat() == BC3_RGBA_SRGB;
+    bool srgb = pixelFormat() == BC1_RGBA_SRGB || pixelFormat() == BC3_RGBA_SRGB;
+
+    auto output = Image::create(srgb ? R8G8B8A8_SRGB : R8G8B8A8_UNORM, width(), height(), depth());
+    auto out = output->data<uchar>();
+    auto blockBytes = _layouts[pixelFormat()].bytes_per_block;
+    auto in = _data;
+    uchar rgba[64];
+
+    for (unsigned r = 0; r < depth(); ++r)
+    {
+        for (unsigned by = 0; by < height(); by += 4)
+        {
+            for (unsigned bx = 0; bx < width(); bx += 4, in += blockBytes)
+            {
+                if (bc3)
+                {
+                    decode_color_block(in + 8, true, rgba, 16);
+                    decode_alpha_block(in, rgba, 16);
+                }
+                else
+                {
+                    decode_color_block(in, false, rgba, 16);
+                }
+
+                for (unsigned y = 0; y < 4 && by + y < height(); ++y)
+                {
+                    auto count = std::min(4u, width() - bx);
+                    std::memcpy(
+                        out + (((std::size_t)r * height() + by + y) * width() + bx) * 4,
+                        rgba + y * 16,
+                        count * 4);
+                }
+            }
+        }
+    }
+
+    return output;
+}
+
 Image
 Image::viewAs(Image::PixelFormat format) const
 {
@@ -316,5 +1035,6 @@ Image::viewAs(Image::PixelFormat format) const
     view._depth = _depth;
     view._data = _data; // share the data
     view._ownsData = false;
+    view._dataOwner = _dataOwner;
     return view;
 }
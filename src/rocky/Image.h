@@ -37,6 +37,10 @@ namespace ROCKY_NAMESPACE
             R16_UNORM,
             R32_SFLOAT,
             R64_SFLOAT,
+            BC1_RGBA_UNORM, // 4x4 blocks, 8 bytes each, 1-bit alpha
+            BC1_RGBA_SRGB,
+            BC3_RGBA_UNORM, // 4x4 blocks, 16 bytes each, full alpha
+            BC3_RGBA_SRGB,
             NUM_PIXEL_FORMATS,
             UNDEFINED
         };
@@ -63,6 +67,11 @@ namespace ROCKY_NAMESPACE
         //! Whether there's an alpha channel
         bool hasAlphaChannel() const;
 
+        //! Whether the pixel format is block-compressed. Compressed images
+        //! hold 4x4 pixel blocks and do not support reading or writing
+        //! individual pixels; call decompress() first.
+        inline bool compressed() const;
+
     public:
         //! Construct an empty (invalid) image
         Image() = default;
@@ -71,6 +80,12 @@ namespace ROCKY_NAMESPACE
         //! unless data is non-null, in which case use that memory
         Image(PixelFormat format, unsigned s, unsigned t, unsigned r = 1);
 
+        //! Construct an image that adopts existing pixel memory without copying it.
+        //! The memory must be tightly packed in the given format. "owner" keeps it
+        //! alive for the life of the image (and any views of it).
+        Image(PixelFormat format, unsigned s, unsigned t, unsigned r,
+            unsigned char* data, std::shared_ptr<void> owner);
+
         //! Copy constructor
         Image(const Image& rhs);
 
@@ -155,6 +170,21 @@ namespace ROCKY_NAMESPACE
             return read_bilinear(i.u(), i.v(), i.r());
         }
 
+        //! Read many pixels at UV coordinates with bilinear interpolation. Same results as
+        //! calling read_bilinear() for each one, but much faster for the common formats.
+        //! \param uv UV coordinates to sample
+        //! \param count Number of coordinates
+        //! \param out Output pixels, one per coordinate (in linear color space, if applicable)
+        void read_bilinear(const glm::fvec2* uv, unsigned count, Pixel* out, unsigned layer = 0) const;
+
+        //! Read a run of pixels from one row, starting at column s.
+        //! \param out Output pixels (in linear color space, if applicable)
+        void readRow(Pixel* out, unsigned count, unsigned s, unsigned t, unsigned layer = 0) const;
+
+        //! Write a run of pixels to one row, starting at column s.
+        //! \param pixels Values to store (in linear color space, if applicable)
+        void writeRow(const Pixel* pixels, unsigned count, unsigned s, unsigned t, unsigned layer = 0);
+
         //! Write the pixel at a column, row, and layer
         //! \param pixel Value to store (in linear color space, if applicable)
         inline void write(const Pixel& pixel, unsigned s, unsigned t, unsigned layer = 0);
@@ -171,7 +201,7 @@ namespace ROCKY_NAMESPACE
         //! Size of this image in pixels
         inline unsigned sizeInPixels() const;
 
-        //! Size of a row in bytes
+        //! Size of a row in bytes (for a compressed image, a row of blocks)
         inline unsigned rowSizeInBytes() const;
 
         //! Size of each pixel component in bytes
@@ -191,6 +221,18 @@ namespace ROCKY_NAMESPACE
         //! Inverts the pixels in the T dimension
         void flipVerticalInPlace();
 
+        //! Creates a block-compressed copy of this image, suitable for uploading
+        //! directly to the GPU at a fraction of the memory cost.
+        //! @param format BC1_* or BC3_* format; the SRGB variants expect and
+        //!   store color in sRGB space, just like the uncompressed SRGB formats.
+        //! @return Compressed image, or nullptr if the format isn't supported
+        std::shared_ptr<Image> compress(PixelFormat format) const;
+
+        //! Creates an uncompressed R8G8B8A8 copy of a block-compressed image
+        //! (UNORM or SRGB to match).
+        //! @return Decompressed image, or nullptr if this image isn't compressed
+        std::shared_ptr<Image> decompress() const;
+
         //! Nmmber of components in this image's pixel format
         inline unsigned numComponents() const;
 
@@ -204,10 +246,14 @@ namespace ROCKY_NAMESPACE
 
         //! Releases this image's data without deleting it. 
         //! Use this to transfer ownership of the raw data to someone else.
-        //! The inheritor is responsible to deleting the data.
+        //! The inheritor is responsible to deleting the data (with delete[]).
+        //! If the image adopted its memory from someone else, you get a copy.
         //! This object becomes invalid unless you call allocate() on it again.
         unsigned char* releaseData();
 
+        //! Whether this image allocated (and will delete) its own data
+        inline bool ownsData() const { return _ownsData; }
+
         //! Reinterprets this image as having a different pixel format.
         //! Use this with caution. Only use this as a temporary object.
         //! Data ownership is shared between the original and the view,
@@ -222,6 +268,7 @@ namespace ROCKY_NAMESPACE
         unsigned char* _data = nullptr;
         float _noDataValue = -std::numeric_limits<float>::max(); // default no-data value
         bool _ownsData = true;
+        std::shared_ptr<void> _dataOwner; // keeps adopted data alive
         float _minValue = 0.0f; // applies to heightfields
         float _maxValue = 0.0f; // applies to heightfields
 
@@ -233,8 +280,9 @@ namespace ROCKY_NAMESPACE
             int num_components;
             int bytes_per_pixel;
             PixelFormat format;
+            int bytes_per_block = 0; // 4x4 blocks; non-zero only for compressed formats
         };
-        static Layout _layouts[11];
+        static Layout _layouts[NUM_PIXEL_FORMATS];
 
         inline unsigned sizeof_miplevel(unsigned level) const;
         inline unsigned char* data_at_miplevel(unsigned level);
@@ -250,6 +298,11 @@ namespace ROCKY_NAMESPACE
         return width() > 0 && height() > 0 && depth() > 0 && _data;
     }
 
+    inline bool Image::compressed() const
+    {
+        return _layouts[pixelFormat()].bytes_per_block > 0;
+    }
+
     inline Image::Pixel Image::read(unsigned s, unsigned t, unsigned layer) const
     {
         return _layouts[pixelFormat()].read(
@@ -295,13 +348,16 @@ namespace ROCKY_NAMESPACE
     {
         _layouts[pixelFormat()].write(
             pixel,
-            _data + (width() * height() * layer + height() * t + s) * _layouts[pixelFormat()].bytes_per_pixel,
+            _data + (width() * height() * layer + width() * t + s) * _layouts[pixelFormat()].bytes_per_pixel,
             _layouts[pixelFormat()].num_components);
     }
 
     unsigned Image::sizeInBytes() const
     {
-        return sizeInPixels() * _layouts[pixelFormat()].bytes_per_pixel;
+        if (compressed())
+            return ((width() + 3) / 4) * ((height() + 3) / 4) * depth() * _layouts[pixelFormat()].bytes_per_block;
+        else
+            return sizeInPixels() * _layouts[pixelFormat()].bytes_per_pixel;
     }
 
     unsigned Image::sizeInPixels() const
@@ -311,7 +367,10 @@ namespace ROCKY_NAMESPACE
 
     unsigned Image::rowSizeInBytes() const
     {
-        return width() * _layouts[pixelFormat()].bytes_per_pixel;
+        if (compressed())
+            return ((width() + 3) / 4) * _layouts[pixelFormat()].bytes_per_block;
+        else
+            return width() * _layouts[pixelFormat()].bytes_per_pixel;
     }
 
     unsigned char* Image::data_at_miplevel(unsigned m)
@@ -185,44 +185,59 @@ ImageLayer::assembleTile(const TileKey& key, const IOOptions& io) const
         auto keyExtent = key.extent();
         unsigned numSourcesAtFullResolution = 0;
 
-        for (auto& localKey : localKeys)
-        {
-            // resolve an image for each local key.
-            TileKey actualKey = localKey;
+        // resolve an image for each local key. The sources are often remote, so
+        // fetch them concurrently to overlap the round trips.
+        std::vector<std::optional<GeoImage>> localTiles(localKeys.size());
+        std::vector<char> fullResolution(localKeys.size(), 0);
 
-            auto create = [&]() -> Result<GeoImage>
-                {
-                    // not found in the resident cache; go to the source, and fall back until we get
-                    // a usable image tile.
-                    while (actualKey.valid())
+        auto fetch = [&](unsigned i, const IOOptions& io)
+            {
+                TileKey actualKey = localKeys[i];
+
+                auto create = [&]() -> Result<GeoImage>
                     {
-                        auto r = invokeCreateTileImplementation(actualKey, io);
-
-                        if (io.canceled())
-                            return Failure_OperationCanceled;
-                        else if (r.ok() && r.value().image())
-                            return r;
-                        else
-                            actualKey.makeParent();
-                    }
+                        // not found in the resident cache; go to the source, and fall back until we get
+                        // a usable image tile.
+                        while (actualKey.valid())
+                        {
+                            auto r = invokeCreateTileImplementation(actualKey, io);
+
+                            if (io.canceled())
+                                return Failure_OperationCanceled;
+                            else if (r.ok() && r.value().image())
+                                return r;
+                            else
+                                actualKey.makeParent();
+                        }
+
+                        return Failure_ResourceUnavailable;
+                    };
 
-                    return Failure_ResourceUnavailable;
-                };
+                auto localTile = getOrCreateTile(localKeys[i], io, create);
 
-            auto localTile = getOrCreateTile(localKey, io, create);
+                if (localTile.ok())
+                {
+                    localTiles[i] = std::move(localTile.value());
+                    fullResolution[i] = (actualKey.level == localKeys[i].level);
+                }
+            };
+
+        detail::concurrentIO((unsigned)localKeys.size(), fetch, io);
+
+        if (io.canceled())
+            return {};
 
-            if (localTile.ok())
+        for (unsigned i = 0; i < localKeys.size(); ++i)
+        {
+            if (localTiles[i].has_value())
             {
-                sources.emplace_back(std::move(localTile.value()));
+                sources.emplace_back(std::move(localTiles[i].value()));
 
-                if (actualKey.level == localKey.level)
+                if (fullResolution[i])
                 {
                     ++numSourcesAtFullResolution;
                 }
             }
-
-            if (io.canceled())
-                return {};
         }
 
         // If we actually got at least one piece of usable data,
@@ -234,12 +249,8 @@ ImageLayer::assembleTile(const TileKey& key, const IOOptions& io) const
             unsigned layers = 1;
 
             // sort the sources by resolution (highest first)
-            bool useIndirectIndexing = true;
-
             if (numSourcesAtFullResolution < sources.size())
             {
-                useIndirectIndexing = false;
-
                 std::sort(
                     sources.begin(), sources.end(),
                     [](const GeoImage& lhs, const GeoImage& rhs) {
@@ -291,10 +302,12 @@ ImageLayer::assembleTile(const TileKey& key, const IOOptions& io) const
             // where there's no data beyond +/- 85 degrees.
             auto keyExtentInSourceSRS = key.extent().transform(sources[0].srs());
 
-            // transform the sample points to the SRS of our source data tiles:
+            // transform the sample points to the SRS of our source data tiles,
+            // interpolating where that stays within the allowable error:
             if (xform.valid())
             {
-                xform.transformArray(&points[0], points.size());
+                double maxError = maxReprojectionError.value() * sources[0].extent().width() / (double)sources[0].image()->width();
+                xform.transformGrid(&points[0], cols, rows, maxError);
 
                 // clamp the transformed points to the profile SRS.
                 if (keyExtentInSourceSRS.valid())
@@ -303,47 +316,61 @@ ImageLayer::assembleTile(const TileKey& key, const IOOptions& io) const
                 }
             }
 
-            // Indirect indexing lets us do a basic "LRU" cache when looping through multiple images.
-            std::vector<unsigned> indexes(sources.size());
-            std::iota(indexes.begin(), indexes.end(), 0);
-
-            // Mosaic our sources into a single output image.
+            // Mosaic our sources into a single output image, a row at a time.
+            // Each pixel takes its value from the first source (highest resolution
+            // first) with a non-transparent sample there.
             glm::fvec4 emptypixel(0.0f, 0.0f, 0.0f, 0.0f);
 
+            std::vector<Image::Pixel> row(cols), found(cols);
+            std::vector<glm::dvec3> remaining(cols);
+            std::vector<unsigned> index(cols);
+            std::vector<char> ok(cols);
+            std::vector<char> wrote(cols);
+
             for (unsigned layer = 0; layer < layers; ++layer)
             {
                 for (unsigned r = 0; r < rows; ++r)
                 {
-                    for (unsigned c = 0; c < cols; ++c)
-                    {
-                        unsigned i = r * cols + c;
+                    std::fill(wrote.begin(), wrote.end(), 0);
 
-                        // check each source (high to low resolution) until we get a valid pixel.
-                        bool wrote = false;
+                    for (unsigned k = 0; k < sources.size(); ++k)
+                    {
+                        if (layer >= sources[k].image()->depth())
+                            continue;
 
-                        for(unsigned n = 0; n < indexes.size(); ++n)
+                        unsigned count = 0;
+                        for (unsigned c = 0; c < cols; ++c)
                         {
-                            unsigned k = useIndirectIndexing ? indexes[n] : n;
-
-                            if (layer < sources[k].image()->depth())
+                            if (!wrote[c])
                             {
-                                auto pixel = sources[k].read(points[i].x, points[i].y, layer);
-                                if (pixel.ok() && pixel.value().a > 0.0f)
-                                {
-                                    output->write(pixel.value(), c, r, layer);
-                                    wrote = true;
-                                    std::swap(indexes[n], indexes[0]);
-                                    break;
-                                }
+                                remaining[count] = points[r * cols + c];
+                                index[count++] = c;
                             }
                         }
 
-                        if (!wrote)
+                        if (count == 0)
+                            break;
+
+                        sources[k].read(remaining.data(), count, found.data(), ok.data(), layer);
+
+                        for (unsigned i = 0; i < count; ++i)
                         {
-                            output->write(emptypixel, c, r, layer);
+                            if (ok[i] && found[i].a > 0.0f)
+                            {
+                                row[index[i]] = found[i];
+                                wrote[index[i]] = 1;
+                            }
                         }
                     }
 
+                    for (unsigned c = 0; c < cols; ++c)
+                    {
+                        if (!wrote[c])
+                            row[c] = emptypixel;
+                    }
+
+                    output->writeRow(row.data(), cols, 0, r, layer);
+
                     if (io.canceled())
                         return {};
                 }
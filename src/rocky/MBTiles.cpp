@@ -340,23 +340,24 @@ MBTiles::Driver::read(const TileKey& key, const IOOptions& io) const
         const char* data = (const char*)sqlite3_column_blob(select, 0);
         int dataLen = sqlite3_column_bytes(select, 0);
 
-        std::string dataBuffer(data, dataLen);
+        // the blob stays valid until the statement is reset, so read it in place
+        std::string dataBuffer;
 
 #ifdef ROCKY_HAS_ZLIB
         // decompress if necessary:
         if (_options.compress == true)
         {
-            std::istringstream inputStream(dataBuffer);
-            std::string value;
+            util::imemstream inputStream(data, dataLen);
 
-            if (!util::ZLibCompressor().decompress(inputStream, value))
+            if (!util::ZLibCompressor().decompress(inputStream, dataBuffer))
             {
                 errorMessage = "Decompression failed";
                 valid = false;
             }
             else
             {
-                dataBuffer = value;
+                data = dataBuffer.data();
+                dataLen = (int)dataBuffer.size();
             }
         }
 #endif // ROCKY_HAS_ZLIB
@@ -364,7 +365,7 @@ MBTiles::Driver::read(const TileKey& key, const IOOptions& io) const
         // decode the raw image data:
         if (valid)
         {
-            std::istringstream inputStream(dataBuffer);
+            util::imemstream inputStream(data, dataLen);
             auto r = io.services().readImageFromStream(inputStream, {}, io);
             if (r.ok())
                 result = r.value();
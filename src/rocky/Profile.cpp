@@ -8,6 +8,8 @@
 #include "Math.h"
 #include "Utils.h"
 #include "json.h"
+#include <algorithm>
+#include <mutex>
 
 using namespace ROCKY_NAMESPACE;
 using namespace ROCKY_NAMESPACE::util;
@@ -79,6 +81,16 @@ Profile::setup(const SRS& srs, const Box& bounds, unsigned width0, unsigned heig
 
         _shared->subprofiles = subprofiles;
     }
+
+    // any ID interned before now belongs to the old definition
+    _shared->internedID = -1;
+}
+
+namespace
+{
+    // Every distinct profile that has been asked for an interned ID; the ID is the index.
+    std::mutex s_internedMutex;
+    std::vector<Profile> s_interned;
 }
 
 // invalid profile
@@ -254,6 +266,40 @@ Profile::setup(const std::string& name)
     }
 }
 
+unsigned
+Profile::internedID() const
+{
+    if (!valid())
+        return ~0u;
+
+    int id = _shared->internedID.load(std::memory_order_acquire);
+    if (id >= 0)
+        return (unsigned)id;
+
+    std::scoped_lock lock(s_internedMutex);
+
+    auto iter = std::find(s_interned.begin(), s_interned.end(), *this);
+    if (iter != s_interned.end())
+    {
+        id = (int)(iter - s_interned.begin());
+    }
+    else
+    {
+        id = (int)s_interned.size();
+        s_interned.emplace_back(*this);
+    }
+
+    _shared->internedID.store(id, std::memory_order_release);
+    return (unsigned)id;
+}
+
+Profile
+Profile::interned(unsigned id)
+{
+    std::scoped_lock lock(s_internedMutex);
+    return id < s_interned.size() ? s_interned[id] : Profile();
+}
+
 bool
 Profile::valid() const {
     return _shared && _shared->extent.valid();
@@ -7,6 +7,7 @@
 
 #include <rocky/Common.h>
 #include <rocky/GeoExtent.h>
+#include <atomic>
 #include <vector>
 #include <string>
 
@@ -142,6 +143,16 @@ namespace ROCKY_NAMESPACE
         //! Get the hash code for this profile
         inline std::size_t hash() const;
 
+        //! Small number that identifies this profile (and every profile equivalent
+        //! to it) for the life of the process. TileID uses it to pack a TileKey
+        //! into 64 bits. Thread-safe; only the first call per profile takes a lock.
+        //! @return Interned ID, or ~0u for an invalid profile
+        unsigned internedID() const;
+
+        //! The profile behind an interned ID
+        //! @return The profile, or an invalid profile if no such ID was issued
+        static Profile interned(unsigned id);
+
     protected:
 
         struct Data
@@ -153,6 +164,7 @@ namespace ROCKY_NAMESPACE
             unsigned    numTilesBaseY = 1u;
             std::size_t hash = 0;
             std::vector<Profile> subprofiles;
+            std::atomic_int internedID = { -1 };
         };
         std::shared_ptr<Data> _shared;
 
@@ -986,6 +986,163 @@ SRSOperation::inverse(void* handle, double* x, double* y, double* z, std::size_t
         return false;
 }
 
+namespace
+{
+    // Approximate transform of a regular grid, after GDAL's approximate transformer.
+    // Each region transforms its corners, edge midpoints and center exactly; if bilinear
+    // interpolation of the corners reproduces the other five within maxError, the whole
+    // region is interpolated. Otherwise it splits into quadrants and tries again, down
+    // to regions small enough that we just transform every point.
+    // EXACT_ONE(x, y, z) transforms one point; EXACT_RUN(i, n) transforms n consecutive
+    // grid points in place starting at index i. Both return false on failure.
+    template<typename EXACT_ONE, typename EXACT_RUN>
+    bool approximateGrid(double* x, double* y, double* z, std::size_t stride,
+        unsigned cols, unsigned rows, double maxError, EXACT_ONE&& exactOne, EXACT_RUN&& exactRun)
+    {
+        auto at = [stride](double* base, std::size_t i) -> double& {
+            return *reinterpret_cast<double*>(reinterpret_cast<char*>(base) + i * stride);
+        };
+
+        // regions with fewer points than this on a side just get transformed
+        constexpr unsigned min_span = 5;
+
+        // Since the input is evenly spaced we can recompute any input point from
+        // the corners, which frees us to overwrite the grid as we go.
+        auto last = (std::size_t)cols * rows - 1;
+        glm::dvec3 origin(at(x, 0), at(y, 0), at(z, 0));
+        glm::dvec3 colStep = (glm::dvec3(at(x, cols - 1), at(y, cols - 1), at(z, cols - 1)) - origin) / (double)(cols - 1);
+        glm::dvec3 rowStep = (glm::dvec3(at(x, last - cols + 1), at(y, last - cols + 1), at(z, last - cols + 1)) - origin) / (double)(rows - 1);
+
+        auto input = [&](unsigned c, unsigned r) {
+            return origin + colStep * (double)c + rowStep * (double)r;
+            };
+
+        // not evenly spaced after all? Do it the slow way.
+        auto far = input(cols - 1, rows - 1);
+        auto tolerance = 1e-9 * (glm::length(colStep) * cols + glm::length(rowStep) * rows);
+        if (std::abs(far.x - at(x, last)) > tolerance || std::abs(far.y - at(y, last)) > tolerance)
+            return exactRun(0, last + 1);
+
+        bool ok = true;
+
+        // exactly transform every point in a region
+        auto exactRegion = [&](unsigned c0, unsigned r0, unsigned c1, unsigned r1)
+            {
+                for (unsigned r = r0; r <= r1; ++r)
+                {
+                    auto i = (std::size_t)r * cols + c0;
+                    for (unsigned c = c0; c <= c1; ++c)
+                    {
+                        auto p = input(c, r);
+                        at(x, r * cols + c) = p.x, at(y, r * cols + c) = p.y, at(z, r * cols + c) = p.z;
+                    }
+                    if (!exactRun(i, c1 - c0 + 1))
+                        ok = false;
+                }
+            };
+
+        struct Region { unsigned c0, r0, c1, r1; };
+        std::vector<Region> stack;
+        stack.push_back({ 0u, 0u, cols - 1, rows - 1 });
+
+        while (!stack.empty())
+        {
+            auto [c0, r0, c1, r1] = stack.back();
+            stack.pop_back();
+
+            if (c1 - c0 + 1 < min_span || r1 - r0 + 1 < min_span)
+            {
+                exactRegion(c0, r0, c1, r1);
+                continue;
+            }
+
+            unsigned cm = (c0 + c1) / 2, rm = (r0 + r1) / 2;
+
+            // control points: 4 corners, then 4 edge midpoints and the center
+            const unsigned cs[9] = { c0, c1, c0, c1, cm, cm, c0, c1, cm };
+            const unsigned rs[9] = { r0, r0, r1, r1, r0, r1, rm, rm, rm };
+            glm::dvec3 exact[9];
+            bool usable = true;
+            for (unsigned k = 0; k < 9 && usable; ++k)
+            {
+                exact[k] = input(cs[k], rs[k]);
+                usable = exactOne(exact[k].x, exact[k].y, exact[k].z) &&
+                    std::isfinite(exact[k].x) && std::isfinite(exact[k].y);
+            }
+
+            auto interpolate = [&](unsigned c, unsigned r)
+                {
+                    double u = (double)(c - c0) / (double)(c1 - c0);
+                    double v = (double)(r - r0) / (double)(r1 - r0);
+                    return glm::mix(glm::mix(exact[0], exact[1], u), glm::mix(exact[2], exact[3], u), v);
+                };
+
+            for (unsigned k = 4; k < 9 && usable; ++k)
+            {
+                auto error = interpolate(cs[k], rs[k]) - exact[k];
+                usable = std::sqrt(error.x * error.x + error.y * error.y) <= maxError;
+            }
+
+            if (usable)
+            {
+                for (unsigned r = r0; r <= r1; ++r)
+                {
+                    for (unsigned c = c0; c <= c1; ++c)
+                    {
+                        auto p = interpolate(c, r);
+                        auto i = (std::size_t)r * cols + c;
+                        at(x, i) = p.x, at(y, i) = p.y, at(z, i) = p.z;
+                    }
+                }
+
+                // keep the exact values we already have
+                for (unsigned k = 0; k < 9; ++k)
+                {
+                    auto i = (std::size_t)rs[k] * cols + cs[k];
+                    at(x, i) = exact[k].x, at(y, i) = exact[k].y, at(z, i) = exact[k].z;
+                }
+            }
+            else
+            {
+                // quadrants share their edges so there are no gaps between them
+                stack.push_back({ c0, r0, cm, rm });
+                stack.push_back({ cm, r0, c1, rm });
+                stack.push_back({ c0, rm, cm, r1 });
+                stack.push_back({ cm, rm, c1, r1 });
+            }
+        }
+
+        return ok;
+    }
+}
+
+bool
+SRSOperation::forwardGrid(void* handle, double* x, double* y, double* z, std::size_t stride,
+    unsigned cols, unsigned rows, double maxError) const
+{
+    if (!handle)
+        return false;
+
+    // too small to gain anything
+    if (maxError <= 0.0 || cols < 8 || rows < 8)
+        return forward(handle, x, y, z, stride, (std::size_t)cols * rows);
+
+    return approximateGrid(x, y, z, stride, cols, rows, maxError,
+        [&](double& px, double& py, double& pz)
+        {
+            return forward(handle, px, py, pz);
+        },
+        [&](std::size_t i, std::size_t count)
+        {
+            auto offset = i * stride;
+            return forward(handle,
+                reinterpret_cast<double*>(reinterpret_cast<char*>(x) + offset),
+                reinterpret_cast<double*>(reinterpret_cast<char*>(y) + offset),
+                reinterpret_cast<double*>(reinterpret_cast<char*>(z) + offset),
+                stride, count);
+        });
+}
+
 Box
 SRSOperation::transformBounds(const Box& in) const
 {
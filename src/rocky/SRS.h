@@ -337,6 +337,17 @@ namespace ROCKY_NAMESPACE
                 &inout[0][0], &inout[0][1], &inout[0][2], sizeof(DVEC3), count);
         }
 
+        //! Transform a row-major grid of evenly spaced 3-vectors in place, approximately.
+        //! Transforms a sparse set of control points exactly and interpolates between
+        //! them, refining wherever the interpolation would be off by more than maxError
+        //! (in target units). A maxError of zero transforms every point exactly.
+        //! @return True if all transformations succeeded
+        template<typename DVEC3>
+        inline bool transformGrid(DVEC3* inout, unsigned cols, unsigned rows, double maxError) const {
+            return _nop ? true : forwardGrid(_handle,
+                &inout[0][0], &inout[0][1], &inout[0][2], sizeof(DVEC3), cols, rows, maxError);
+        }
+
         //! Inverse-transform a 2D point
         //! @return True is the transformation succeeded
         inline bool inverse(double& x, double& y) const {
@@ -415,6 +426,7 @@ namespace ROCKY_NAMESPACE
 
         bool forward(void* handle, double* x, double* y, double* z, std::size_t stride, std::size_t count) const;
         bool inverse(void* handle, double* x, double* y, double* z, std::size_t stride, std::size_t count) const;
+        bool forwardGrid(void* handle, double* x, double* y, double* z, std::size_t stride, unsigned cols, unsigned rows, double maxError) const;
         friend class SRS;
     };
 
@@ -84,6 +84,15 @@ namespace ROCKY_NAMESPACE
                     return emplace(data);
             }
 
+            //! Stops tracking the object associated with the token, without
+            //! disposing of it. The token is invalid afterwards.
+            inline void erase(void* token)
+            {
+                auto ptr = static_cast<ListIterator*>(token);
+                _list.erase(*ptr);
+                _size--;
+            }
+
             //! Removes any tracked objects that were not updated since the last
             //! flush, and calls dispose() on each one.
             template<typename CALLABLE>
@@ -7,6 +7,7 @@
 #include "Map.h"
 #include "ElevationLayer.h"
 #include "ImageLayer.h"
+#include "IOTypes.h"
 
 #define LC "[TerrainTileModelFactory] "
 
@@ -43,19 +44,34 @@ TerrainTileModelFactory::createTileModel(const Map* map, const TileKey& key, con
     model.key = key;
     model.revision = map->revision();
 
-    // assemble all the components:
-    addColorLayers(model, map, key, io);
+    // assemble all the components. Color and elevation go in parallel so the
+    // tile waits on the slowest layer instead of the sum of them all. Color is
+    // index 0, which concurrentIO always runs on this thread, so its own fan-out
+    // over the color layers starts from here no matter who picks up elevation.
+    auto build = [&](unsigned i, const IOOptions& io)
+        {
+            if (i == 0)
+                addColorLayers(model, map, key, io);
+            else
+                addElevation(model, map, key, io);
+        };
 
-    unsigned border = 0u;
-    addElevation(model, map, key, io);
+    detail::concurrentIO(2u, build, io, maxConcurrentLayers);
 
     return model;
 }
 
 namespace
 {
-    // return: true if fallback occurred, false if not.
-    bool addImageLayer(const TileKey& startingKey, std::shared_ptr<ImageLayer> layer, bool fallback, TerrainTileModel& model, const IOOptions& io)
+    struct Fetched
+    {
+        GeoImage image;
+        TileKey key;
+        bool fell_back = false;
+    };
+
+    // fetch an image for one layer, optionally falling back on ancestor keys.
+    Fetched fetchImageLayer(const TileKey& startingKey, std::shared_ptr<ImageLayer> layer, bool fallback, const IOOptions& io)
     {
         GeoImage geoimage;
         Status status;
@@ -90,11 +106,7 @@ namespace
 
         if (geoimage.valid())
         {
-            auto& m = model.colorLayers.emplace_back();
-            m.layer = layer;
-            m.revision = layer->revision();
-            m.image = geoimage;
-            m.key = key;
+            return Fetched{ geoimage, key, fell_back };
         }
 
         // ResourceUnavailable just means the driver could not produce data
@@ -108,7 +120,21 @@ namespace
             }
         }
 
-        return fell_back;
+        return Fetched{ {}, key, fell_back };
+    }
+
+    // return: true if fallback occurred, false if not.
+    bool addImageLayer(Fetched&& fetched, std::shared_ptr<ImageLayer> layer, TerrainTileModel& model)
+    {
+        if (fetched.image.valid())
+        {
+            auto& m = model.colorLayers.emplace_back();
+            m.layer = layer;
+            m.revision = layer->revision();
+            m.image = std::move(fetched.image);
+            m.key = fetched.key;
+        }
+        return fetched.fell_back;
     }
 }
 
@@ -149,16 +175,30 @@ TerrainTileModelFactory::addColorLayers(TerrainTileModel& model, const Map* map,
         {
             // if only one layer intersects we will not need to composite
             // so just get the raw data for this key if there is any.
-            addImageLayer(candidates.front().key, candidates.front().layer, no_fallback, model, io);
+            auto& c = candidates.front();
+            addImageLayer(fetchImageLayer(c.key, c.layer, no_fallback, io), c.layer, model);
         }
 
         else if (candidates.size() > 1)
         {
             unsigned num_fallbacks = 0;
 
-            for (auto c : candidates)
+            // fetch all the layers at once, then add them in order.
+            std::vector<Fetched> fetched(candidates.size());
+
+            auto fetch = [&](unsigned i, const IOOptions& io)
+                {
+                    fetched[i] = fetchImageLayer(candidates[i].key, candidates[i].layer, yes_fallback, io);
+                };
+
+            detail::concurrentIO((unsigned)candidates.size(), fetch, io, maxConcurrentLayers);
+
+            if (io.canceled())
+                return;
+
+            for (unsigned i = 0; i < candidates.size(); ++i)
             {
-                if (addImageLayer(c.key, c.layer, yes_fallback, model, io))
+                if (addImageLayer(std::move(fetched[i]), candidates[i].layer, model))
                 {
                     ++num_fallbacks;
                 }
@@ -204,6 +244,42 @@ TerrainTileModelFactory::addColorLayers(TerrainTileModel& model, const Map* map,
                 model.colorLayers.clear();
             }
         }
+
+        if (colorCompression != Image::UNDEFINED)
+        {
+            compressColorLayers(model);
+        }
+    }
+}
+
+void
+TerrainTileModelFactory::compressColorLayers(TerrainTileModel& model) const
+{
+    bool bc3 = colorCompression == Image::BC3_RGBA_UNORM || colorCompression == Image::BC3_RGBA_SRGB;
+
+    for (auto& layer : model.colorLayers)
+    {
+        auto image = layer.image.image();
+
+        // partial blocks would stretch the texture, so leave odd sizes alone
+        if (!image || image->compressed() || image->width() % 4 != 0 || image->height() % 4 != 0)
+            continue;
+
+        bool srgb =
+            image->pixelFormat() == Image::R8_SRGB ||
+            image->pixelFormat() == Image::R8G8_SRGB ||
+            image->pixelFormat() == Image::R8G8B8_SRGB ||
+            image->pixelFormat() == Image::R8G8B8A8_SRGB;
+
+        auto format =
+            bc3 ? (srgb ? Image::BC3_RGBA_SRGB : Image::BC3_RGBA_UNORM) :
+            (srgb ? Image::BC1_RGBA_SRGB : Image::BC1_RGBA_UNORM);
+
+        auto compressed = image->compress(format);
+        if (compressed)
+        {
+            layer.image = GeoImage(compressed, layer.image.extent());
+        }
     }
 }
 
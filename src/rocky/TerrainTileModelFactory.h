@@ -24,6 +24,16 @@ namespace ROCKY_NAMESPACE
         //! Whether to composite all color layers into one
         bool compositeColorLayers = true;
 
+        //! Maximum number of layers to fetch concurrently for one tile.
+        //! Elevation is fetched alongside color. A value of 1 fetches
+        //! every layer one after the other.
+        unsigned maxConcurrentLayers = 4u;
+
+        //! Block-compress the final color layers into this format (BC1_RGBA_UNORM
+        //! or BC3_RGBA_UNORM; sRGB imagery gets the SRGB variant) so they upload
+        //! to the GPU as-is. UNDEFINED leaves them uncompressed.
+        Image::PixelFormat colorCompression = Image::UNDEFINED;
+
     public:
         TerrainTileModelFactory() = default;
 
@@ -38,5 +48,7 @@ namespace ROCKY_NAMESPACE
         void addColorLayers(TerrainTileModel& model,const Map* map,const TileKey& key,const IOOptions& io) const;
 
         bool addElevation(TerrainTileModel& model, const Map* map, const TileKey& key, const IOOptions& io) const;
+
+        void compressColorLayers(TerrainTileModel& model) const;
     };
 }
@@ -6,8 +6,14 @@
 #pragma once
 #include <rocky/Common.h>
 #include <rocky/weejobs.h>
-#include <vector>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
 #include <list>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
 namespace ROCKY_NAMESPACE
 {
@@ -127,6 +133,128 @@ namespace ROCKY_NAMESPACE
             Gate<T>* _gate = nullptr;
             T _key;
         };
+
+        /**
+        * Coalesces concurrent calls for the same key into one ("single flight").
+        * The first caller for a key runs the function; any callers that arrive
+        * for the same key while it is running wait for it and receive a copy of
+        * its result instead of repeating the work. If the function throws, the
+        * waiting callers rethrow the same exception.
+        */
+        template<typename K, typename V, typename HASH = std::hash<K>>
+        class SingleFlight
+        {
+        public:
+            SingleFlight() = default;
+
+            //! Runs "func" for "key", or joins a call already in flight for that key.
+            //! @param key Key identifying the work
+            //! @param func Function returning the V to share
+            //! @param joined If non-null, set to true if this call received another
+            //!   caller's result rather than running func itself
+            //! @param cancelable If non-null, a joining caller stops waiting once
+            //!   this is canceled
+            //! @return the result, or empty if this call joined another and was
+            //!   canceled before that call finished
+            template<typename FUNC>
+            std::optional<V> run(const K& key, FUNC&& func, bool* joined = nullptr, const Cancelable* cancelable = nullptr)
+            {
+                std::shared_ptr<Call> call;
+                bool leader = false;
+                {
+                    std::scoped_lock lock(_mutex);
+                    auto& slot = _calls[key];
+                    if (!slot)
+                    {
+                        slot = std::make_shared<Call>();
+                        leader = true;
+                    }
+                    call = slot;
+                }
+
+                if (joined)
+                    *joined = !leader;
+
+                if (leader)
+                {
+                    // Retire the call and wake the followers however func exits.
+                    struct Publish
+                    {
+                        SingleFlight& flight;
+                        const K& key;
+                        Call& call;
+                        ~Publish()
+                        {
+                            {
+                                std::scoped_lock lock(flight._mutex);
+                                flight._calls.erase(key);
+                            }
+                            {
+                                std::scoped_lock lock(call.mutex);
+                                call.done = true;
+                            }
+                            call.signal.notify_all();
+                        }
+                    };
+
+                    Publish publish{ *this, key, *call };
+
+                    // followers don't read these until "done" is set
+                    try
+                    {
+                        call->result = func();
+                    }
+                    catch (...)
+                    {
+                        call->error = std::current_exception();
+                        throw;
+                    }
+                    return call->result;
+                }
+                else
+                {
+                    std::unique_lock lock(call->mutex);
+                    if (cancelable)
+                    {
+                        while (!call->done)
+                        {
+                            if (cancelable->canceled())
+                                return {};
+                            call->signal.wait_for(lock, std::chrono::milliseconds(10));
+                        }
+                    }
+                    else
+                    {
+                        call->signal.wait(lock, [&]() { return call->done; });
+                    }
+
+                    if (call->error)
+                        std::rethrow_exception(call->error);
+
+                    return call->result;
+                }
+            }
+
+            //! Number of calls currently in flight
+            std::size_t size() const
+            {
+                std::scoped_lock lock(_mutex);
+                return _calls.size();
+            }
+
+        private:
+            struct Call
+            {
+                std::mutex mutex;
+                std::condition_variable signal;
+                bool done = false;
+                std::optional<V> result;
+                std::exception_ptr error;
+            };
+
+            mutable std::mutex _mutex;
+            std::unordered_map<K, std::shared_ptr<Call>, HASH> _calls;
+        };
     }
 
 } // namepsace rocky::util
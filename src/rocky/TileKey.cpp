@@ -42,6 +42,31 @@ TileKey::TileKey(unsigned level_, unsigned x_, unsigned y_, const Profile& profi
     //NOP
 }
 
+TileKey::TileKey(const TileID& id) :
+    level(0), x(0), y(0)
+{
+    if (id.valid())
+    {
+        level = id.level();
+        x = id.x();
+        y = id.y();
+        profile = Profile::interned(id.profileID());
+    }
+}
+
+TileID
+TileKey::id() const
+{
+    if (!valid() || level > TileID::maxLevel || x > TileID::maxXY || y > TileID::maxXY)
+        return {};
+
+    auto profileID = profile.internedID();
+    if (profileID > TileID::maxProfileID)
+        return {};
+
+    return TileID(profileID, level, x, y);
+}
+
 GeoExtent
 TileKey::extent() const
 {
@@ -15,6 +15,45 @@ namespace ROCKY_NAMESPACE
 {
     class GeoPoint;
 
+    /**
+     * Compact stand-in for a TileKey that packs the profile, level, x and y into
+     * 64 bits. It is trivial to copy, compare and hash, which makes it a better
+     * key than TileKey for tile tables and caches that hold many tiles.
+     *
+     * Packing limits: level <= 31, x and y < 2^26 (level 25 of a two-tile-wide
+     * global profile), and the first 127 profiles interned by the process.
+     * TileKey::id() returns an invalid TileID for a key beyond those limits.
+     */
+    struct TileID
+    {
+        std::uint64_t value = ~std::uint64_t(0);
+
+        static constexpr unsigned maxProfileID = 126;
+        static constexpr unsigned maxLevel = 31;
+        static constexpr unsigned maxXY = (1u << 26) - 1;
+
+        //! Constructs an invalid ID
+        TileID() = default;
+
+        //! Packs the components of a tile key. Caller must respect the limits.
+        inline TileID(unsigned profileID, unsigned level, unsigned x, unsigned y) :
+            value(
+                ((std::uint64_t)profileID << 57) |
+                ((std::uint64_t)level << 52) |
+                ((std::uint64_t)x << 26) |
+                (std::uint64_t)y) { }
+
+        inline bool valid() const { return value != ~std::uint64_t(0); }
+        inline unsigned profileID() const { return (unsigned)(value >> 57); }
+        inline unsigned level() const { return (unsigned)(value >> 52) & 0x1f; }
+        inline unsigned x() const { return (unsigned)(value >> 26) & maxXY; }
+        inline unsigned y() const { return (unsigned)value & maxXY; }
+
+        inline bool operator == (const TileID& rhs) const { return value == rhs.value; }
+        inline bool operator != (const TileID& rhs) const { return value != rhs.value; }
+        inline bool operator < (const TileID& rhs) const { return value < rhs.value; }
+    };
+
     /**
      * Uniquely identifies a single tile on the map, relative to a Profile.
      * Profiles have an origin of 0,0 at the top left.
@@ -42,6 +81,14 @@ namespace ROCKY_NAMESPACE
         //! @param profile The profile for the tile
         TileKey(unsigned level, unsigned tile_x, unsigned tile_y, const Profile& profile);
 
+        //! Recreates the key that a TileID stands for
+        //! @param id Compact ID obtained from TileKey::id()
+        explicit TileKey(const TileID& id);
+
+        //! Compact ID for this key, suitable for hash tables
+        //! @return The ID, or an invalid TileID if the key is invalid or exceeds the packing limits
+        TileID id() const;
+
         //! Compare two tilekeys for equality.
         inline bool operator == (const TileKey& rhs) const {
             return
@@ -137,3 +184,30 @@ namespace ROCKY_NAMESPACE
         std::vector<TileKey> intersectingKeys(const Profile& profile) const;
     };
 }
+
+namespace std {
+    // std::hash specialization for TileID
+    template<> struct hash<rocky::TileID> {
+        inline size_t operator()(const rocky::TileID& value) const {
+            // splitmix64 finalizer, so neighboring tiles spread across buckets
+            std::uint64_t z = value.value + 0x9e3779b97f4a7c15ull;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return (size_t)(z ^ (z >> 31));
+        }
+    };
+
+    // std::hash specialization for TileKey
+    template<> struct hash<rocky::TileKey> {
+        inline size_t operator()(const rocky::TileKey& value) const {
+            auto id = value.id();
+            if (!id.valid())
+            {
+                // beyond the TileID packing limits; fold the key into 64 bits instead
+                id.value = (std::uint64_t)std::hash<rocky::Profile>()(value.profile) ^
+                    ((std::uint64_t)value.level << 58) ^ ((std::uint64_t)value.x << 29) ^ (std::uint64_t)value.y;
+            }
+            return std::hash<rocky::TileID>()(id);
+        }
+    };
+}
@@ -39,6 +39,7 @@ TileLayer::construct(std::string_view conf)
     get_to(j, "maxDataLevel", maxDataLevel);
     get_to(j, "minLevel", minLevel);
     get_to(j, "tileSize", tileSize);
+    get_to(j, "maxReprojectionError", maxReprojectionError);
     get_to(j, "profile", _originalProfile);        
 }
 
@@ -50,6 +51,7 @@ TileLayer::to_json() const
     set(j, "maxDataLevel", maxDataLevel);
     set(j, "minLevel", minLevel);
     set(j, "tileSize", tileSize);
+    set(j, "maxReprojectionError", maxReprojectionError);
     set(j, "profile", _originalProfile);
     return j.dump();
 }
@@ -319,19 +321,30 @@ TileLayer::mayHaveData(const TileKey& key) const
 Result<GeoImage>
 TileLayer::getOrCreateTile(const TileKey& key, const IOOptions& io, std::function<Result<GeoImage>()>&& create) const
 {
-    if (io.services().residentImageCache)
+    auto tileID = key.id();
+
+    // keys too deep to pack into a TileID skip the cache
+    if (io.services().residentImageCache && tileID.valid())
     {
-        auto cacheKey = key.str() + '-' + std::to_string(key.profile.hash()) + '-' + std::to_string(uid()) + "-" + std::to_string(revision());
+        TileCacheKey cacheKey{ tileID, uid(), revision() };
 
         auto cached = io.services().residentImageCache->get(cacheKey);
         if (cached.has_value())
+        {
+            if (io.retainer)
+                io.retainer->retain(cached.value().first);
+
             return GeoImage(cached.value().first, cached.value().second);
+        }
 
         auto r = create();
 
         if (r.ok())
         {
             io.services().residentImageCache->put(cacheKey, r.value().image(), r.value().extent());
+
+            if (io.retainer)
+                io.retainer->retain(r.value().image());
         }
 
         return r;
@@ -40,6 +40,10 @@ namespace ROCKY_NAMESPACE
         //! The extent to which the layer should be cropped.
         option<GeoExtent> crop;
 
+        //! Maximum error (in source pixels) to allow when approximating a reprojection
+        //! to the map profile. Zero reprojects every pixel exactly, which is much slower.
+        option<float> maxReprojectionError = 0.125f;
+
         //! Tiling profile and SRS or the layer.
         Profile profile;
 
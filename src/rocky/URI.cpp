@@ -8,12 +8,17 @@
 #include "URI.h"
 #include "Utils.h"
 #include "Context.h"
+#include "DiskCache.h"
 #include "Version.h"
 #include "json.h"
 
+#include <condition_variable>
 #include <fstream>
+#include <iomanip>
 #include <sstream>
 #include <random>
+#include <ctime>
+#include <unordered_map>
 
 #ifdef ROCKY_HAS_HTTPLIB
     #ifdef ROCKY_HAS_OPENSSL
@@ -162,6 +167,56 @@ namespace
         return {};
     }
 
+    // Days since 1970-01-01 for a civil date (proleptic Gregorian).
+    // http://howardhinnant.github.io/date_algorithms.html#days_from_civil
+    std::int64_t days_from_civil(std::int64_t y, unsigned m, unsigned d)
+    {
+        y -= m <= 2;
+        const std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+        const unsigned yoe = (unsigned)(y - era * 400);
+        const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + (std::int64_t)doe - 719468;
+    }
+
+    // How long a response may be cached, according to its HTTP headers.
+    // Returns nothing if the headers do not say.
+    std::optional<std::chrono::seconds> cacheLifetime(const std::vector<KeyValuePair>& headers)
+    {
+        auto cc = util::toLower(findHeader(headers, "Cache-Control"));
+        if (!cc.empty())
+        {
+            // we don't revalidate, so "no-cache" is the same as "no-store" for us.
+            if (cc.find("no-store") != std::string::npos || cc.find("no-cache") != std::string::npos)
+                return std::chrono::seconds(0);
+
+            auto pos = cc.find("max-age=");
+            if (pos != std::string::npos)
+                return std::chrono::seconds(std::max(0ll, std::atoll(cc.c_str() + pos + 8)));
+        }
+
+        // e.g. "Wed, 21 Oct 2015 07:28:00 GMT"
+        auto expires = findHeader(headers, "Expires");
+        if (!expires.empty())
+        {
+            std::tm tm = {};
+            std::istringstream in(expires);
+            in >> std::get_time(&tm, "%a, %d %b %Y %H:%M:%S");
+            if (in.fail())
+                return std::chrono::seconds(0); // invalid dates mean "already expired"
+
+            auto t = days_from_civil(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday) * 86400 +
+                tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec;
+
+            auto now = std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+
+            return std::chrono::seconds(std::max((std::int64_t)0, (std::int64_t)t - (std::int64_t)now));
+        }
+
+        return {};
+    }
+
     bool split_url(
         const std::string& url,
         std::string& proto_host_port,
@@ -250,8 +305,72 @@ namespace
         }
     };
 
+    /**
+    * Caps the number of simultaneous curl requests to any one host, the way
+    * the httplib client pool caps its connections.
+    */
+    class CURLHostLimit
+    {
+    public:
+        unsigned maxRequestsPerHost = 8u;
+
+        //! Wait for a free slot for the host. Returns false if canceled while waiting.
+        bool acquire(const std::string& proto_host_port, const IOOptions& io)
+        {
+            std::unique_lock lock(_mutex);
+            auto& active = _active[proto_host_port];
+            while (active >= maxRequestsPerHost)
+            {
+                if (io.canceled())
+                    return false;
+                _available.wait_for(lock, 100ms);
+            }
+            ++active;
+            return true;
+        }
+
+        void release(const std::string& proto_host_port)
+        {
+            {
+                std::scoped_lock lock(_mutex);
+                --_active[proto_host_port];
+            }
+            _available.notify_all();
+        }
+
+    private:
+        std::mutex _mutex;
+        std::condition_variable _available;
+        std::unordered_map<std::string, unsigned> _active;
+    };
+
+    CURLHostLimit& curlHostLimit()
+    {
+        static CURLHostLimit limit;
+        static std::once_flag init;
+        std::call_once(init, []()
+            {
+                auto value = util::getEnvVar("ROCKY_HTTP_MAX_CONNECTIONS_PER_HOST");
+                if (value.has_value())
+                    limit.maxRequestsPerHost = std::max(1u, (unsigned)std::atoi(value->c_str()));
+            });
+        return limit;
+    }
+
     Result<HTTPResponse> http_get_curl(const HTTPRequest& request, const IOOptions& io)
     {
+        std::string proto_host_port, path, query_text;
+        if (!split_url(request.url, proto_host_port, path, query_text))
+            return Failure_ConfigurationError;
+
+        if (!curlHostLimit().acquire(proto_host_port, io))
+            return Failure_OperationCanceled;
+
+        struct Release {
+            const std::string& key;
+            ~Release() { curlHostLimit().release(key); }
+        } release{ proto_host_port };
+
         // use thread-local clients for connection reuse.
         static thread_local struct Basket {
             CURL* handle = nullptr;
@@ -386,6 +505,99 @@ namespace
 #endif
 
 #ifdef ROCKY_HAS_HTTPLIB
+    /**
+    * Keep-alive httplib clients shared by all threads, keyed by scheme://host:port.
+    * Each client owns one connection, so a thread that alternates between hosts
+    * reuses an open connection instead of reconnecting (and re-handshaking TLS).
+    * The number of simultaneous connections to any one host is capped.
+    */
+    class HTTPClientPool
+    {
+    public:
+        unsigned maxConnectionsPerHost = 8u;
+        std::atomic_uint64_t created = { 0u };
+        std::atomic_uint64_t reused = { 0u };
+
+        //! Take a client for the host, waiting if the host is at its connection limit.
+        //! Returns nullptr if the operation is canceled while waiting.
+        std::unique_ptr<httplib::Client> acquire(const std::string& proto_host_port, const IOOptions& io)
+        {
+            std::unique_lock lock(_mutex);
+            auto& host = _hosts[proto_host_port];
+
+            while (host.active >= maxConnectionsPerHost)
+            {
+                if (io.canceled())
+                    return nullptr;
+                _available.wait_for(lock, 100ms);
+            }
+
+            ++host.active;
+
+            if (!host.idle.empty())
+            {
+                auto client = std::move(host.idle.back());
+                host.idle.pop_back();
+                ++reused;
+                return client;
+            }
+
+            lock.unlock();
+
+            auto client = std::make_unique<httplib::Client>(proto_host_port);
+
+            // follow redirects
+            client->set_follow_location(true);
+
+            // disable cert verification
+            client->enable_server_certificate_verification(false);
+            //client->enable_server_hostname_verification(false);
+
+            // ask the server to keep the connection alive
+            client->set_keep_alive(true);
+
+            ++created;
+            return client;
+        }
+
+        //! Return a client to the pool (or pass nullptr to discard it).
+        void release(const std::string& proto_host_port, std::unique_ptr<httplib::Client> client)
+        {
+            {
+                std::scoped_lock lock(_mutex);
+                auto& host = _hosts[proto_host_port];
+                --host.active;
+                if (client)
+                    host.idle.emplace_back(std::move(client));
+            }
+            _available.notify_all();
+        }
+
+    private:
+        struct Host
+        {
+            std::vector<std::unique_ptr<httplib::Client>> idle;
+            unsigned active = 0u;
+        };
+
+        std::mutex _mutex;
+        std::condition_variable _available;
+        std::unordered_map<std::string, Host> _hosts;
+    };
+
+    HTTPClientPool& httpClientPool()
+    {
+        static HTTPClientPool pool;
+        static std::once_flag init;
+        std::call_once(init, []()
+            {
+                auto value = util::getEnvVar("ROCKY_HTTP_MAX_CONNECTIONS_PER_HOST");
+                if (value.has_value())
+                    pool.maxConnectionsPerHost = std::max(1u, (unsigned)std::atoi(value->c_str()));
+            });
+        return pool;
+    }
+
     Result<HTTPResponse> http_get_httplib(const HTTPRequest& request, const IOOptions& io)
     {
         httplib::Headers headers;
@@ -413,30 +625,24 @@ namespace
 
         HTTPResponse response;
 
-        try
-        {
-            // use thread-local clients so we can do keep-alive for high performance
-            static thread_local httplib::Client client("");
-            static thread_local std::string last_proto_host_port;
-
-            if (proto_host_port != last_proto_host_port)
-            {
-                client = httplib::Client(proto_host_port);
-                last_proto_host_port = proto_host_port;
-            }
+        // borrow a pooled keep-alive client for this host; it goes back to the
+        // pool when we're done (including on error).
+        auto& pool = httpClientPool();
+        auto client = pool.acquire(proto_host_port, io);
+        if (!client)
+            return Failure_OperationCanceled;
 
-            // follow redirects
-            client.set_follow_location(true);
-
-            // disable cert verification
-            client.enable_server_certificate_verification(false);
-            //client.enable_server_hostname_verification(false);
-
-            // ask the server to keep the connection alive
-            client.set_keep_alive(true);
+        struct Lease {
+            HTTPClientPool& pool;
+            const std::string& key;
+            std::unique_ptr<httplib::Client>& client;
+            ~Lease() { pool.release(key, std::move(client)); }
+        } lease{ pool, proto_host_port, client };
 
+        try
+        {
             // connection timeout
-            client.set_connection_timeout((time_t)io.networkConnectionTimeout.count());
+            client->set_connection_timeout((time_t)io.networkConnectionTimeout.count());
 
             unsigned max_attempts = std::max(1u, io.maxNetworkAttempts);
 
@@ -458,7 +664,7 @@ namespace
                     return Failure_OperationCanceled;
                 
                 auto t0 = std::chrono::steady_clock::now();
-                auto res = client.Get(path, params, headers, progress);
+                auto res = client->Get(path, params, headers, progress);
                 auto t1 = std::chrono::steady_clock::now();
 
                 if (res) // means we got a response form the server
@@ -568,10 +774,84 @@ namespace
         return Failure(Failure::ServiceUnavailable, "HTTP not supported without curl or httplib");
 #endif
     }
+
+    // Caps the number of network requests in flight across all threads.
+    class HTTPLimit
+    {
+    public:
+        unsigned maxRequests = 16u;
+
+        //! Wait for a free slot. Returns false if canceled while waiting.
+        bool acquire(const IOOptions& io)
+        {
+            std::unique_lock lock(_mutex);
+            while (_active >= maxRequests)
+            {
+                if (io.canceled())
+                    return false;
+                _available.wait_for(lock, 100ms);
+            }
+            ++_active;
+            return true;
+        }
+
+        void release()
+        {
+            {
+                std::scoped_lock lock(_mutex);
+                --_active;
+            }
+            _available.notify_one();
+        }
+
+    private:
+        std::mutex _mutex;
+        std::condition_variable _available;
+        unsigned _active = 0u;
+    };
+
+    HTTPLimit& httpLimit()
+    {
+        static HTTPLimit limit;
+        static std::once_flag init;
+        std::call_once(init, []()
+            {
+                // same budget as the I/O pool (ROCKY_IO_CONCURRENCY)
+                limit.maxRequests = std::max(1u, detail::ioPool()->concurrency());
+            });
+        return limit;
+    }
+
+    // Makes the request on the calling thread once fewer than the I/O pool's
+    // thread count are in flight. It must not hop to the pool: the caller may
+    // lead a shared read (Services::uriReads) that I/O threads are waiting on,
+    // and with all of them waiting, a queued fetch would never run.
+    Result<HTTPResponse> http_get_limited(const HTTPRequest& request, const IOOptions& io)
+    {
+        if (!httpLimit().acquire(io))
+            return Failure_OperationCanceled;
+
+        struct Release {
+            ~Release() { httpLimit().release(); }
+        } release;
+
+        return http_get(request, io);
+    }
 }
 
 //------------------------------------------------------------------------
 
+URI::ConnectionStats
+URI::connectionStats()
+{
+    ConnectionStats stats;
+#ifdef ROCKY_HAS_HTTPLIB
+    stats.created = httpClientPool().created;
+    stats.reused = httpClientPool().reused;
+#endif
+    return stats;
+}
+
 URI::Stream::Stream(std::shared_ptr<std::istream> s) :
     _in(s)
 {
@@ -673,9 +953,6 @@ URI::findRotation()
 
 auto URI::read(const IOOptions& io) const -> Result<URIResponse>
 {
-    // protect against multiple threads trying to read the same URI at the same time
-    detail::ScopedGate<std::string> gate(io.services().uriGate, full());
-
     if (io.services().contentCache)
     {
         auto cached = io.services().contentCache->get(full());
@@ -687,6 +964,38 @@ auto URI::read(const IOOptions& io) const -> Result<URIResponse>
         }
     }
 
+    // If another thread is already reading this URI, wait for its result
+    // instead of reading it again.
+    for (;;)
+    {
+        bool joined = false;
+        auto result = io.services().uriReads.run(full(), [&]() { return readUncached(io); }, &joined, &io);
+
+        // canceled while waiting on the other thread
+        if (!result.has_value())
+            return Failure_OperationCanceled;
+
+        // if the thread we joined was canceled, that doesn't mean we were;
+        // try again ourselves.
+        if (joined && result->failed() && result->error().type == Failure::OperationCanceled && !io.canceled())
+            continue;
+
+        return std::move(result.value());
+    }
+}
+
+auto URI::readAsync(const IOOptions& io) const -> jobs::future<Result<URIResponse>>
+{
+    auto read = [uri(*this), io](Cancelable& c)
+        {
+            return uri.read(io.with(c));
+        };
+
+    return jobs::dispatch(read, jobs::context{ full(), detail::ioPool() });
+}
+
+auto URI::readUncached(const IOOptions& io) const -> Result<URIResponse>
+{
     Content content;
 
     // check the dead pool, if available.
@@ -698,6 +1007,24 @@ auto URI::read(const IOOptions& io) const -> Result<URIResponse>
         }
     }
 
+    // check the persistent cache, if available.
+    if (io.services().diskCache && isRemote())
+    {
+        if (auto cached = io.services().diskCache->get(full()))
+        {
+            if (io.services().contentCache)
+            {
+                io.services().contentCache->put(full(), Result<Content>(cached.value()));
+            }
+
+            Result<URIResponse> result(cached.value());
+            result->fromCache = true;
+            return result;
+        }
+    }
+
+    std::optional<std::chrono::seconds> ttl;
+
     auto t0 = std::chrono::steady_clock::now();
 
     if (std::filesystem::exists(full()))
@@ -738,7 +1065,7 @@ auto URI::read(const IOOptions& io) const -> Result<URIResponse>
         }
 
         // make the actual request:
-        auto r = http_get(request, io);
+        auto r = http_get_limited(request, io);
 
         if (r.failed())
         {
@@ -765,8 +1092,11 @@ auto URI::read(const IOOptions& io) const -> Result<URIResponse>
             contentType = inferContentTypeFromFileExtension(url_path);
         }
 
+        ttl = cacheLifetime(r.value().headers);
+
         content.type = std::move(contentType);
         content.data = std::move(r.value().data);
+        content.timestamp = std::chrono::system_clock::now();
     }
     else
     {
@@ -780,6 +1110,11 @@ auto URI::read(const IOOptions& io) const -> Result<URIResponse>
         io.services().contentCache->put(full(), Result<Content>(content));
     }
 
+    if (io.services().diskCache && isRemote())
+    {
+        io.services().diskCache->put(full(), content, ttl.value_or(io.services().diskCache->defaultTTL));
+    }
+
     return URIResponse(content, t1 - t0);
 }
 
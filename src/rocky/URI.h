@@ -71,6 +71,16 @@ namespace ROCKY_NAMESPACE
         //! Whether HTTPS support is available
         static bool supportsHTTPS();
 
+        //! HTTP connection statistics
+        struct ConnectionStats
+        {
+            std::uint64_t created = 0u; // new connections opened
+            std::uint64_t reused = 0u;  // requests served on an existing keep-alive connection
+        };
+
+        //! Statistics on HTTP connection reuse across all requests
+        static ConnectionStats connectionStats();
+
         //! Holds a stream for reading content data.
         struct ROCKY_EXPORT Stream
         {
@@ -132,6 +142,10 @@ namespace ROCKY_NAMESPACE
         //! Reads the URI into a data buffer
         Result<URIResponse> read(const IOOptions& io) const;
 
+        //! Reads the URI in the background on the shared I/O job pool.
+        //! The read is canceled if the returned future goes out of scope.
+        jobs::future<Result<URIResponse>> readAsync(const IOOptions& io) const;
+
     public:
 
         bool operator < (const URI& rhs) const { 
@@ -164,6 +178,9 @@ namespace ROCKY_NAMESPACE
 
         void set(std::string_view location, const URI::Context& context);
         void findRotation();
+
+        //! Reads the URI from the deadpool, disk cache, filesystem or network
+        Result<URIResponse> readUncached(const IOOptions& io) const;
     };
 
     /**
@@ -423,6 +423,46 @@ namespace ROCKY_NAMESPACE
 
 
 
+        /**
+        * Read-only stream buffer over memory owned by someone else.
+        */
+        class membuf : public std::streambuf
+        {
+        public:
+            membuf(const char* data, std::size_t size) {
+                auto p = const_cast<char*>(data);
+                setg(p, p, p + size);
+            }
+
+        protected:
+            pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+                auto base = dir == std::ios_base::beg ? eback() : dir == std::ios_base::cur ? gptr() : egptr();
+                auto p = base + off;
+                if (!(which & std::ios_base::in) || p < eback() || p > egptr())
+                    return pos_type(off_type(-1));
+                setg(eback(), p, egptr());
+                return pos_type(p - eback());
+            }
+
+            pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+                return seekoff(off_type(pos), std::ios_base::beg, which);
+            }
+        };
+
+        /**
+        * Input stream that reads a string in place. Unlike std::istringstream
+        * it does not copy the string, which must outlive the stream.
+        */
+        class imemstream : private membuf, public std::istream
+        {
+        public:
+            imemstream(const char* data, std::size_t size) :
+                membuf(data, size), std::istream(static_cast<membuf*>(this)) { }
+
+            explicit imemstream(const std::string& str) :
+                imemstream(str.data(), str.size()) { }
+        };
+
         /**
         * Virtual interface for a stream compressor
         */
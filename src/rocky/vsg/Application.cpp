@@ -504,6 +504,15 @@ Application::frame()
         stats.record = std::chrono::duration_cast<std::chrono::microseconds>(t_present - t_record);
         stats.present = std::chrono::duration_cast<std::chrono::microseconds>(t_end - t_present);
 
+        auto updateStats = vsgcontext->updateStats();
+        stats.updateQueue = updateStats.pending;
+        stats.updatesRun = updateStats.ran;
+        stats.updateBudgetUsed = updateStats.used;
+
+        auto uploadStats = vsgcontext->uploadStats();
+        stats.uploadBytes = uploadStats.queued;
+        stats.streamBytes = uploadStats.streamed;
+
         _framesSinceLastRender = 0;
     }
 
@@ -136,6 +136,18 @@ namespace ROCKY_NAMESPACE
             std::chrono::microseconds present;
             double memory;
 
+            //! Prioritized update operations (like terrain tile merges) still waiting
+            std::size_t updateQueue = 0;
+
+            //! Prioritized update operations that ran this frame
+            std::size_t updatesRun = 0;
+
+            //! Time they took, out of the VSGContext::updateBudget
+            std::chrono::microseconds updateBudgetUsed;
+
+            //! Bytes sent to the GPU in the last frame, queued and streamed
+            std::size_t uploadBytes = 0;
+            std::size_t streamBytes = 0;
         };
         Stats stats;
 
@@ -230,13 +230,6 @@ DisplayManager::addWindow(vsg::ref_ptr<vsg::Window> window, vsg::ref_ptr<vsg::Vi
     vsgcontext->viewer()->addWindow(window);
     vsgcontext->viewer()->addRecordAndSubmitTaskAndPresentation({ commandgraph });
 
-    // Tell Rocky it needs to mutex-protect the terrain engine
-    // now that we have more than one window.
-    if (_app && vsgcontext->viewer()->windows().size() > 1)
-    {
-        _app->mapNode->terrainSettings().supportMultiThreadedRecord = true;
-    }
-
     // install the debug layer if requested
     if (_app && _app->_debuglayer && !_debugCallbackInstalled)
     {
@@ -340,6 +333,21 @@ DisplayManager::addWindow(vsg::ref_ptr<vsg::WindowTraits> traits)
 
         if (supportedDS3.extendedDynamicState3ColorWriteMask)
             ds3.extendedDynamicState3ColorWriteMask = VK_TRUE;
+
+        // block-compressed textures (see TerrainSettings::textureCompression)
+        if (physicalDevice->getFeatures().textureCompressionBC)
+            traits->deviceFeatures->get().textureCompressionBC = VK_TRUE;
+
+        // texture arrays indexed per tile (see TerrainSettings::tileTableSize)
+        if (physicalDevice->getFeatures().shaderSampledImageArrayDynamicIndexing)
+            traits->deviceFeatures->get().shaderSampledImageArrayDynamicIndexing = VK_TRUE;
+
+        // batched lines (see LineSystemNode::minBatchSize)
+        if (physicalDevice->getFeatures().multiDrawIndirect)
+            traits->deviceFeatures->get().multiDrawIndirect = VK_TRUE;
+
+        if (physicalDevice->getFeatures().drawIndirectFirstInstance)
+            traits->deviceFeatures->get().drawIndirectFirstInstance = VK_TRUE;
     }
     else
     {
@@ -660,6 +668,7 @@ DisplayManager::setManipulatorForView(vsg::ref_ptr<MapManipulator> manip, vsg::r
 
     // stow this away in the view object so it's easy to find later.
     manip->put(view);
+    manip->viewID = view->viewID;
 
     // The manipulators (one for each view) need to be in the right order (top to bottom)
     // so that overlapping views don't get mixed up. To accomplish this we'll just
@@ -683,6 +683,8 @@ MapManipulator::setViewpoint(const Viewpoint& vp, std::chrono::duration<float> d
             if (fabs(_state.setVPAccel) < 1.0) _state.setVPAccel = 0.0;
         }
 
+        publishTransitionPath();
+
 #if 0
         // Adjust the duration if necessary.
         if (settings.getAutoViewpointDurationEnabled())
@@ -725,6 +727,110 @@ MapManipulator::setViewpoint(const Viewpoint& vp, std::chrono::duration<float> d
     _task._type = TASK_NONE;
 }
 
+// computes the camera pose at time fraction "t" [0..1] of a viewpoint transition,
+// and returns the eased interpolation coefficient.
+double
+MapManipulator::transitionPose(double t, vsg::dvec3& center, double& azim, double& pitch, double& range, vsg::dvec3& offset) const
+{
+    auto mapNode = getMapNode();
+    if (!mapNode) return 0.0;
+
+    // Start point is the current manipulator center:
+    auto p0 = _state.setVP0->position().transform(mapNode->srs());
+    vsg::dvec3 startWorld(p0.x, p0.y, p0.z);
+
+    // End point is the world coordinates of the target viewpoint:
+    auto p1 = _state.setVP1->position().transform(mapNode->srs());
+    vsg::dvec3 endWorld(p1.x, p1.y, p1.z);
+
+    double tp = t;
+
+    if (_state.setVPArcHeight > 0.0 )
+    {
+        if ( tp <= 0.5 )
+        {
+            double t2 = 2.0*tp;
+            tp = 0.5*t2;
+        }
+        else
+        {
+            double t2 = 2.0*(tp-0.5);
+            tp = 0.5+(0.5*t2);
+        }
+
+        // the more smoothsteps you do, the more pronounced the fade-in/out effect
+        smoothStepInterp( tp );
+    }
+    else if ( t > 0.0 )
+    {
+        tp = smoothStepInterp( tp );
+    }
+
+    center =
+        mapNode->srs().isGeocentric() ? nlerp(startWorld, endWorld, tp) :
+        lerp(startWorld, endWorld, tp);
+
+    // Calculate the delta-heading, and make sure we are going in the shortest direction:
+    Angle d_azim = _state.setVP1->heading.value() - _state.setVP0->heading.value();
+    if ( d_azim.as(Units::RADIANS) > M_PI )
+        d_azim = d_azim - Angle(2.0*M_PI, Units::RADIANS);
+    else if ( d_azim.as(Units::RADIANS) < -M_PI )
+        d_azim = d_azim + Angle(2.0*M_PI, Units::RADIANS);
+    azim = _state.setVP0->heading->as(Units::RADIANS) + tp*d_azim.as(Units::RADIANS);
+
+    // Calculate the new pitch:
+    Angle d_pitch = _state.setVP1->pitch.value() - _state.setVP0->pitch.value();
+    pitch = _state.setVP0->pitch->as(Units::RADIANS) + tp*d_pitch.as(Units::RADIANS);
+
+    // Calculate the new range:
+    Distance d_range = _state.setVP1->range.value() - _state.setVP0->range.value();
+    range =
+        _state.setVP0->range->as(Units::METERS) +
+        d_range.as(Units::METERS)*tp + sin(M_PI*tp)* _state.setVPArcHeight;
+
+    // Calculate the offsets
+    vsg::dvec3 offset0 = to_vsg(_state.setVP0->positionOffset.value_or(glm::dvec3{ 0,0,0 }));
+    vsg::dvec3 offset1 = to_vsg(_state.setVP1->positionOffset.value_or(glm::dvec3{ 0,0,0 }));
+    offset = offset0 + (offset1-offset0)*tp;
+
+    return tp;
+}
+
+void
+MapManipulator::publishTransitionPath()
+{
+    auto mapNode = getMapNode();
+    if (!mapNode || !mapNode->terrainNode) return;
+
+    // the transition starts on the next frame
+    auto start = std::chrono::duration<double>(_previousTime.time_since_epoch()).count();
+    auto duration = (double)_state.setVPDuration.count();
+
+    const unsigned segments = 16;
+    std::vector<CameraPredictor::Waypoint> path;
+    path.reserve(segments + 1);
+
+    for (unsigned i = 0; i <= segments; ++i)
+    {
+        double t = (double)i / (double)segments;
+
+        vsg::dvec3 center, offset;
+        double azim, pitch, range;
+        transitionPose(t, center, azim, pitch, range, offset);
+
+        // same transform as updateCamera, less the offsets and tethering
+        vsg::dmat4 frame;
+        createLocalCoordFrame(center, frame);
+        frame[3][0] = frame[3][1] = frame[3][2] = 0.0;
+
+        auto eye = center + frame * (vsg::rotate(getQuaternion(azim, pitch)) * vsg::dvec3(0.0, 0.0, range));
+        path.emplace_back(CameraPredictor::Waypoint{ eye, start + t * duration });
+    }
+
+    mapNode->terrainNode->cameraPredictor(viewID).setPath(path);
+    _publishedPath = true;
+}
+
 // returns "t" [0..1], the interpolation coefficient.
 double
 MapManipulator::setViewpointFrame(const vsg::time_point& now)
@@ -739,14 +845,6 @@ MapManipulator::setViewpointFrame(const vsg::time_point& now)
     }
     else
     {
-        // Start point is the current manipulator center:
-        auto p0 = _state.setVP0->position().transform(mapNode->srs());
-        vsg::dvec3 startWorld(p0.x, p0.y, p0.z);
-
-        // End point is the world coordinates of the target viewpoint:
-        auto p1 = _state.setVP1->position().transform(mapNode->srs());
-        vsg::dvec3 endWorld(p1.x, p1.y, p1.z);
-
         // Remaining time is the full duration minus the time since initiation:
         auto elapsed = std::chrono::duration_cast<std::chrono::duration<float>>(
             now - _state.setVPStartTime.value());
@@ -756,55 +854,9 @@ MapManipulator::setViewpointFrame(const vsg::time_point& now)
         double t = (double)elapsed.count() / (double)duration.count();
         t = std::min(t, 1.0);
 
-        double tp = t;
-
-        if (_state.setVPArcHeight > 0.0 )
-        {
-            if ( tp <= 0.5 )
-            {
-                double t2 = 2.0*tp;
-                tp = 0.5*t2;
-            }
-            else
-            {
-                double t2 = 2.0*(tp-0.5);
-                tp = 0.5+(0.5*t2);
-            }
-
-            // the more smoothsteps you do, the more pronounced the fade-in/out effect
-            smoothStepInterp( tp );
-        }
-        else if ( t > 0.0 )
-        {
-            tp = smoothStepInterp( tp );
-        }
-
-        vsg::dvec3 newCenter =
-            mapNode->srs().isGeocentric() ? nlerp(startWorld, endWorld, tp) :
-            lerp(startWorld, endWorld, tp);
-
-        // Calculate the delta-heading, and make sure we are going in the shortest direction:
-        Angle d_azim = _state.setVP1->heading.value() - _state.setVP0->heading.value();
-        if ( d_azim.as(Units::RADIANS) > M_PI )
-            d_azim = d_azim - Angle(2.0*M_PI, Units::RADIANS);
-        else if ( d_azim.as(Units::RADIANS) < -M_PI )
-            d_azim = d_azim + Angle(2.0*M_PI, Units::RADIANS);
-        double newAzim = _state.setVP0->heading->as(Units::RADIANS) + tp*d_azim.as(Units::RADIANS);
-
-        // Calculate the new pitch:
-        Angle d_pitch = _state.setVP1->pitch.value() - _state.setVP0->pitch.value();
-        double newPitch = _state.setVP0->pitch->as(Units::RADIANS) + tp*d_pitch.as(Units::RADIANS);
-
-        // Calculate the new range:
-        Distance d_range = _state.setVP1->range.value() - _state.setVP0->range.value();
-        double newRange =
-            _state.setVP0->range->as(Units::METERS) +
-            d_range.as(Units::METERS)*tp + sin(M_PI*tp)* _state.setVPArcHeight;
-
-        // Calculate the offsets
-        vsg::dvec3 offset0 = to_vsg(_state.setVP0->positionOffset.value_or(glm::dvec3{ 0,0,0 }));
-        vsg::dvec3 offset1 = to_vsg(_state.setVP1->positionOffset.value_or(glm::dvec3{ 0,0,0 }));
-        vsg::dvec3 newOffset = offset0 + (offset1-offset0)*tp;
+        vsg::dvec3 newCenter, newOffset;
+        double newAzim, newPitch, newRange;
+        double tp = transitionPose(t, newCenter, newAzim, newPitch, newRange, newOffset);
 
         // Activate.
         //setLookAt(newCenter, newAzim, newPitch, newRange, newOffset);
@@ -1160,6 +1212,14 @@ MapManipulator::apply(vsg::FrameEvent& frame)
         setViewpointFrame(frame.time);
     }
 
+    // the transition finished or was interrupted
+    if (_publishedPath && !isSettingViewpoint())
+    {
+        if (auto mapNode = getMapNode())
+            mapNode->terrainNode->cameraPredictor(viewID).clearPath();
+        _publishedPath = false;
+    }
+
     if (isTethering())
     {
         updateTether(frame.time);
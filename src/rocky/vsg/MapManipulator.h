@@ -78,6 +78,10 @@ namespace ROCKY_NAMESPACE
             return _state.setVP1.has_value() && _state.setVP1->pointFunction;
         }
 
+        //! ID of the view (vsg::View::viewID) whose camera this manipulator
+        //! drives, so its transitions reach that view's tile prefetching
+        std::uint32_t viewID = 0;
+
         //! Store a reference to this manipulator in another object
         void put(vsg::ref_ptr<vsg::Object> object);
 
@@ -538,6 +542,9 @@ namespace ROCKY_NAMESPACE
         // rendering required b/c something changed.
         bool _dirty;
 
+        // the terrain is prefetching along a viewpoint transition
+        bool _publishedPath = false;
+
         bool withinRenderArea(const vsg::PointerEvent& pointerEvent) const;
 
         vsg::dvec2 ndc(const vsg::PointerEvent&) const;
@@ -548,6 +555,11 @@ namespace ROCKY_NAMESPACE
 
         double setViewpointFrame(const vsg::time_point&);
 
+        double transitionPose(double t, vsg::dvec3& center, double& azim, double& pitch, double& range, vsg::dvec3& offset) const;
+
+        //! tells the terrain where a viewpoint transition is headed so it can prefetch tiles
+        void publishTransitionPath();
+
         void updateTether(const vsg::time_point& t);
 
         //! returns true if the camera changed.
@@ -45,16 +45,20 @@ StreamingGPUBuffer::compile(vsg::Context& context)
         ssbo->offset = 0;
         ssbo->range = _data->dataSize();
 
-        // the CPU-mapped staging buffer:
-        staging = vsg::createBufferAndMemory(
-            context.device,
-            _data->dataSize(),
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            sharing_mode,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
         ssbo->buffer->compile(context);
-        staging->compile(context);
+
+        // the CPU-mapped staging buffer, unless we're sharing a ring:
+        if (!ring)
+        {
+            staging = vsg::createBufferAndMemory(
+                context.device,
+                _data->dataSize(),
+                VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                sharing_mode,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+            staging->compile(context);
+        }
 
         dirty_region = VkBufferCopy{ 0, 0, _data->dataSize() };
     }
@@ -65,6 +69,41 @@ StreamingGPUBuffer::record(vsg::CommandBuffer& commandBuffer) const
 {
     if (dirty_region.size > 0)
     {
+        const char* src = reinterpret_cast<const char*>(_data->dataPointer()) + dirty_region.srcOffset;
+
+        if (ring)
+        {
+            auto region = ring->reserve(commandBuffer.getDevice(), dirty_region.size);
+            if (region)
+            {
+                std::memcpy(region.data, src, dirty_region.size);
+
+                VkBufferCopy copy{ region.offset, dirty_region.dstOffset, dirty_region.size };
+
+                vkCmdCopyBuffer(
+                    commandBuffer,
+                    region.buffer->vk(commandBuffer.deviceID),
+                    ssbo->buffer->vk(commandBuffer.deviceID),
+                    1, &copy);
+
+                dirty_region = VkBufferCopy{ 0, 0, 0 };
+                return;
+            }
+        }
+
+        // no room in the ring this frame; fall back on a staging buffer of our own
+        if (!staging)
+        {
+            staging = vsg::createBufferAndMemory(
+                commandBuffer.getDevice(),
+                _data->dataSize(),
+                VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                sharing_mode,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+            ROCKY_SOFT_ASSERT_AND_RETURN(staging, void());
+        }
+
         auto* dm = staging->getDeviceMemory(commandBuffer.deviceID);
         if (dm)
         {
@@ -79,7 +118,6 @@ StreamingGPUBuffer::record(vsg::CommandBuffer& commandBuffer) const
             ROCKY_SOFT_ASSERT_AND_RETURN(result == 0, void());
 
             char* dst = reinterpret_cast<char*>(mapped_data);
-            const char* src = reinterpret_cast<const char*>(_data->dataPointer()) + dirty_region.srcOffset;
 
             std::memcpy(dst, src, dirty_region.size);
 
@@ -5,6 +5,7 @@
  */
 #pragma once
 #include <rocky/vsg/Common.h>
+#include <rocky/vsg/StagingRing.h>
 
 namespace ROCKY_NAMESPACE
 {
@@ -88,6 +89,8 @@ namespace ROCKY_NAMESPACE
 
     /**
     * A dynamic buffer that you can update on the GPU from CPU memory.
+    * Changes stream through the shared staging ring when one is set, and
+    * through a staging buffer of the object's own otherwise.
     */
     class ROCKY_EXPORT StreamingGPUBuffer : public vsg::Inherit<vsg::Command, StreamingGPUBuffer>
     {
@@ -98,6 +101,10 @@ namespace ROCKY_NAMESPACE
         //! The descriptor binding the SSBO to the binding point you specified in the constructor
         vsg::ref_ptr<vsg::DescriptorBuffer> descriptor;
 
+        //! Shared staging memory to stream through (optional; e.g. VSGContext::stagingRing).
+        //! Set it before the buffer compiles.
+        vsg::ref_ptr<StagingRing> ring;
+
         //! Construct a StreamingGPUBuffer
         //! @param binding The binding point for the buffer in the shader
         //! @param size The size of the buffer in bytes
@@ -134,7 +141,7 @@ namespace ROCKY_NAMESPACE
         vsg::ref_ptr<vsg::Data> _data;
         VkBufferUsageFlags usage_flags;
         VkSharingMode sharing_mode;
-        vsg::ref_ptr<vsg::Buffer> staging;
+        mutable vsg::ref_ptr<vsg::Buffer> staging;
         mutable VkBufferCopy dirty_region = VkBufferCopy{ 0, 0, 0 };
     };
 }
@@ -0,0 +1,99 @@
+/**
+ * rocky c++
+ * Copyright 2025 Pelican Mapping
+ * MIT License
+ */
+#include "StagingRing.h"
+#include <algorithm>
+
+#undef LC
+#define LC "[StagingRing] "
+
+using namespace ROCKY_NAMESPACE;
+
+StagingRing::StagingRing(VkDeviceSize size, unsigned framesInFlight) :
+    _partitions(std::max(framesInFlight, 1u))
+{
+    _partitionSize = size / _partitions;
+}
+
+StagingRing::~StagingRing()
+{
+    if (_memory && _mapped)
+    {
+        _memory->unmap();
+    }
+}
+
+StagingRing::Region
+StagingRing::reserve(vsg::Device* device, VkDeviceSize bytes, VkDeviceSize alignment)
+{
+    std::scoped_lock lock(_mutex);
+
+    if (!device || _failed || bytes == 0)
+        return {};
+
+    if (!_buffer)
+    {
+        _buffer = vsg::createBufferAndMemory(
+            device,
+            size(),
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_SHARING_MODE_EXCLUSIVE,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+        _memory = _buffer ? vsg::ref_ptr<vsg::DeviceMemory>(_buffer->getDeviceMemory(device->deviceID)) : nullptr;
+
+        void* mapped = nullptr;
+        if (!_memory || _memory->map(_buffer->getMemoryOffset(device->deviceID), size(), 0, &mapped) != VK_SUCCESS)
+        {
+            Log()->warn(LC "Failed to create a {} byte staging ring; streaming buffers will use their own", size());
+            _buffer = nullptr;
+            _memory = nullptr;
+            _failed = true;
+            return {};
+        }
+
+        _mapped = static_cast<char*>(mapped);
+        _device = device;
+    }
+
+    if (device != _device)
+        return {};
+
+    VkDeviceSize offset = alignment > 1 ? ((_used + alignment - 1) / alignment) * alignment : _used;
+
+    if (offset + bytes > _partitionSize)
+    {
+        ++_overflows;
+        return {};
+    }
+
+    _used = offset + bytes;
+
+    offset += _partition * _partitionSize;
+    return Region{ _buffer, offset, _mapped + offset };
+}
+
+void
+StagingRing::advance()
+{
+    std::scoped_lock lock(_mutex);
+    _partition = (_partition + 1) % _partitions;
+    _used = 0;
+    _overflows = 0;
+}
+
+VkDeviceSize
+StagingRing::reserved() const
+{
+    std::scoped_lock lock(_mutex);
+    return _used;
+}
+
+std::size_t
+StagingRing::overflows() const
+{
+    std::scoped_lock lock(_mutex);
+    return _overflows;
+}
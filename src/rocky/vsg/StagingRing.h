@@ -0,0 +1,88 @@
+/**
+ * rocky c++
+ * Copyright 2025 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+
+#include <rocky/vsg/Common.h>
+#include <mutex>
+
+namespace ROCKY_NAMESPACE
+{
+    /**
+     * Shared, persistently mapped staging memory for data streamed to the GPU
+     * every frame.
+     *
+     * The ring is one host-visible buffer split into a partition per frame in
+     * flight. Writers reserve space in the current frame's partition during
+     * the record traversal, copy their data straight into the mapped memory,
+     * and record a copy out of the ring. A partition is only reused once every
+     * frame that might still be reading it has finished, so writers never
+     * have to wait on the GPU or keep staging buffers of their own.
+     */
+    class ROCKY_EXPORT StagingRing : public vsg::Inherit<vsg::Object, StagingRing>
+    {
+    public:
+        //! Space reserved in the ring
+        struct Region
+        {
+            //! Ring buffer holding the region; null if the reservation failed
+            vsg::ref_ptr<vsg::Buffer> buffer;
+
+            //! Offset of the region in the buffer
+            VkDeviceSize offset = 0;
+
+            //! Mapped memory to write the region's data into
+            void* data = nullptr;
+
+            inline operator bool() const {
+                return buffer.valid();
+            }
+        };
+
+        //! Construct a staging ring.
+        //! @param size Total size of the ring in bytes
+        //! @param framesInFlight Number of partitions, at least the number of
+        //!   frames the GPU may still be working on when a new one is recorded
+        StagingRing(VkDeviceSize size, unsigned framesInFlight);
+
+        ~StagingRing();
+
+        //! Reserves space in the current frame's partition. Creates and maps
+        //! the ring on first use. Thread-safe.
+        //! @return the region, or an empty one if the partition is full or
+        //!   the ring is already in use on another device
+        Region reserve(vsg::Device* device, VkDeviceSize bytes, VkDeviceSize alignment = 16);
+
+        //! Moves on to the next frame's partition. Call once per frame, before
+        //! recording.
+        void advance();
+
+        //! Bytes reserved so far in the current frame
+        VkDeviceSize reserved() const;
+
+        //! Reservations that didn't fit so far in the current frame
+        std::size_t overflows() const;
+
+        //! Total size of the ring in bytes
+        inline VkDeviceSize size() const {
+            return _partitionSize * _partitions;
+        }
+
+    private:
+        VkDeviceSize _partitionSize = 0;
+        unsigned _partitions = 1;
+
+        mutable std::mutex _mutex;
+        unsigned _partition = 0;
+        VkDeviceSize _used = 0;
+        std::size_t _overflows = 0;
+        bool _failed = false;
+
+        vsg::ref_ptr<vsg::Buffer> _buffer;
+        vsg::ref_ptr<vsg::DeviceMemory> _memory;
+        vsg::Device* _device = nullptr;
+        char* _mapped = nullptr;
+    };
+}
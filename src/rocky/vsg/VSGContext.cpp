@@ -5,10 +5,13 @@
  */
 #include "VSGContext.h"
 #include "VSGUtils.h"
+#include <rocky/DiskCache.h>
 #include <rocky/Image.h>
 #include <rocky/URI.h>
 #include <rocky/GeoExtent.h>
+#include <algorithm>
 #include <filesystem>
+#include <iterator>
 
 #include <spdlog/sinks/stdout_color_sinks.h>
 
@@ -190,12 +193,13 @@ namespace
     }    
     
     /**
-    * An update operation that maintains a priroity queue for update tasks.
+    * An update operation that runs prioritized update tasks on a time budget.
     * This sits in the VSG viewer's update operations queue indefinitely
-    * and runs once per frame. It chooses the highest priority task in its
-    * queue and runs it. It will run one task per frame so that we do not
-    * risk frame drops. It will automatically discard any tasks that have
-    * been abandoned (no Future exists).
+    * and runs once per frame. Each frame it asks every pending task for its
+    * priority once, then runs tasks from the highest priority down until the
+    * budget is spent. It always runs at least one task so the queue keeps
+    * moving. It will automatically discard any tasks that have been
+    * abandoned (no Future exists).
     */
     struct PriorityUpdateQueue : public vsg::Inherit<vsg::Operation, PriorityUpdateQueue>
     {
@@ -204,52 +208,81 @@ namespace
         struct Task {
             vsg::ref_ptr<vsg::Operation> function;
             std::function<float()> get_priority;
+            float priority = 0.0f; // cached at the start of each run
         };
-        std::vector<Task> _queue;
 
-        // runs one task per frame.
+        // tasks queued since the last run
+        std::vector<Task> _incoming;
+
+        // tasks waiting to run, as a max-heap on the cached priority (update thread only)
+        std::vector<Task> _pending;
+
+        std::chrono::microseconds _budget = std::chrono::microseconds(2000);
+        VSGContextImpl::UpdateStats _stats;
+
+        static bool lowerPriority(const Task& lhs, const Task& rhs) {
+            return lhs.priority < rhs.priority;
+        }
+
+        static bool canceled(const Task& task) {
+            auto po = dynamic_cast<Cancelable*>(task.function.get());
+            return po != nullptr && po->canceled();
+        }
+
         void run() override
         {
-            if (!_queue.empty())
+            auto start = std::chrono::steady_clock::now();
+            std::chrono::microseconds budget;
             {
-                Task task;
-                {
-                    std::scoped_lock lock(_mutex);
-
-                    // sort from low to high priority
-                    std::sort(_queue.begin(), _queue.end(),
-                        [](const Task& lhs, const Task& rhs)
-                        {
-                            if (lhs.get_priority == nullptr)
-                                return false;
-                            else if (rhs.get_priority == nullptr)
-                                return true;
-                            else
-                                return lhs.get_priority() < rhs.get_priority();
-                        }
-                    );
-
-                    while (!_queue.empty())
-                    {
-                        // pop the highest priority off the back.
-                        task = _queue.back();
-                        _queue.pop_back();
-
-                        // check for cancelation - if the task is already canceled, 
-                        // discard it and fetch the next one.
-                        auto po = dynamic_cast<Cancelable*>(task.function.get());
-                        if (po == nullptr || !po->canceled())
-                            break;
-                        else
-                            task = { };
-                    }
-                }
+                std::scoped_lock lock(_mutex);
+                budget = _budget;
+                std::move(_incoming.begin(), _incoming.end(), std::back_inserter(_pending));
+                _incoming.clear();
+            }
 
-                if (task.function)
+            // Priorities drift as the camera moves, so refresh them once per frame,
+            // dropping any tasks canceled in the meantime. A task without a priority
+            // function goes first.
+            std::size_t count = 0;
+            for (auto& task : _pending)
+            {
+                if (!canceled(task))
                 {
-                    task.function->run();
+                    task.priority = task.get_priority ? task.get_priority() : FLT_MAX;
+                    if (&_pending[count] != &task)
+                        _pending[count] = std::move(task);
+                    ++count;
                 }
             }
+            _pending.resize(count);
+
+            std::make_heap(_pending.begin(), _pending.end(), lowerPriority);
+
+            std::size_t ran = 0;
+            while (!_pending.empty())
+            {
+                std::pop_heap(_pending.begin(), _pending.end(), lowerPriority);
+                Task task = std::move(_pending.back());
+                _pending.pop_back();
+
+                // an earlier task in this run may have canceled it
+                if (canceled(task))
+                    continue;
+
+                task.function->run();
+                ++ran;
+
+                if (std::chrono::steady_clock::now() - start >= budget)
+                    break;
+            }
+
+            auto used = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+            std::scoped_lock lock(_mutex);
+            _stats.pending = _pending.size() + _incoming.size();
+            _stats.ran = ran;
+            _stats.used = used;
+            _stats.budget = budget;
         }
     };
 
@@ -265,6 +298,121 @@ namespace
             _function();
         };
     };
+
+    // set while the calling thread is compiling a batch
+    thread_local bool s_compilingBatch = false;
+
+    // Gathers compile requests from any thread and compiles them together on a
+    // single background thread. Each compile manager submission waits on its own
+    // fence, so several loaders finishing at once would otherwise queue up for a
+    // compile traversal and pay for a submission apiece.
+    class CompileQueue : public vsg::Inherit<vsg::Object, CompileQueue>
+    {
+    public:
+        struct Request
+        {
+            vsg::ref_ptr<vsg::Object> object;
+            std::function<void(const vsg::CompileResult&)> onReady;
+        };
+
+        vsg::observer_ptr<vsg::Viewer> _viewer;
+
+        mutable std::mutex _mutex;
+        std::vector<Request> _requests;
+        bool _scheduled = false;
+        vsg::CompileResult _results; // waiting for the next update
+        VSGContextImpl::CompileStats _stats;
+
+        CompileQueue(vsg::ref_ptr<vsg::Viewer> viewer) :
+            _viewer(viewer) { }
+
+        void add(Request&& request)
+        {
+            std::scoped_lock lock(_mutex);
+            _requests.emplace_back(std::move(request));
+
+            // Requests arriving while a batch compiles wait for the next one,
+            // which is how concurrent requests end up sharing a batch.
+            if (!_scheduled)
+            {
+                _scheduled = true;
+                vsg::ref_ptr<CompileQueue> self(this);
+                jobs::dispatch([self]() { self->compileBatch(); },
+                    jobs::context{ "rocky::compile", jobs::get_pool("rocky::compile", 1) });
+            }
+        }
+
+        vsg::CompileResult compileNow(vsg::ref_ptr<vsg::Object> object)
+        {
+            vsg::CompileResult cr;
+
+            auto viewer = _viewer.ref_ptr();
+            if (viewer && viewer->compileManager)
+            {
+                cr = viewer->compileManager->compile(object);
+            }
+            else
+            {
+                cr.result = VK_ERROR_INITIALIZATION_FAILED;
+                cr.message = "No compile manager available";
+            }
+
+            if (cr)
+            {
+                // compile results are stored and processed later during update
+                std::scoped_lock lock(_mutex);
+                _results.add(cr);
+            }
+
+            return cr;
+        }
+
+        void compileBatch()
+        {
+            std::vector<Request> batch;
+            {
+                std::scoped_lock lock(_mutex);
+                batch.swap(_requests);
+                _scheduled = false;
+            }
+
+            if (batch.empty())
+                return;
+
+            auto objects = vsg::Objects::create();
+            objects->children.reserve(batch.size());
+            for (auto& request : batch)
+                objects->addChild(request.object);
+
+            s_compilingBatch = true;
+            auto cr = compileNow(objects);
+
+            // One bad object fails the whole batch, so compile each one again
+            // on its own to give every caller its own result. Objects that did
+            // compile the first time go quickly.
+            std::vector<vsg::CompileResult> results;
+            if (!cr && batch.size() > 1)
+            {
+                results.reserve(batch.size());
+                for (auto& request : batch)
+                    results.emplace_back(compileNow(request.object));
+            }
+            s_compilingBatch = false;
+
+            {
+                std::scoped_lock lock(_mutex);
+                ++_stats.batches;
+                _stats.objects += batch.size();
+                _stats.retries += results.size();
+            }
+
+            for (std::size_t i = 0; i < batch.size(); ++i)
+            {
+                if (batch[i].onReady)
+                    batch[i].onReady(results.empty() ? cr : results[i]);
+            }
+        }
+    };
 }
 
 
@@ -299,6 +447,12 @@ VSGContextImpl::ctor(int& argc, char** argv)
 
     _priorityUpdateQueue = PriorityUpdateQueue::create();
 
+    _compileQueue = CompileQueue::create(_viewer);
+
+    // 4 frames covers the swapchain images VSG may have in flight; 4MB each
+    // holds a full icon cull list
+    stagingRing = StagingRing::create(16 * 1024 * 1024, 4);
+
     // initialize the deferred deletion collection.
     // a large number of frames ensures objects will be safely destroyed and
     // and we won't have too many deletions per frame.
@@ -408,7 +562,7 @@ VSGContextImpl::ctor(int& argc, char** argv)
         auto result = URI(location).read(io);
         if (result.ok())
         {
-            std::istringstream buf(result.value().content.data);
+            util::imemstream buf(result.value().content.data);
             return io.services().readImageFromStream(buf, result.value().content.type, io);
         }
         return Result<std::shared_ptr<Image>>(Failure(Failure::ResourceUnavailable, "Data is null"));
@@ -482,14 +636,38 @@ VSGContextImpl::ctor(int& argc, char** argv)
             return Failure(Failure::ServiceUnavailable, "No image reader for \"" + contentType + "\"");
         };
 
-    // caches URI request results
-    io.services().contentCache = std::make_shared<ContentCache>(256);
+    // caches URI request results, budgeted by size so a few large rasters
+    // don't crowd out many small responses (or vice versa). A response must fit
+    // in one shard, so keep the shards few and large (16MB each).
+    io.services().contentCache = std::make_shared<ContentCache>(64u * 1024u * 1024u,
+        [](const Result<Content>& r) -> std::size_t
+        {
+            constexpr std::size_t overhead = 256u; // key, list node, etc.
+            return r.ok() ? r.value().data.size() + r.value().type.size() + overhead : overhead;
+        },
+        4u);
 
     // weak cache of resident image (and elevation) rasters
-    io.services().residentImageCache = std::make_shared<util::ResidentCache<std::string, Image, GeoExtent>>();
+    io.services().residentImageCache = std::make_shared<ResidentImageCache>();
 
     // remembers failed URI requests so we don't repeat them
     io.services().deadpool = std::make_shared<DealpoolService>(4096);
+
+    // persistent cache of URI request results (optional)
+    std::string cache_path = util::getEnvVar("ROCKY_CACHE_PATH").value_or("");
+    args.read("--cache", cache_path);
+    if (!cache_path.empty())
+    {
+        std::size_t cache_max_mb = 1024;
+        if (auto value = util::getEnvVar("ROCKY_CACHE_MAX_SIZE_MB"))
+            cache_max_mb = std::max(1, std::atoi(value->c_str()));
+
+        auto diskCache = std::make_shared<DiskCache>(cache_path, cache_max_mb * 1024u * 1024u);
+        if (diskCache->status.ok())
+            io.services().diskCache = diskCache;
+        else
+            Log()->warn(diskCache->status.error().string());
+    }
 }
 
 vsg::ref_ptr<vsg::Device>
@@ -498,6 +676,18 @@ VSGContextImpl::device()
     return _viewer->windows().size() > 0 ? _viewer->windows().front()->getOrCreateDevice() : nullptr;
 }
 
+VkPhysicalDeviceFeatures
+VSGContextImpl::deviceFeatures()
+{
+    if (_viewer->windows().size() > 0)
+    {
+        auto* traits = _viewer->windows().front()->traits();
+        if (traits && traits->deviceFeatures)
+            return traits->deviceFeatures->get();
+    }
+    return {};
+}
+
 VulkanExtensions*
 VSGContextImpl::ext()
 {
@@ -542,12 +732,25 @@ VSGContextImpl::onNextUpdate(vsg::ref_ptr<vsg::Operation> function, std::functio
             _viewer->updateOperations->add(_priorityUpdateQueue, vsg::UpdateOperations::ALL_FRAMES);
         }
 
-        pq->_queue.push_back({ function, get_priority });
+        pq->_incoming.push_back({ function, get_priority });
+        pq->_budget = updateBudget;
 
         requestFrame();
     }
 }
 
+VSGContextImpl::UpdateStats
+VSGContextImpl::updateStats() const
+{
+    auto pq = dynamic_cast<PriorityUpdateQueue*>(_priorityUpdateQueue.get());
+    if (pq)
+    {
+        std::scoped_lock lock(pq->_mutex);
+        return pq->_stats;
+    }
+    return {};
+}
+
 void
 VSGContextImpl::onNextUpdate(std::function<void()> function)
 {
@@ -561,18 +764,36 @@ VSGContextImpl::compile(vsg::ref_ptr<vsg::Object> compilable)
 {
     ROCKY_SOFT_ASSERT_AND_RETURN(compilable.valid(), {});
 
-    // note: this can block (with a fence) until a compile traversal is available.
-    // Be sure to group as many compiles together as possible for maximum performance.
-    auto cr = _viewer->compileManager->compile(compilable);
+    auto cq = static_cast<CompileQueue*>(_compileQueue.get());
 
-    if (cr)
+    // a completion callback compiling something else can't wait on its own batch
+    if (s_compilingBatch)
     {
-        // compile results are stored and processed later during update
-        std::unique_lock lock(_compileMutex);
-        _compileResult.add(cr);
+        return cq->compileNow(compilable);
     }
 
-    return cr;
+    jobs::future<vsg::CompileResult> result;
+
+    cq->add({ compilable, [result](const vsg::CompileResult& cr) mutable { result.resolve(cr); } });
+
+    return result.join();
+}
+
+void
+VSGContextImpl::compileAsync(vsg::ref_ptr<vsg::Object> compilable, std::function<void(const vsg::CompileResult&)> onReady)
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(compilable.valid(), void());
+
+    auto cq = static_cast<CompileQueue*>(_compileQueue.get());
+    cq->add({ compilable, onReady });
+}
+
+VSGContextImpl::CompileStats
+VSGContextImpl::compileStats() const
+{
+    auto cq = static_cast<CompileQueue*>(_compileQueue.get());
+    std::scoped_lock lock(cq->_mutex);
+    return cq->_stats;
 }
 
 void
@@ -606,12 +827,15 @@ VSGContextImpl::upload(const vsg::BufferInfoList& bufferInfos)
     vsg::BufferInfoList validBufferInfos;
     validBufferInfos.reserve(bufferInfos.size());
 
+    std::size_t bytes = 0;
+
     for (auto& bi : bufferInfos)
     {
         if (bi && bi->data)
         {
             bi->data->dirty();
             validBufferInfos.emplace_back(bi);
+            bytes += bi->data->dataSize();
         }
     }
 
@@ -623,6 +847,8 @@ VSGContextImpl::upload(const vsg::BufferInfoList& bufferInfos)
             task->transferTask->assign(validBufferInfos);
         }
 
+        _uploadBytes += bytes;
+
         requestFrame();
     }
 }
@@ -635,12 +861,14 @@ VSGContextImpl::upload(const vsg::ImageInfoList& imageInfos)
     // inspired by: https://github.com/vsg-dev/VulkanSceneGraph/discussions/1572
     vsg::ImageInfoList validImageInfos;
     validImageInfos.reserve(imageInfos.size());
+    std::size_t bytes = 0;
     for (auto& bi : imageInfos)
     {
         if (bi && bi->imageView && bi->imageView->image && bi->imageView->image->data)
         {
             bi->imageView->image->data->dirty();
             validImageInfos.emplace_back(bi);
+            bytes += bi->imageView->image->data->dataSize();
         }
     }
 
@@ -652,10 +880,19 @@ VSGContextImpl::upload(const vsg::ImageInfoList& imageInfos)
             task->transferTask->assign(validImageInfos);
         }
 
+        _uploadBytes += bytes;
+
         requestFrame();
     }
 }
 
+VSGContextImpl::UploadStats
+VSGContextImpl::uploadStats() const
+{
+    std::scoped_lock lock(_uploadMutex);
+    return _uploadStats;
+}
+
 void
 VSGContextImpl::requestFrame()
 {
@@ -670,6 +907,44 @@ VSGContextImpl::update()
     // Context update callbacks
     onUpdate.fire();
 
+    // pick up any change to the update budget
+    if (auto pq = dynamic_cast<PriorityUpdateQueue*>(_priorityUpdateQueue.get()))
+    {
+        std::scoped_lock lock(pq->_mutex);
+        pq->_budget = updateBudget;
+    }
+
+    // Once per new frame, close out the last frame's uploads and give the new
+    // one a fresh partition of the staging ring. (There may be several updates
+    // per frame, and none of them advance the frame stamp without rendering.)
+    auto fs = _viewer->getFrameStamp();
+    if (fs && fs->frameCount != _uploadFrame)
+    {
+        _uploadFrame = fs->frameCount;
+
+        std::scoped_lock lock(_uploadMutex);
+        _uploadStats.queued = _uploadBytes.exchange(0);
+        _uploadStats.streamed = stagingRing ? stagingRing->reserved() : 0;
+        _uploadStats.overflows = stagingRing ? stagingRing->overflows() : 0;
+
+        if (stagingRing)
+        {
+            stagingRing->advance();
+        }
+    }
+
+    // collect what the compile queue finished since the last update
+    {
+        auto cq = static_cast<CompileQueue*>(_compileQueue.get());
+        std::scoped_lock lock(cq->_mutex);
+        if (cq->_results)
+        {
+            std::unique_lock compileLock(_compileMutex);
+            _compileResult.add(cq->_results);
+            cq->_results.reset();
+        }
+    }
+
     if (_compileResult)
     {
         std::unique_lock lock(_compileMutex);
@@ -6,10 +6,12 @@
 #pragma once
 #include <rocky/vsg/Common.h>
 #include <rocky/vsg/Polyfill.h>
+#include <rocky/vsg/StagingRing.h>
 #include <rocky/Context.h>
 #include <rocky/Callbacks.h>
 #include <rocky/Rendering.h>
 #include <vsg/all.h>
+#include <chrono>
 #include <deque>
 #include <vector>
 
@@ -72,28 +74,95 @@ namespace ROCKY_NAMESPACE
 
         std::function<float()> devicePixelRatio = []() { return 1.0f; };
 
+        //! Time allowed each frame for the prioritized operations queued with
+        //! onNextUpdate(function, get_priority). The highest priority operations
+        //! run until the budget is spent; at least one runs every frame.
+        std::chrono::microseconds updateBudget = std::chrono::microseconds(2000);
+
+        //! What the prioritized update operations did in the last update pass
+        struct UpdateStats
+        {
+            //! Operations still waiting to run
+            std::size_t pending = 0;
+
+            //! Operations that ran
+            std::size_t ran = 0;
+
+            //! Time spent running them
+            std::chrono::microseconds used = std::chrono::microseconds(0);
+
+            //! Time allowed to run them
+            std::chrono::microseconds budget = std::chrono::microseconds(0);
+        };
+
+        //! Shared staging memory for buffers streamed to the GPU every frame
+        //! (see StreamingGPUBuffer). Replace it before any streaming buffers
+        //! compile to change its size.
+        vsg::ref_ptr<StagingRing> stagingRing;
+
+        //! Data sent to the GPU in the last complete frame
+        struct UploadStats
+        {
+            //! Bytes queued with upload()
+            std::size_t queued = 0;
+
+            //! Bytes streamed through the stagingRing
+            std::size_t streamed = 0;
+
+            //! Streams that didn't fit in the stagingRing
+            std::size_t overflows = 0;
+        };
+
+        //! Running totals for the batched compiles
+        struct CompileStats
+        {
+            //! Batches submitted to the compile manager
+            std::uint64_t batches = 0;
+
+            //! Objects compiled in those batches
+            std::uint64_t objects = 0;
+
+            //! Objects compiled again on their own because their batch failed
+            std::uint64_t retries = 0;
+        };
+
     public:
 
-        //! Queue a function to run during the update pass
+        //! Queue a function to run during the update pass, in priority order
+        //! and within the updateBudget shared by all such functions.
         //! This is a safe way to do things that require modifying the scene
         //! or compiling vulkan objects
         void onNextUpdate(
             vsg::ref_ptr<vsg::Operation> function,
             std::function<float()> get_priority = {});
 
+        //! Statistics from the last pass of the prioritized update operations
+        UpdateStats updateStats() const;
+
         //! Queue a function to run during the update pass.
         //! This is a safe way to do things that require modifying the scene
         //! or compiling vulkan objects
         void onNextUpdate(std::function<void()> function);
 
-        //! Compiles the Vulkan primitives for an object. This is a thread-safe
-        //! operation. Each call to compile() might block the viewer to access
-        //! a compile manager, so it is always a good idea to batch together as
-        //! many compile operations as possible (e.g., with vsg::Objects) for good
-        //! performance.
+        //! Compiles the Vulkan primitives for an object and waits for the result.
+        //! This is a thread-safe operation. Requests from all threads are
+        //! gathered and compiled together in one batch (see compileAsync), so
+        //! loaders finishing at the same time share a single submission instead
+        //! of queuing up for the compile manager one by one.
         //! @return the compile result, which you should use to check for errors.
         vsg::CompileResult compile(vsg::ref_ptr<vsg::Object> object);
 
+        //! Queues an object for compilation in the next batch and returns right
+        //! away. The batch compiles on a background thread; onReady runs there
+        //! once the object's Vulkan primitives exist (or failed to), so use
+        //! onNextUpdate from it to change the scene. Thread-safe.
+        void compileAsync(
+            vsg::ref_ptr<vsg::Object> object,
+            std::function<void(const vsg::CompileResult&)> onReady = {});
+
+        //! Totals for the batched compiles so far
+        CompileStats compileStats() const;
+
         //! Destroys a VSG object, eventually. 
         //! Call this to get rid of descriptor sets you plan to replace.
         //! You can't just let them go since they recycle internally and 
@@ -110,9 +179,15 @@ namespace ROCKY_NAMESPACE
         void upload(const vsg::BufferInfoList& bufferInfos);
         void upload(const vsg::ImageInfoList& inageInfos);
 
+        //! Statistics on the data sent to the GPU in the last complete frame
+        UploadStats uploadStats() const;
+
         //! The VSG/Vulkan device shared by all displays
         vsg::ref_ptr<vsg::Device> device();
 
+        //! Core features enabled on that device; all off if there's no display yet
+        VkPhysicalDeviceFeatures deviceFeatures();
+
         //! A command graph the application can use to run compute shaders
         vsg::ref_ptr<vsg::CommandGraph> getComputeCommandGraph() const;
         vsg::ref_ptr<vsg::CommandGraph> getOrCreateComputeCommandGraph(vsg::ref_ptr<vsg::Device> device, int queueFamily);
@@ -129,6 +204,15 @@ namespace ROCKY_NAMESPACE
         mutable std::mutex _compileMutex;
         vsg::CompileResult _compileResult;
 
+        // batches compile requests from all threads
+        vsg::ref_ptr<vsg::Object> _compileQueue;
+
+        // bytes queued with upload() since the last update
+        std::atomic<std::size_t> _uploadBytes = { 0 };
+        mutable std::mutex _uploadMutex;
+        UploadStats _uploadStats;
+        std::uint64_t _uploadFrame = ~0ull;
+
         // deferred deletion container (garbage collector)
         mutable std::mutex _gc_mutex;
         std::deque<std::vector<vsg::ref_ptr<vsg::Object>>> _gc;
@@ -170,6 +170,13 @@ namespace ROCKY_NAMESPACE
             props.format = format;
             props.allocatorType = vsg::ALLOCATOR_TYPE_NO_DELETE;
 
+            // compressed images are arrays of 4x4 blocks
+            if (image->compressed())
+            {
+                props.blockWidth = 4, props.blockHeight = 4;
+                width = (width + 3) / 4, height = (height + 3) / 4;
+            }
+
             vsg::ref_ptr<vsg::Data> vsg_data;
             if (depth == 1)
             {
@@ -229,6 +236,20 @@ namespace ROCKY_NAMESPACE
             case Image::R64_SFLOAT:
                 return wrap<double>(image, VK_FORMAT_R64_SFLOAT);
                 break;
+            case Image::BC1_RGBA_UNORM:
+                return wrap<vsg::block64>(image, VK_FORMAT_BC1_RGBA_UNORM_BLOCK);
+                break;
+            case Image::BC1_RGBA_SRGB:
+                return wrap<vsg::block64>(image, VK_FORMAT_BC1_RGBA_SRGB_BLOCK);
+                break;
+            case Image::BC3_RGBA_UNORM:
+                return wrap<vsg::block128>(image, VK_FORMAT_BC3_UNORM_BLOCK);
+                break;
+            case Image::BC3_RGBA_SRGB:
+                return wrap<vsg::block128>(image, VK_FORMAT_BC3_SRGB_BLOCK);
+                break;
+            default:
+                break;
             };
 
             return { };
@@ -260,12 +281,19 @@ namespace ROCKY_NAMESPACE
                 height = image->height(),
                 depth = image->depth();
 
-            T* data = reinterpret_cast<T*>(image->releaseData());
-
             vsg::Data::Properties props;
             props.format = format;
             props.allocatorType = vsg::ALLOCATOR_TYPE_NEW_DELETE;
 
+            // compressed images are arrays of 4x4 blocks
+            if (image->compressed())
+            {
+                props.blockWidth = 4, props.blockHeight = 4;
+                width = (width + 3) / 4, height = (height + 3) / 4;
+            }
+
+            T* data = reinterpret_cast<T*>(image->releaseData());
+
             vsg::ref_ptr<vsg::Data> vsg_data;
             if (depth == 1)
             {
@@ -325,6 +353,20 @@ namespace ROCKY_NAMESPACE
             case Image::R64_SFLOAT:
                 return move<double>(image, VK_FORMAT_R64_SFLOAT);
                 break;
+            case Image::BC1_RGBA_UNORM:
+                return move<vsg::block64>(image, VK_FORMAT_BC1_RGBA_UNORM_BLOCK);
+                break;
+            case Image::BC1_RGBA_SRGB:
+                return move<vsg::block64>(image, VK_FORMAT_BC1_RGBA_SRGB_BLOCK);
+                break;
+            case Image::BC3_RGBA_UNORM:
+                return move<vsg::block128>(image, VK_FORMAT_BC3_UNORM_BLOCK);
+                break;
+            case Image::BC3_RGBA_SRGB:
+                return move<vsg::block128>(image, VK_FORMAT_BC3_SRGB_BLOCK);
+                break;
+            default:
+                break;
             };
 
             return { };
@@ -380,6 +422,10 @@ namespace ROCKY_NAMESPACE
             case Image::R16_UNORM: return VK_FORMAT_R16_UNORM;
             case Image::R32_SFLOAT: return VK_FORMAT_R32_SFLOAT;
             case Image::R64_SFLOAT: return VK_FORMAT_R64_SFLOAT;
+            case Image::BC1_RGBA_UNORM: return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+            case Image::BC1_RGBA_SRGB: return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+            case Image::BC3_RGBA_UNORM: return VK_FORMAT_BC3_UNORM_BLOCK;
+            case Image::BC3_RGBA_SRGB: return VK_FORMAT_BC3_SRGB_BLOCK;
             default: return VK_FORMAT_UNDEFINED;
             }
         }
@@ -401,13 +447,30 @@ namespace ROCKY_NAMESPACE
                 return Failure(Failure::ResourceUnavailable, "Unsupported image format");
             }
 
+            // Adopt the decoded pixels instead of copying them. The owner holds
+            // a reference to the vsg::Data for the life of the image.
+            std::shared_ptr<void> owner(data->dataPointer(), [data](void*) { });
+
             auto image = Image::create(
                 format,
                 data->width(),
                 data->height(),
-                data->depth());
+                data->depth(),
+                static_cast<unsigned char*>(data->dataPointer()),
+                owner);
 
-            memcpy(image->data<uint8_t>(), data->dataPointer(), image->sizeInBytes());
+            // fall back on a copy if the data isn't tightly packed
+            if (data->stride() * image->sizeInPixels() != image->sizeInBytes() ||
+                data->dataSize() < image->sizeInBytes())
+            {
+                image = Image::create(
+                    format,
+                    data->width(),
+                    data->height(),
+                    data->depth());
+
+                memcpy(image->data<uint8_t>(), data->dataPointer(), image->sizeInBytes());
+            }
 
             if (data->properties.origin == vsg::TOP_LEFT)
             {
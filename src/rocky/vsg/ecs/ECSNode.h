@@ -11,6 +11,7 @@
 #include <rocky/vsg/ecs/ECSVisitors.h>
 #include <rocky/vsg/VSGUtils.h>
 #include <rocky/Utils.h>
+#include <algorithm>
 #include <thread>
 #include <cstdint>
 
@@ -193,6 +194,10 @@ namespace ROCKY_NAMESPACE
         public:
             EntityNodeFactory* factory = nullptr;
 
+            //! Number of components at which the record traversal starts
+            //! sorting them into draw lists on several threads at once
+            std::size_t parallelCollectThreshold = 4096;
+
             virtual void invokeCreateOrUpdate(BuildItem& item, VSGContext& vsgcontext) const = 0;
 
             virtual void mergeCreateOrUpdateResults(entt::registry&, BuildItem& item, VSGContext& vsgcontext) = 0;
@@ -275,6 +280,17 @@ namespace ROCKY_NAMESPACE
             // re-usable collection to minimize re-allocation
             mutable std::vector<std::vector<RenderLeaf>> _pipelineRenderLeaves;
 
+            // what one thread collected from its share of the components
+            struct Collection
+            {
+                std::vector<std::vector<RenderLeaf>> leaves;
+                std::vector<entt::entity> entities_to_update;
+            };
+            mutable std::vector<Collection> _collections;
+
+            // entities the parallel collection walks, in the view's own order
+            mutable std::vector<entt::entity> _collectOrder;
+
             // re-usable 'visited' collection for uniqueness testing.
             // prefer std::vector over std::set for small collections (<100 entries), which we expect.
             mutable std::vector<std::uintptr_t> _visited;
@@ -543,18 +559,24 @@ namespace ROCKY_NAMESPACE
         }
 
         auto [lock, registry] = _registry.read();
-            
 
-        // Get an optimized view of all this system's components:
+        // Look these up before any sorting starts, since looking up a
+        // storage for the first time creates it.
+        auto& storage = registry.template storage<T>();
+        auto& renderables = registry.template storage<Renderable>();
+        auto& transforms = registry.template storage<TransformDetail>();
         const auto& view = registry.template view<T, ActiveState, Visibility>();
-        view.each([&](const entt::entity entity, auto& component, auto& active, auto& visibility)
+
+        // Sorts one component into a set of draw lists, and notes whether it needs rebuilding.
+        auto collect = [&](const entt::entity entity, const T& component, auto revision, const Visibility& visibility,
+            RenderingState& rs, std::vector<std::vector<RenderLeaf>>& pipelineLeaves, std::vector<entt::entity>& entities_to_update)
             {
                 ROCKY_HARD_ASSERT(component.attach_point != entt::null);
-                auto& renderable = registry.template get<Renderable>(component.attach_point);
+                auto& renderable = renderables.get(component.attach_point);
                 if (renderable.node)
                 {
-                    auto& leaves = !pipelines.empty() ? _pipelineRenderLeaves[featureMask(component)] : _pipelineRenderLeaves[0];
-                    auto* transform_detail = registry.template try_get<TransformDetail>(entity);
+                    auto& leaves = !pipelines.empty() ? pipelineLeaves[featureMask(component)] : pipelineLeaves[0];
+                    auto* transform_detail = transforms.contains(entity) ? &transforms.get(entity) : nullptr;
 
                     // if it's visible, queue it up for rendering
                     if (visible(visibility, rs))
@@ -573,46 +595,98 @@ namespace ROCKY_NAMESPACE
                     }
                 }
 
-                if (renderable.revision != component.revision)
+                if (renderable.revision != revision)
                 {
-                    _entities_to_update.emplace_back(entity);
-                    renderable.revision = component.revision;
+                    entities_to_update.emplace_back(entity);
+                    renderable.revision = revision;
                 }
-            });
+            };
 
-        const auto& view_shared = registry.template view<SHARED_T, ActiveState, Visibility>();
-        view_shared.each([&](const entt::entity entity, auto& shared, auto& active, auto& visibility)
-            {
-                auto& component = *shared.pointer;
-                ROCKY_HARD_ASSERT(component.attach_point != entt::null);
-                auto& renderable = registry.template get<Renderable>(component.attach_point);
-                if (renderable.node)
+        const std::size_t threshold = this->parallelCollectThreshold;
+
+        if (threshold > 0 && storage.size() >= threshold)
+        {
+            // Walk the view in its own order, the same one view.each uses below,
+            // so crossing the threshold doesn't change the draw order.
+            _collectOrder.assign(view.begin(), view.end());
+        }
+        else
+        {
+            _collectOrder.clear();
+        }
+
+        const std::size_t count = _collectOrder.size();
+
+        if (threshold > 0 && count >= threshold)
+        {
+            // Split the components into contiguous chunks, one per thread. Each
+            // chunk sorts into lists of its own, and the lists are appended
+            // in chunk order so the draw order doesn't depend on the threads.
+            const unsigned cores = std::max(2u, std::thread::hardware_concurrency());
+            auto* pool = jobs::get_pool("rocky::ecs_collect", cores - 1);
+
+            const std::size_t numChunks = std::min((std::size_t)cores, count / std::max((std::size_t)1, threshold / 4));
+            const std::size_t chunkSize = (count + numChunks - 1) / numChunks;
+
+            _collections.resize(numChunks);
+
+            const entt::entity* entities = _collectOrder.data();
+
+            auto collect_chunk = [&](std::size_t c)
                 {
-                    auto& leaves = !pipelines.empty() ? _pipelineRenderLeaves[featureMask(component)] : _pipelineRenderLeaves[0];
-                    auto* transform_detail = registry.template try_get<TransformDetail>(entity);
+                    auto& collection = _collections[c];
+                    collection.leaves.resize(_pipelineRenderLeaves.size());
 
-                    // if it's visible, queue it up for rendering
-                    if (visible(visibility, rs))
+                    RenderingState chunk_rs = rs;
+                    const std::size_t end = std::min(count, (c + 1) * chunkSize);
+
+                    for (std::size_t i = c * chunkSize; i < end; ++i)
                     {
-                        if (transform_detail)
-                        {
-                            if (transform_detail->views[rs.viewID].passingCull)
-                            {
-                                leaves.emplace_back(RenderLeaf{ &renderable, transform_detail });
-                            }
-                        }
-                        else
-                        {
-                            leaves.emplace_back(RenderLeaf{ &renderable });
-                        }
+                        const entt::entity entity = entities[i];
+                        auto& component = storage.get(entity);
+                        collect(entity, component, component.revision, view.template get<Visibility>(entity),
+                            chunk_rs, collection.leaves, collection.entities_to_update);
                     }
-                }
+                };
+
+            auto group = jobs::jobgroup::create();
+            for (std::size_t c = 1; c < numChunks; ++c)
+            {
+                jobs::dispatch([&collect_chunk, c]() { collect_chunk(c); },
+                    jobs::context{ "ecs collect", pool, {}, group });
+            }
 
-                if (renderable.revision != shared.revision)
+            // the record thread takes the first chunk itself
+            collect_chunk(0);
+            group->join();
+
+            for (auto& collection : _collections)
+            {
+                for (std::size_t p = 0; p < collection.leaves.size(); ++p)
                 {
-                    _entities_to_update.emplace_back(entity);
-                    renderable.revision = shared.revision;
+                    auto& leaves = _pipelineRenderLeaves[p];
+                    leaves.insert(leaves.end(), collection.leaves[p].begin(), collection.leaves[p].end());
+                    collection.leaves[p].clear();
                 }
+
+                _entities_to_update.insert(_entities_to_update.end(),
+                    collection.entities_to_update.begin(), collection.entities_to_update.end());
+                collection.entities_to_update.clear();
+            }
+        }
+        else
+        {
+            // Get an optimized view of all this system's components:
+            view.each([&](const entt::entity entity, auto& component, auto& active, auto& visibility)
+                {
+                    collect(entity, component, component.revision, visibility, rs, _pipelineRenderLeaves, _entities_to_update);
+                });
+        }
+
+        const auto& view_shared = registry.template view<SHARED_T, ActiveState, Visibility>();
+        view_shared.each([&](const entt::entity entity, auto& shared, auto& active, auto& visibility)
+            {
+                collect(entity, *shared.pointer, shared.revision, visibility, rs, _pipelineRenderLeaves, _entities_to_update);
             });
 
         // Time to record all visible components. For each pipeline:
@@ -179,6 +179,8 @@ IconSystem2Node::initialize(VSGContext& context)
         sizeof(VkDrawIndexedIndirectCommand),
         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
 
+    indirect_command->ring = context->stagingRing;
+
     // a dynamic SSBO that holds the list of instances to cull. The CPU populates it, the compute
     // shader reads from it.
     cull_list = StreamingGPUBuffer::create(
@@ -186,6 +188,8 @@ IconSystem2Node::initialize(VSGContext& context)
         sizeof(IconInstanceGPU) * MAX_CULL_LIST_SIZE,
         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
 
+    cull_list->ring = context->stagingRing;
+
     // A shared sampler for our texture arena
     auto sampler = vsg::Sampler::create();
     sampler->maxLod = 5; // this alone will prompt mipmap generation!
@@ -6,6 +6,7 @@
 #include "LineSystem.h"
 #include "../PipelineState.h"
 #include "../VSGUtils.h"
+#include <algorithm>
 
 using namespace ROCKY_NAMESPACE;
 using namespace ROCKY_NAMESPACE::detail;
@@ -15,6 +16,7 @@ using namespace ROCKY_NAMESPACE::detail;
 
 #define LINE_SET 0
 #define LINE_BINDING_UNIFORM  1 // layout(set=0, binding=1) in the shader
+#define LINE_BINDING_BATCH    2 // layout(set=0, binding=2) in the shader, batched pipeline only
 
 namespace
 {
@@ -53,6 +55,9 @@ namespace
         shaderSet->addDescriptorBinding("line", "", LINE_SET, LINE_BINDING_UNIFORM,
             VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, {});
 
+        shaderSet->addDescriptorBinding("batch", "ROCKY_LINE_BATCHED", LINE_SET, LINE_BINDING_BATCH,
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, {});
+
         // We need VSG's view-dependent data:
         PipelineUtils::addViewDependentData(shaderSet, VK_SHADER_STAGE_VERTEX_BIT);
 
@@ -93,6 +98,13 @@ namespace
         }
     }
 
+    static inline void dispose(LineBatch& batch) {
+        dispose(batch.geometry);
+        for (auto& view : batch.views)
+            dispose(view.bind);
+        batch = {};
+    }
+
     void on_construct_Line(entt::registry& r, entt::entity e)
     {
         (void) r.get_or_emplace<ActiveState>(e);
@@ -113,6 +125,11 @@ namespace
         r.get<LineGeometry>(e).dirty(r);
     }
 
+    void on_destroy_Line(entt::registry& r, entt::entity e)
+    {
+        // so any batch holding the line drops it
+        r.get<Line>(e).dirty(r);
+    }
     void on_destroy_LineStyle(entt::registry& r, entt::entity e)
     {
         r.remove<LineStyleDetail>(e);
@@ -120,6 +137,7 @@ namespace
     void on_destroy_LineStyleDetail(entt::registry& r, entt::entity e)
     {
         dispose(r.get<LineStyleDetail>(e).bind);
+        dispose(r.get<LineStyleDetail>(e).batch);
     }
     void on_destroy_LineGeometry(entt::registry& r, entt::entity e)
     {
@@ -134,9 +152,17 @@ namespace
     {
         r.get<Line>(e).dirty(r);
     }
+    void on_activate_Line(entt::registry& r, entt::entity e)
+    {
+        // (de)activating a line adds it to or removes it from its style's batch
+        auto* line = r.try_get<Line>(e);
+        if (line && line->owner != entt::null)
+            line->dirty(r);
+    }
     void on_update_LineStyle(entt::registry& r, entt::entity e)
     {
         dispose(r.get<LineStyleDetail>(e).bind);
+        dispose(r.get<LineStyleDetail>(e).batch);
         r.get<LineStyleDetail>(e).recycle();
         r.get<LineStyle>(e).dirty(r);
     }
@@ -166,6 +192,10 @@ LineSystemNode::LineSystemNode(Registry& registry) :
             r.on_update<LineStyle>().connect<&on_update_LineStyle>();
             r.on_update<LineGeometry>().connect<&on_update_LineGeometry>();
 
+            r.on_construct<ActiveState>().connect<&on_activate_Line>();
+            r.on_destroy<ActiveState>().connect<&on_activate_Line>();
+
+            r.on_destroy<Line>().connect<&on_destroy_Line>();
             r.on_destroy<LineStyle>().connect<&on_destroy_LineStyle>();
             r.on_destroy<LineStyleDetail>().connect<&on_destroy_LineStyleDetail>();
             r.on_destroy<LineGeometry>().connect<&on_destroy_LineGeometry>();
@@ -193,11 +223,15 @@ LineSystemNode::initialize(VSGContext& vsgcontext)
         return;
     }
 
-    _pipelines.resize(NUM_PIPELINES);
+    // the batched pipeline, if any, goes after the feature pipelines
+    _batching = minBatchSize > 0;
+    _pipelines.resize(NUM_PIPELINES + (_batching ? 1 : 0));
 
-    for (int feature_mask = 0; feature_mask < NUM_PIPELINES; ++feature_mask)
+    for (int index = 0; index < (int)_pipelines.size(); ++index)
     {
-        auto& c = _pipelines[feature_mask];
+        auto& c = _pipelines[index];
+        bool batched = (index == BATCHED_PIPELINE);
+        int feature_mask = batched ? DEFAULT : index;
 
         // Create the pipeline configurator for terrain; this is a helper object
         // that acts as a "template" for terrain tile rendering state.
@@ -206,6 +240,16 @@ LineSystemNode::initialize(VSGContext& vsgcontext)
         // Apply any custom compile settings / defines:
         c.config->shaderHints = vsgcontext->shaderCompileSettings;
 
+        if (batched)
+        {
+            // copy the shared settings so the define doesn't leak into other pipelines
+            c.config->shaderHints = vsgcontext->shaderCompileSettings ?
+                vsg::ShaderCompileSettings::create(*vsgcontext->shaderCompileSettings) :
+                vsg::ShaderCompileSettings::create();
+
+            c.config->shaderHints->defines.insert("ROCKY_LINE_BATCHED");
+        }
+
         // activate the arrays we intend to use
         c.config->enableArray("in_vertex", VK_VERTEX_INPUT_RATE_VERTEX, 12);
         c.config->enableArray("in_vertex_prev", VK_VERTEX_INPUT_RATE_VERTEX, 12);
@@ -215,6 +259,9 @@ LineSystemNode::initialize(VSGContext& vsgcontext)
         // Uniforms we will need:
         c.config->enableDescriptor("line");
 
+        if (batched)
+            c.config->enableDescriptor("batch");
+
         // always both
         PipelineUtils::enableViewDependentData(c.config);
 
@@ -257,6 +304,10 @@ LineSystemNode::initialize(VSGContext& vsgcontext)
     // Set up our default style detail, which is used when a MeshStyle is missing.
     initializeStyleDetail(getPipelineLayout(Line()), _defaultStyleDetail);
     requestCompile(_defaultStyleDetail.bind);
+
+    // the base class only compiles the first pipeline
+    if (_batching)
+        requestCompile(_pipelines[BATCHED_PIPELINE].commands);
 }
 
 void
@@ -265,11 +316,22 @@ LineSystemNode::compile(vsg::Context& compileContext)
     // called during a compile traversal .. e.g., then adding a new View/RenderGraph.
     _registry.read([&](entt::registry& reg)
         {
-            reg.view<LineStyleDetail>().each([&](auto& styleDetail)
+            auto compileStyle = [&](LineStyleDetail& styleDetail)
                 {
                     if (styleDetail.bind)
                         styleDetail.bind->compile(compileContext);
-                });
+
+                    if (styleDetail.batch.geometry)
+                    {
+                        styleDetail.batch.geometry->compile(compileContext);
+                        for (auto& view : styleDetail.batch.views)
+                            if (view.bind)
+                                view.bind->compile(compileContext);
+                    }
+                };
+
+            compileStyle(_defaultStyleDetail);
+            reg.view<LineStyleDetail>().each(compileStyle);
 
             reg.view<LineGeometryDetail>().each([&](auto& geomDetail)
                 {
@@ -286,6 +348,9 @@ LineSystemNode::createOrUpdateGeometry(const LineGeometry& geom, LineGeometryDet
 {
     // NB: registry is read-locked
 
+    // any batch holding a copy of this geometry needs to repack it
+    ++geomDetail.revision;
+
     bool reallocate = false;
 
     if (!geomDetail.root)
@@ -416,6 +481,231 @@ LineSystemNode::createOrUpdateStyle(const LineStyle& style, LineStyleDetail& sty
         requestUpload(styleDetail.styleUBO->bufferInfoList);
 }
 
+void
+LineSystemNode::updateBatches(entt::registry& reg, VSGContext& vsgcontext)
+{
+    // NB: registry is read-locked
+
+    // a new view needs its own instance data in every batch
+    if (vsgcontext->activeViewIDs != _batchedViewIDs)
+    {
+        _batchedViewIDs = vsgcontext->activeViewIDs;
+        _batchesDirty = true;
+    }
+
+    // Nothing changes a batch's lines without going through the dirty lists
+    if (!_batchesDirty)
+        return;
+
+    _batchesDirty = false;
+
+    // Gather each style's lines, in the same order as the record traversal
+    std::unordered_map<LineStyleDetail*, std::vector<LineBatch::Member>> members;
+
+    reg.view<Line, ActiveState, Visibility>().each([&](auto entity, auto& line, auto& active, auto& visibility)
+        {
+            auto* geom = reg.try_get<LineGeometryDetail>(line.geometry);
+            if (!geom || !geom->geomNode)
+                return;
+
+            auto* styleDetail = &_defaultStyleDetail;
+            if (reg.try_get<LineStyle>(line.style))
+                styleDetail = &reg.get<LineStyleDetail>(line.style);
+
+            members[styleDetail].emplace_back(LineBatch::Member{ entity, line.geometry, geom->revision });
+        });
+
+    auto refresh = [&](LineStyleDetail& styleDetail)
+        {
+            auto& batch = styleDetail.batch;
+
+            std::vector<LineBatch::Member> latest;
+            auto iter = members.find(&styleDetail);
+            if (iter != members.end())
+                latest = std::move(iter->second);
+
+            bool missingViews = false;
+            if (batch.geometry)
+            {
+                for (auto viewID : vsgcontext->activeViewIDs)
+                    missingViews = missingViews || viewID >= batch.views.size() || !batch.views[viewID].bind;
+            }
+
+            // Same lines as the last attempt, whether or not it made a batch
+            if (latest == batch.members && !missingViews)
+                return;
+
+            // Changed lines already draw one at a time (see traverse), so a
+            // busy batch can wait a while before repacking them all again.
+            if (batch.geometry && !missingViews && _updates < batch.packed + minBatchRepackInterval)
+            {
+                _batchesDirty = true; // check again next update
+                return;
+            }
+
+            createBatch(reg, styleDetail, std::move(latest), vsgcontext);
+        };
+
+    refresh(_defaultStyleDetail);
+
+    for (auto&& [e, styleDetail] : reg.view<LineStyleDetail>().each())
+    {
+        if (_batching)
+            refresh(styleDetail);
+    }
+}
+
+vsg::ref_ptr<vsg::Geometry>
+ROCKY_NAMESPACE::detail::packLineBatch(const std::vector<const LineGeometryNode*>& lines)
+{
+    // Pack each geometry once, even if several lines share it.
+    struct Packed
+    {
+        std::uint32_t firstIndex = 0;
+        std::uint32_t indexCount = 0;
+        std::int32_t vertexOffset = 0;
+    };
+    std::unordered_map<const LineGeometryNode*, Packed> packed;
+    std::vector<const LineGeometryNode*> nodes;
+    std::size_t numVerts = 0, numIndices = 0;
+
+    for (auto* node : lines)
+    {
+        if (packed.count(node) == 0 && node && node->_current && node->_indices)
+        {
+            packed[node] = Packed{
+                (std::uint32_t)numIndices + node->_drawCommand->firstIndex,
+                node->_drawCommand->indexCount,
+                (std::int32_t)numVerts };
+
+            numVerts += node->_current->size();
+            numIndices += node->_indices->size();
+            nodes.emplace_back(node);
+        }
+    }
+
+    auto current = vsg::vec3Array::create(numVerts);
+    auto previous = vsg::vec3Array::create(numVerts);
+    auto next = vsg::vec3Array::create(numVerts);
+    auto colors = vsg::vec4Array::create(numVerts);
+    auto indices = vsg::uintArray::create(numIndices);
+
+    // Indices stay relative to their own geometry; each draw's vertexOffset
+    // finds its vertices. Offsets are multiples of 4 so the shader's corner
+    // code (from gl_VertexIndex) still works.
+    std::size_t v = 0, i = 0;
+    for (auto* node : nodes)
+    {
+        std::copy(node->_current->begin(), node->_current->end(), current->begin() + v);
+        std::copy(node->_previous->begin(), node->_previous->end(), previous->begin() + v);
+        std::copy(node->_next->begin(), node->_next->end(), next->begin() + v);
+        std::copy(node->_colors->begin(), node->_colors->end(), colors->begin() + v);
+        std::copy(node->_indices->begin(), node->_indices->end(), indices->begin() + i);
+        v += node->_current->size();
+        i += node->_indices->size();
+    }
+
+    // one indirect command per line; firstInstance selects its modelview
+    const auto count = (std::uint32_t)lines.size();
+    auto commandData = vsg::ubyteArray::create(count * sizeof(VkDrawIndexedIndirectCommand));
+    auto* commands = static_cast<VkDrawIndexedIndirectCommand*>(commandData->dataPointer());
+
+    for (std::uint32_t m = 0; m < count; ++m)
+    {
+        auto iter = packed.find(lines[m]);
+        auto p = iter != packed.end() ? iter->second : Packed{};
+        commands[m] = VkDrawIndexedIndirectCommand{ p.indexCount, 1, p.firstIndex, p.vertexOffset, m };
+    }
+
+    auto draw = vsg::DrawIndexedIndirect::create();
+    draw->bufferInfo = vsg::BufferInfo::create(commandData);
+    draw->drawCount = count;
+    draw->stride = sizeof(VkDrawIndexedIndirectCommand);
+
+    auto geometry = vsg::Geometry::create();
+    geometry->assignArrays({ current, previous, next, colors });
+    geometry->assignIndices(indices);
+    geometry->commands.push_back(draw);
+    return geometry;
+}
+
+void
+LineSystemNode::createBatch(entt::registry& reg, LineStyleDetail& styleDetail, std::vector<LineBatch::Member>&& members, VSGContext& vsgcontext)
+{
+    // NB: registry is read-locked
+
+    auto& batch = styleDetail.batch;
+
+    ::dispose(batch);
+    batch.members = std::move(members);
+    batch.packed = _updates;
+
+    const auto count = (std::uint32_t)batch.members.size();
+
+    if (count == 0 || count < minBatchSize || !styleDetail.styleUBO)
+        return;
+
+    auto device = vsgcontext->device();
+    if (!device)
+        return;
+
+    // one draw per line, all in a single indirect call, each draw
+    // reading its own instance data through firstInstance
+    auto features = vsgcontext->deviceFeatures();
+    if (!features.multiDrawIndirect || !features.drawIndirectFirstInstance)
+    {
+        Log()->warn("Line batching requires the multiDrawIndirect and drawIndirectFirstInstance "
+            "device features; lines will draw one at a time");
+        _batching = false;
+        return;
+    }
+
+    if (count > device->getPhysicalDevice()->getProperties().limits.maxDrawIndirectCount)
+        return;
+
+    std::vector<const LineGeometryNode*> lines;
+    lines.reserve(count);
+
+    for (std::uint32_t m = 0; m < count; ++m)
+    {
+        auto& member = batch.members[m];
+        auto& geomDetail = reg.get<LineGeometryDetail>(member.geometry);
+
+        auto* localizer = geomDetail.root ? geomDetail.root->cast<vsg::MatrixTransform>() : nullptr;
+        member.localizer = localizer ? localizer->matrix : vsg::dmat4(1.0);
+
+        lines.emplace_back(geomDetail.geomNode.get());
+        batch.instances[member.line] = m;
+    }
+
+    batch.geometry = packLineBatch(lines);
+    requestCompile(batch.geometry);
+
+    // Each view gets its own modelview matrices, written during its record
+    // traversal and transferred right after it.
+    auto layout = _pipelines[BATCHED_PIPELINE].config->layout;
+
+    for (auto viewID : vsgcontext->activeViewIDs)
+    {
+        if (viewID >= batch.views.size())
+            batch.views.resize(viewID + 1);
+
+        auto& view = batch.views[viewID];
+        view.modelviews = vsg::mat4Array::create(count);
+        view.modelviews->properties.dataVariance = vsg::DYNAMIC_DATA_TRANSFER_AFTER_RECORD;
+
+        auto ssbo = vsg::DescriptorBuffer::create(view.modelviews, LINE_BINDING_BATCH, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+
+        view.bind = vsg::BindDescriptorSet::create(
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            layout,
+            0, // first set
+            vsg::DescriptorSet::create(layout->setLayouts.front(), vsg::Descriptors{ styleDetail.styleUBO, ssbo }));
+
+        requestCompile(view.bind);
+    }
+}
+
 void
 LineSystemNode::traverse(vsg::RecordTraversal& record) const
 {
@@ -437,6 +727,44 @@ LineSystemNode::traverse(vsg::RecordTraversal& record) const
                     styleDetails.emplace_back(&styleDetail);
                 });
 
+            // batched lines start out hidden in this view; visible ones write their matrix below
+            for (auto& styleDetail : styleDetails)
+            {
+                auto& batch = styleDetail->batch;
+                if (batch.geometry && rs.viewID < batch.views.size() && batch.views[rs.viewID].modelviews)
+                {
+                    auto& modelviews = *batch.views[rs.viewID].modelviews;
+                    std::fill(modelviews.begin(), modelviews.end(), LineBatch::hidden());
+                }
+            }
+
+            // Writes the modelview of a batched line and returns true, or returns
+            // false if the line isn't (or is no longer) part of a batch.
+            auto batched = [&](entt::entity entity, const Line& line, const LineGeometryDetail& geom,
+                LineStyleDetail& styleDetail, const TransformDetail* transformDetail)
+                {
+                    auto& batch = styleDetail.batch;
+                    if (!batch.geometry || rs.viewID >= batch.views.size() || !batch.views[rs.viewID].modelviews)
+                        return false;
+
+                    auto iter = batch.instances.find(entity);
+                    if (iter == batch.instances.end())
+                        return false;
+
+                    auto& member = batch.members[iter->second];
+                    if (member.geometry != line.geometry || member.revision != geom.revision)
+                        return false;
+
+                    auto& modelview = transformDetail ?
+                        transformDetail->views[rs.viewID].modelview :
+                        record.getState()->modelviewMatrixStack.top();
+
+                    auto& view = batch.views[rs.viewID];
+                    view.modelviews->at(iter->second) = vsg::mat4(modelview * member.localizer);
+                    view.active = true;
+                    return true;
+                };
+
             int count = 0;
             auto view = reg.view<Line, ActiveState, Visibility>();
 
@@ -458,12 +786,18 @@ LineSystemNode::traverse(vsg::RecordTraversal& record) const
                         {
                             if (transformDetail->views[rs.viewID].passingCull)
                             {
+                                if (batched(entity, line, *geom, *styleDetail, transformDetail))
+                                    return;
+
                                 styleDetail->drawList.emplace_back(LineDrawable{ geom->root, transformDetail });
                                 ++count;
                             }
                         }
                         else
                         {
+                            if (batched(entity, line, *geom, *styleDetail, nullptr))
+                                return;
+
                             styleDetail->drawList.emplace_back(LineDrawable{ geom->root, nullptr });
                             ++count;
                         }
@@ -501,6 +835,29 @@ LineSystemNode::traverse(vsg::RecordTraversal& record) const
                     }
                 }
             }
+
+            // Render batches: one indirect draw per style covers all its lines.
+            bool pipelineBound = false;
+
+            for (auto& styleDetail : styleDetails)
+            {
+                auto& batch = styleDetail->batch;
+                if (rs.viewID < batch.views.size() && batch.views[rs.viewID].active)
+                {
+                    auto& view = batch.views[rs.viewID];
+                    view.modelviews->dirty();
+
+                    if (!pipelineBound)
+                    {
+                        _pipelines[BATCHED_PIPELINE].commands->accept(record);
+                        pipelineBound = true;
+                    }
+
+                    view.bind->accept(record);
+                    batch.geometry->accept(record);
+                    view.active = false;
+                }
+            }
         });
 }
 
@@ -552,6 +909,8 @@ LineSystemNode::update(VSGContext& vsgcontext)
 {
     if (status.failed()) return;
 
+    ++_updates;
+
     // start by disposing of any old static objects
     if (!s_toDispose->children.empty())
     {
@@ -578,6 +937,7 @@ LineSystemNode::update(VSGContext& vsgcontext)
                     const auto [style, styleDetail] = reg.try_get<LineStyle, LineStyleDetail>(e);
                     if (style && styleDetail)
                         createOrUpdateStyle(*style, *styleDetail);
+                    _batchesDirty = true;
                 });
 
             LineGeometry::eachDirty(reg, [&](entt::entity e)
@@ -585,7 +945,23 @@ LineSystemNode::update(VSGContext& vsgcontext)
                     const auto [geom, geomDetail] = reg.try_get<LineGeometry, LineGeometryDetail>(e);
                     if (geom && geomDetail)
                         createOrUpdateGeometry(*geom, *geomDetail, vsgcontext);
-                });                  
+                    _batchesDirty = true;
+                });
+
+            // Lines have no detail to update, but a new, changed, (de)activated,
+            // or destroyed line changes its batch. Destroyed ones count too,
+            // so don't use eachDirty (which skips them).
+            reg.view<Line::Dirty>().each([&](auto& dirtyList)
+                {
+                    std::scoped_lock lock(dirtyList.mutex);
+                    _batchesDirty = _batchesDirty || !dirtyList.entities.empty();
+                    dirtyList.entities.clear();
+                });
+
+            if (_batching)
+            {
+                updateBatches(reg, vsgcontext);
+            }
         });
 
     Inherit::update(vsgcontext);
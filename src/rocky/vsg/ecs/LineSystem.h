@@ -6,6 +6,7 @@
 #pragma once
 #include <rocky/ecs/Line.h>
 #include <rocky/vsg/ecs/ECSNode.h>
+#include <unordered_map>
 
 namespace ROCKY_NAMESPACE
 {
@@ -92,18 +93,77 @@ namespace ROCKY_NAMESPACE
 
         using LineDrawList = std::vector<LineDrawable>;
 
+        // Lines sharing a style, packed into one set of vertex and index buffers
+        // and drawn with a single indirect call (see LineSystemNode::minBatchSize).
+        // Each line is one instance of the draw; its modelview matrix comes from
+        // "batch" in the shader, which the record traversal rewrites every frame.
+        struct LineBatch
+        {
+            struct Member
+            {
+                entt::entity line = entt::null;
+                entt::entity geometry = entt::null;
+                std::uint32_t revision = 0; // LineGeometryDetail::revision that was packed
+                vsg::dmat4 localizer;       // the geometry's reference point offset
+
+                inline bool operator == (const Member& rhs) const {
+                    return line == rhs.line && geometry == rhs.geometry && revision == rhs.revision;
+                }
+            };
+
+            // per-view instance data
+            struct View
+            {
+                vsg::ref_ptr<vsg::mat4Array> modelviews;
+                vsg::ref_ptr<vsg::BindDescriptorSet> bind;
+                bool active = false; // any instance visible in the current record traversal
+            };
+
+            //! One instance per member, in order
+            std::vector<Member> members;
+
+            //! Instance index of each Line entity
+            std::unordered_map<entt::entity, std::uint32_t> instances;
+
+            //! Packed geometry with the indirect draw; null if the style isn't batched
+            vsg::ref_ptr<vsg::Geometry> geometry;
+
+            //! Instance data for each view, by view ID
+            std::vector<View> views;
+
+            //! System update in which the batch was last packed
+            std::uint64_t packed = 0;
+
+            //! Modelview of an instance that is hidden in a view. No real
+            //! modelview has a zero in its corner ([3][3]), so the shader
+            //! drops any instance that does instead of projecting it.
+            static inline vsg::mat4 hidden() {
+                return vsg::mat4(0.0f);
+            }
+        };
+
+        //! Packs the geometry of each line into one set of vertex and index
+        //! arrays, with one indexed indirect draw command per line. Lines that
+        //! share a geometry share its packed copy. Command i draws line i as
+        //! instance i (firstInstance), and draws nothing if line i has no geometry.
+        //! @param lines Geometry of each line, in instance order; may contain nulls
+        extern ROCKY_EXPORT vsg::ref_ptr<vsg::Geometry> packLineBatch(
+            const std::vector<const LineGeometryNode*>& lines);
+
         struct LineStyleDetail
         {
             LineDrawList drawList;
             vsg::ref_ptr<vsg::BindDescriptorSet> bind;
             vsg::ref_ptr<vsg::Data> styleData;
             vsg::ref_ptr<vsg::DescriptorBuffer> styleUBO;
+            LineBatch batch;
 
             inline void recycle() {
                 drawList.clear();
                 bind = nullptr;
                 styleData = nullptr;
                 styleUBO = nullptr;
+                batch = {};
             }
 
         };
@@ -113,6 +173,9 @@ namespace ROCKY_NAMESPACE
             vsg::ref_ptr<vsg::Node> root;
             vsg::ref_ptr<LineGeometryNode> geomNode;
 
+            // changes whenever the geometry does, so batches know to repack it
+            std::uint32_t revision = 0;
+
             inline void recycle() {
                 root = nullptr;
                 geomNode = nullptr;
@@ -147,6 +210,17 @@ namespace ROCKY_NAMESPACE
         //! Returns a mask of supported features for the given mesh
         //int featureMask(const Line&) const override;
 
+        //! Styles used by at least this many lines draw them all in one batch,
+        //! instead of one draw per line. Suits large numbers of lines whose
+        //! geometry rarely changes; a batch repacks after its lines change (see
+        //! minBatchRepackInterval). Zero disables batching. Set before the
+        //! system initializes.
+        unsigned minBatchSize = 0;
+
+        //! Minimum number of updates (frames) between two repacks of the same
+        //! batch. Lines that change in between draw one at a time until then.
+        unsigned minBatchRepackInterval = 30;
+
         //! One-time initialization of the system    
         void initialize(VSGContext&) override;
 
@@ -166,6 +240,15 @@ namespace ROCKY_NAMESPACE
         mutable vsg::ref_ptr<vsg::MatrixTransform> _tempMT;
         mutable float _devicePixelRatio = 1.0f;
 
+        // index of the batched pipeline in _pipelines, if there is one
+        static constexpr int BATCHED_PIPELINE = NUM_PIPELINES;
+        bool _batching = false;
+
+        // whether a line, geometry, or style changed since the batches were last checked
+        bool _batchesDirty = true;
+        std::uint64_t _updates = 0;
+        std::vector<std::uint32_t> _batchedViewIDs;
+
         inline vsg::PipelineLayout* getPipelineLayout(const Line& line) {
             return _pipelines[0].config->layout;
         }
@@ -179,6 +262,13 @@ namespace ROCKY_NAMESPACE
 
         // Called when a line style is found in the dirty list
         void createOrUpdateStyle(const LineStyle& style, detail::LineStyleDetail& styleDetail);
+
+        // Repacks any batch whose lines changed
+        void updateBatches(entt::registry& reg, VSGContext& context);
+
+        // Packs a style's lines into its batch
+        void createBatch(entt::registry& reg, detail::LineStyleDetail& styleDetail,
+            std::vector<detail::LineBatch::Member>&& members, VSGContext& context);
     };
 
 
@@ -1,4 +1,5 @@
 #version 450
+#pragma import_defines(ROCKY_LINE_BATCHED)
 
 // vsg push constants
 layout(push_constant) uniform PushConstants {
@@ -6,6 +7,16 @@ layout(push_constant) uniform PushConstants {
     mat4 modelview;
 } pc;
 
+#if defined(ROCKY_LINE_BATCHED)
+// rocky::detail::LineBatch; each line's draw passes its instance as firstInstance
+layout(set = 0, binding = 2) readonly buffer LineBatch {
+    mat4 modelview[];
+} batch;
+#define line_modelview batch.modelview[gl_InstanceIndex]
+#else
+#define line_modelview pc.modelview
+#endif
+
 // input vertex attributes
 layout(location = 0) in vec3 in_vertex;
 layout(location = 1) in vec3 in_vertex_prev;
@@ -63,6 +74,16 @@ vec3 apply_depth_offset(in vec3 vertex, float offset, float n)
 
 void main()
 {
+#if defined(ROCKY_LINE_BATCHED)
+    // a line hidden in this view has an all-zero modelview (LineBatch::hidden);
+    // put it outside the clip volume instead of dividing by a zero w below
+    if (line_modelview[3][3] == 0.0)
+    {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        return;
+    }
+#endif
+
     bool perVertexColor = (line.style.perVertexMask & 0x1) != 0;
 
     vary.color = perVertexColor ? in_color : line.style.color;
@@ -94,15 +115,15 @@ void main()
     float bias = line.style.depthOffset;
     float nearz = -pc.projection[3][2] / (pc.projection[2][2] + 1.0);
 
-    vec4 curr_view = pc.modelview * vec4(in_vertex, 1);
+    vec4 curr_view = line_modelview * vec4(in_vertex, 1);
     curr_view.xyz  = apply_depth_offset(curr_view.xyz, bias, nearz);
     vec4 curr_clip = pc.projection * curr_view;
 
-    vec4 prev_view = pc.modelview * vec4(in_vertex_prev, 1);
+    vec4 prev_view = line_modelview * vec4(in_vertex_prev, 1);
     prev_view.xyz  = apply_depth_offset(prev_view.xyz, bias, nearz);
     vec4 prev_clip = pc.projection * prev_view;
 
-    vec4 next_view = pc.modelview * vec4(in_vertex_next, 1);
+    vec4 next_view = line_modelview * vec4(in_vertex_next, 1);
     next_view.xyz  = apply_depth_offset(next_view.xyz, bias, nearz);
     vec4 next_clip = pc.projection * next_view;
 
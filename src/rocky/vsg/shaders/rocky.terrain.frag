@@ -2,7 +2,7 @@
 
 #extension GL_EXT_fragment_shader_barycentric : enable
 
-#pragma import_defines(ROCKY_HAS_VK_BARYCENTRIC_EXTENSION)
+#pragma import_defines(ROCKY_HAS_VK_BARYCENTRIC_EXTENSION, ROCKY_TILE_TABLE)
 
 layout(push_constant) uniform PushConstants {
     mat4 projection;
@@ -23,7 +23,14 @@ layout(set = 0, binding = 9) uniform TerrainData {
     float lighting;
 } settings;
 
+#if defined(ROCKY_TILE_TABLE)
+layout(constant_id = 0) const int tile_table_size = 1;
+layout(set = 0, binding = 11) uniform sampler2D color_textures[tile_table_size];
+layout(location = 3) flat in int tile_index;
+#define color_tex color_textures[tile_index]
+#else
 layout(set = 0, binding = 11) uniform sampler2D color_tex;
+#endif
 
 #include "rocky.lighting.frag.glsl"
 
@@ -1,13 +1,40 @@
 #version 450
-#pragma import_defines(ROCKY_ATMOSPHERE)
-
-layout(set = 0, binding = 10) uniform sampler2D elevation_tex;
+#pragma import_defines(ROCKY_ATMOSPHERE, ROCKY_TILE_TABLE)
 
 layout(push_constant) uniform PushConstants {
     mat4 projection;
     mat4 modelview;
 } pc;
 
+#if defined(ROCKY_TILE_TABLE)
+
+// see rocky::TerrainTileTable; each tile's draw passes its slot as firstInstance
+layout(constant_id = 0) const int tile_table_size = 1;
+
+struct TileData {
+    mat4 elevation_matrix;
+    mat4 color_matrix;
+    mat4 model_matrix;
+    float min_height;
+    float max_height;
+    float padding[2];
+};
+
+layout(set = 0, binding = 10) uniform sampler2D elevation_textures[tile_table_size];
+
+layout(set = 0, binding = 13) readonly buffer TileTable {
+    TileData tiles[];
+};
+
+#define tile tiles[gl_InstanceIndex]
+#define elevation_tex elevation_textures[gl_InstanceIndex]
+
+layout(location = 3) flat out int tile_index;
+
+#else
+
+layout(set = 0, binding = 10) uniform sampler2D elevation_tex;
+
 // see rocky::TerrainTileDescriptors
 layout(set = 0, binding = 13) uniform TileData {
     mat4 elevation_matrix;
@@ -18,6 +45,8 @@ layout(set = 0, binding = 13) uniform TileData {
     float padding[2];
 } tile;
 
+#endif
+
 // input vertex attributes
 layout(location = 0) in vec3 in_vertex;
 layout(location = 1) in vec3 in_normal;
@@ -77,4 +106,8 @@ void main()
     vary.vertexView = position_view.xyz / position_view.w;
     
     gl_Position = pc.projection * position_view;
+
+#if defined(ROCKY_TILE_TABLE)
+    tile_index = gl_InstanceIndex;
+#endif
 }
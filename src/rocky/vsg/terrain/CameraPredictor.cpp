@@ -0,0 +1,176 @@
+/**
+ * rocky c++
+ * Copyright 2025 Pelican Mapping
+ * MIT License
+ */
+#include "CameraPredictor.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace ROCKY_NAMESPACE;
+
+namespace
+{
+    // enough history to smooth out frame time jitter without lagging far behind a turn
+    constexpr std::size_t maxSamples = 8;
+}
+
+void
+CameraPredictor::sample(const vsg::dvec3& eye, double time)
+{
+    std::scoped_lock lock(_mutex);
+
+    // a second sample in the same frame (from another view, say) replaces the first
+    if (!_samples.empty() && time <= _samples.back().time)
+    {
+        _samples.back().eye = eye;
+        return;
+    }
+
+    _samples.emplace_back(Waypoint{ eye, time });
+
+    while (_samples.size() > maxSamples)
+        _samples.pop_front();
+
+    // the path is over once the camera passes its last waypoint.
+    if (!_path.empty() && time > _path.back().time)
+    {
+        _path.clear();
+        _course = {};
+        ++_revision;
+    }
+
+    if (_path.empty())
+    {
+        auto v = velocity();
+        auto speed = vsg::length(v);
+
+        if (speed >= minSpeed)
+        {
+            auto dir = v / speed;
+            if (vsg::length(_course) == 0.0 ||
+                std::acos(std::clamp(vsg::dot(dir, _course), -1.0, 1.0)) > courseChangeAngle)
+            {
+                _course = dir;
+                ++_revision;
+            }
+        }
+        else if (vsg::length(_course) > 0.0)
+        {
+            // came to a stop
+            _course = {};
+            ++_revision;
+        }
+    }
+}
+
+void
+CameraPredictor::setPath(const std::vector<Waypoint>& path)
+{
+    std::scoped_lock lock(_mutex);
+    _path = path;
+    _course = {};
+    ++_revision;
+}
+
+void
+CameraPredictor::clearPath()
+{
+    std::scoped_lock lock(_mutex);
+    if (!_path.empty())
+    {
+        _path.clear();
+        _course = {};
+        ++_revision;
+    }
+}
+
+std::vector<vsg::dvec3>
+CameraPredictor::predict(double horizon, unsigned count) const
+{
+    std::scoped_lock lock(_mutex);
+
+    std::vector<vsg::dvec3> result;
+
+    if (_samples.empty() || count == 0 || horizon <= 0.0)
+        return result;
+
+    auto& latest = _samples.back();
+
+    if (!_path.empty())
+    {
+        result.reserve(count);
+
+        for (unsigned i = 1; i <= count; ++i)
+        {
+            double t = latest.time + horizon * (double)i / (double)count;
+
+            auto next = std::find_if(_path.begin(), _path.end(),
+                [t](const Waypoint& w) { return w.time >= t; });
+
+            if (next == _path.begin())
+            {
+                result.emplace_back(next->eye);
+            }
+            else if (next == _path.end())
+            {
+                // parked at the end of the path; no need to repeat it
+                result.emplace_back(_path.back().eye);
+                break;
+            }
+            else
+            {
+                auto& prev = *(next - 1);
+                double dt = next->time - prev.time;
+                double a = dt > 0.0 ? (t - prev.time) / dt : 1.0;
+                result.emplace_back(prev.eye + (next->eye - prev.eye) * a);
+            }
+        }
+    }
+    else
+    {
+        auto v = velocity();
+        if (vsg::length(v) >= minSpeed)
+        {
+            result.reserve(count);
+            for (unsigned i = 1; i <= count; ++i)
+            {
+                result.emplace_back(latest.eye + v * (horizon * (double)i / (double)count));
+            }
+        }
+    }
+
+    return result;
+}
+
+double
+CameraPredictor::frameTime() const
+{
+    std::scoped_lock lock(_mutex);
+
+    if (_samples.size() < 2)
+        return 0.0;
+
+    return (_samples.back().time - _samples.front().time) / (double)(_samples.size() - 1);
+}
+
+std::uint64_t
+CameraPredictor::revision() const
+{
+    std::scoped_lock lock(_mutex);
+    return _revision;
+}
+
+vsg::dvec3
+CameraPredictor::velocity() const
+{
+    if (_samples.size() < 2)
+        return {};
+
+    auto& first = _samples.front();
+    auto& last = _samples.back();
+    double dt = last.time - first.time;
+
+    return dt > 0.0 ? (last.eye - first.eye) / dt : vsg::dvec3();
+}
@@ -0,0 +1,71 @@
+/**
+ * rocky c++
+ * Copyright 2025 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+
+#include <rocky/vsg/Common.h>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace ROCKY_NAMESPACE
+{
+    /**
+     * Predicts where the camera is headed, so the terrain can page in tiles
+     * before they come into view.
+     *
+     * The prediction follows a known path when there is one (like a viewpoint
+     * animation in the MapManipulator) and otherwise extrapolates the camera's
+     * recent velocity. Times are in seconds, positions in world coordinates.
+     */
+    class ROCKY_EXPORT CameraPredictor
+    {
+    public:
+        struct Waypoint
+        {
+            vsg::dvec3 eye;
+            double time = 0.0;
+        };
+
+        //! Records the camera's eye position at a point in time. Call once per frame.
+        void sample(const vsg::dvec3& eye, double time);
+
+        //! Installs a known camera path, which takes precedence over the
+        //! camera's velocity until the last waypoint passes.
+        //! @param path Waypoints in increasing time order
+        void setPath(const std::vector<Waypoint>& path);
+
+        //! Removes the known path, if any.
+        void clearPath();
+
+        //! Predicts eye positions over a window of time following the latest sample.
+        //! @param horizon Seconds to look ahead
+        //! @param count Number of evenly spaced positions to return
+        //! @return Predicted positions, nearest first; empty if the camera is at rest
+        std::vector<vsg::dvec3> predict(double horizon, unsigned count) const;
+
+        //! Average time between samples, in seconds
+        double frameTime() const;
+
+        //! Changes whenever the prediction changes course. Work queued for an
+        //! earlier prediction is probably wasted once this changes.
+        std::uint64_t revision() const;
+
+        //! Change in the direction of travel (radians) that counts as a new course.
+        double courseChangeAngle = 0.5;
+
+        //! Slowest speed (m/s) that counts as moving.
+        double minSpeed = 0.01;
+
+    private:
+        mutable std::mutex _mutex;
+        std::deque<Waypoint> _samples;
+        std::vector<Waypoint> _path;
+        std::uint64_t _revision = 0;
+        vsg::dvec3 _course;
+
+        vsg::dvec3 velocity() const;
+    };
+}
@@ -0,0 +1,179 @@
+/**
+ * rocky c++
+ * Copyright 2025 Pelican Mapping
+ * MIT License
+ */
+#include "GeometryArena.h"
+
+#undef LC
+#define LC "[GeometryArena] "
+
+using namespace ROCKY_NAMESPACE;
+
+namespace
+{
+    // The arena each recording thread last bound, and the command buffer it
+    // bound it into. Draws only happen on the thread recording the buffer.
+    thread_local const GeometryArena* s_boundArena = nullptr;
+    thread_local const void* s_boundTo = nullptr;
+}
+
+GeometryArena::Entry::~Entry()
+{
+    if (_arena)
+        _arena->release(*this);
+}
+
+GeometryArena::GeometryArena(
+    std::uint32_t capacity,
+    std::uint32_t verticesPerGeometry,
+    std::uint32_t numArrays,
+    vsg::ref_ptr<vsg::ushortArray> indices) :
+
+    _capacity(capacity),
+    _verticesPerGeometry(verticesPerGeometry),
+    _numArrays(numArrays)
+{
+    // hand out the low slots first
+    _free.reserve(_capacity);
+    for (auto slot = _capacity; slot > 0; --slot)
+        _free.push_back(slot - 1);
+
+    // The full-size arrays only exist to size the buffers; geometries upload
+    // their own vertices into their slots, so don't keep them around after compile.
+    vsg::DataList arrays;
+    for (unsigned i = 0; i < _numArrays; ++i)
+    {
+        auto array = vsg::vec3Array::create(_capacity * _verticesPerGeometry);
+        array->properties.dataVariance = vsg::STATIC_DATA_UNREF_AFTER_TRANSFER;
+        arrays.emplace_back(array);
+    }
+
+    _bindVertices = vsg::BindVertexBuffers::create(0, arrays);
+    _bindIndices = vsg::BindIndexBuffer::create(indices);
+}
+
+vsg::ref_ptr<GeometryArena::Entry>
+GeometryArena::add(const vsg::DataList& arrays, VSGContext& context)
+{
+    if (arrays.size() != _numArrays)
+        return {};
+
+    for (auto& array : arrays)
+    {
+        if (!array || array->dataSize() != _verticesPerGeometry * sizeof(vsg::vec3))
+            return {};
+    }
+
+    // Compile on first use, outside the lock: compiling waits on the compile
+    // queue, and the lock only ever covers slot bookkeeping. Anyone else
+    // arriving meanwhile waits here for the outcome.
+    std::call_once(_compileOnce, [&]()
+        {
+            auto binds = vsg::Objects::create();
+            binds->addChild(_bindVertices);
+            binds->addChild(_bindIndices);
+            auto cr = context->compile(binds);
+
+            bool failed =
+                cr.result != VK_SUCCESS ||
+                _bindVertices->arrays.size() != _numArrays;
+
+            for (auto& target : _bindVertices->arrays)
+                failed = failed || !target || !target->buffer;
+
+            if (failed)
+                Log()->warn(LC "Failed to compile the geometry arena; tiles will use their own buffers");
+
+            std::scoped_lock lock(_mutex);
+            _failed = failed;
+            _compiled = !failed;
+        });
+
+    std::uint32_t slot = 0;
+    {
+        std::scoped_lock lock(_mutex);
+
+        if (_failed || _free.empty())
+            return {};
+
+        slot = _free.back();
+        _free.pop_back();
+    }
+
+    auto entry = Entry::create();
+    entry->slot = slot;
+    entry->vertexOffset = (std::int32_t)(slot * _verticesPerGeometry);
+    entry->_arena = vsg::ref_ptr<GeometryArena>(this);
+
+    // copy each array into its slot in the matching buffer:
+    const VkDeviceSize stride = _verticesPerGeometry * sizeof(vsg::vec3);
+
+    vsg::BufferInfoList uploads;
+    uploads.reserve(_numArrays);
+
+    for (unsigned i = 0; i < _numArrays; ++i)
+    {
+        auto& target = _bindVertices->arrays[i];
+
+        auto upload = vsg::BufferInfo::create();
+        upload->buffer = target->buffer;
+        upload->offset = target->offset + entry->slot * stride;
+        upload->range = stride;
+        upload->data = arrays[i];
+        uploads.emplace_back(upload);
+    }
+
+    context->upload(uploads);
+
+    return entry;
+}
+
+void
+GeometryArena::release(Entry& entry)
+{
+    std::scoped_lock lock(_mutex);
+    _free.push_back(entry.slot);
+}
+
+std::uint32_t
+GeometryArena::leased() const
+{
+    std::scoped_lock lock(_mutex);
+    return _capacity - (std::uint32_t)_free.size();
+}
+
+std::size_t
+GeometryArena::bytes() const
+{
+    std::scoped_lock lock(_mutex);
+    return _compiled ? (std::size_t)_capacity * _verticesPerGeometry * _numArrays * sizeof(vsg::vec3) : 0u;
+}
+
+bool
+GeometryArena::needsBind(const void* commandBuffer) const
+{
+    if (s_boundArena == this && s_boundTo == commandBuffer)
+        return false;
+
+    s_boundArena = this;
+    s_boundTo = commandBuffer;
+    return true;
+}
+
+void
+GeometryArena::bind(vsg::CommandBuffer& commandBuffer) const
+{
+    if (needsBind(&commandBuffer))
+    {
+        _bindVertices->record(commandBuffer);
+        _bindIndices->record(commandBuffer);
+    }
+}
+
+void
+GeometryArena::unbind()
+{
+    s_boundArena = nullptr;
+    s_boundTo = nullptr;
+}
@@ -0,0 +1,114 @@
+/**
+ * rocky c++
+ * Copyright 2025 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+
+#include <rocky/vsg/VSGContext.h>
+#include <mutex>
+#include <vector>
+
+namespace ROCKY_NAMESPACE
+{
+    /**
+     * Shared vertex storage for pooled terrain geometries.
+     *
+     * Every pooled tile geometry has the same number of vertices and uses the
+     * same index array, so the arena carves a fixed-size slot for each one out
+     * of a single large buffer per vertex attribute. A tile's draw reaches its
+     * slot through the draw's vertexOffset. Consecutive tile draws therefore
+     * share one set of vertex and index buffer binds, and the pool makes one
+     * big allocation instead of thousands of small ones.
+     *
+     * A slot goes back to the arena when the last geometry using it goes away.
+     * Geometries leave the scene through VSGContext::dispose, so no in-flight
+     * frame is still reading a slot by the time it's reused.
+     */
+    class ROCKY_EXPORT GeometryArena : public vsg::Inherit<vsg::Object, GeometryArena>
+    {
+    public:
+        //! A geometry's lease on one slot. The slot goes back to the arena
+        //! when the last reference to the entry goes away.
+        class Entry : public vsg::Inherit<vsg::Object, Entry>
+        {
+        public:
+            //! Index of the slot in the arena
+            std::uint32_t slot = 0;
+
+            //! First vertex of the slot, for the draw command's vertexOffset
+            std::int32_t vertexOffset = 0;
+
+            //! Arena holding the slot
+            inline const GeometryArena* arena() const {
+                return _arena.get();
+            }
+
+            ~Entry();
+
+        private:
+            vsg::ref_ptr<GeometryArena> _arena;
+            friend class GeometryArena;
+        };
+
+        //! Construct an arena.
+        //! @param capacity Number of geometries the arena can hold
+        //! @param verticesPerGeometry Number of vertices in every geometry
+        //! @param numArrays Number of vec3 vertex attribute arrays in every geometry
+        //! @param indices Index array that every geometry draws with
+        GeometryArena(
+            std::uint32_t capacity,
+            std::uint32_t verticesPerGeometry,
+            std::uint32_t numArrays,
+            vsg::ref_ptr<vsg::ushortArray> indices);
+
+        //! Leases a slot and queues the geometry's vertex arrays for upload into
+        //! it. The arena compiles itself on first use. Thread-safe.
+        //! @param arrays Vertex attribute arrays, one vec3 per vertex each
+        //! @return the new entry, or nullptr if the arrays don't fit the arena's
+        //!   layout, the arena is full, or it failed to compile
+        vsg::ref_ptr<Entry> add(const vsg::DataList& arrays, VSGContext& context);
+
+        //! Records the arena's vertex and index buffer binds, unless the
+        //! calling thread already bound them into this command buffer.
+        void bind(vsg::CommandBuffer& commandBuffer) const;
+
+        //! Whether a draw from this arena must bind it first, given what the
+        //! calling thread last bound into the command buffer. Assumes the
+        //! caller then binds it.
+        bool needsBind(const void* commandBuffer) const;
+
+        //! Forgets what the calling thread has bound. Call wherever something
+        //! else may have replaced the binds: another geometry's own binds, or
+        //! the start of a new recording.
+        static void unbind();
+
+        //! Number of geometries the arena can hold
+        inline std::uint32_t capacity() const {
+            return _capacity;
+        }
+
+        //! Number of slots currently leased
+        std::uint32_t leased() const;
+
+        //! Size of the vertex buffers in GPU memory
+        std::size_t bytes() const;
+
+    private:
+
+        std::uint32_t _capacity = 0;
+        std::uint32_t _verticesPerGeometry = 0;
+        std::uint32_t _numArrays = 0;
+
+        mutable std::mutex _mutex;
+        std::once_flag _compileOnce;
+        std::vector<std::uint32_t> _free;
+        bool _compiled = false;
+        bool _failed = false;
+
+        vsg::ref_ptr<vsg::BindVertexBuffers> _bindVertices;
+        vsg::ref_ptr<vsg::BindIndexBuffer> _bindIndices;
+
+        void release(Entry& entry);
+    };
+}
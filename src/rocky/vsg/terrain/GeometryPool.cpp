@@ -11,6 +11,84 @@
 
 using namespace ROCKY_NAMESPACE;
 
+vsg::ref_ptr<SharedGeometry>
+SharedGeometry::instance()
+{
+    auto copy = SharedGeometry::create();
+    copy->firstBinding = firstBinding;
+    copy->arrays = arrays;
+    copy->indices = indices;
+
+    for (auto& command : commands)
+    {
+        if (auto draw = command.cast<vsg::DrawIndexed>())
+        {
+            copy->commands.push_back(vsg::DrawIndexed::create(
+                draw->indexCount, draw->instanceCount, draw->firstIndex, draw->vertexOffset, draw->firstInstance));
+        }
+        else
+        {
+            copy->commands.push_back(command);
+        }
+    }
+
+    copy->hasConstraints = hasConstraints;
+    copy->verts = verts;
+    copy->normals = normals;
+    copy->uvs = uvs;
+    copy->indexArray = indexArray;
+    copy->arenaEntry = arenaEntry;
+
+    // keeps the original in the pool for as long as we exist
+    copy->source = vsg::ref_ptr<SharedGeometry>(this);
+
+    return copy;
+}
+
+void
+SharedGeometry::setFirstInstance(std::uint32_t value)
+{
+    for (auto& command : commands)
+    {
+        if (auto draw = command.cast<vsg::DrawIndexed>())
+            draw->firstInstance = value;
+    }
+}
+
+void
+SharedGeometry::compile(vsg::Context& context)
+{
+    // the arena compiles its own buffers
+    if (arenaEntry)
+    {
+        for (auto& command : commands)
+            command->compile(context);
+    }
+    else
+    {
+        Inherit::compile(context);
+    }
+}
+
+void
+SharedGeometry::record(vsg::CommandBuffer& commandBuffer) const
+{
+    if (arenaEntry)
+    {
+        arenaEntry->arena()->bind(commandBuffer);
+
+        for (auto& command : commands)
+            command->record(commandBuffer);
+    }
+    else
+    {
+        Inherit::record(commandBuffer);
+
+        // our own buffers just replaced whatever arena was bound
+        GeometryArena::unbind();
+    }
+}
+
 GeometryPool::GeometryPool(const SRS& renderingSRS)
 {
     _renderingSRS = renderingSRS;
@@ -77,6 +155,9 @@ GeometryPool::getPooledGeometry(const TileKey& tileKey, const Settings& settings
             // only store as a shared geometry if there are no constraints.
             if (out.valid()) //&& !meshEditor.hasEdits())
             {
+                if (_arenaSize > 0u)
+                    moveToArena(*out);
+
                 std::scoped_lock lock(_mutex);
                 _sharedGeometries.emplace(geomKey, out);
             }
@@ -92,11 +173,64 @@ GeometryPool::getPooledGeometry(const TileKey& tileKey, const Settings& settings
             progress);
     }
 
-    ROCKY_SOFT_ASSERT_AND_RETURN(out->indices, nullptr);
+    // a geometry in the arena draws with the arena's indices instead of its own
+    ROCKY_SOFT_ASSERT_AND_RETURN(out->indices || out->arenaEntry, nullptr);
 
     return out;
 }
 
+void
+GeometryPool::setArenaSize(std::uint32_t capacity, VSGContext context)
+{
+    std::scoped_lock lock(_mutex);
+    _arenaSize = capacity;
+    _arenaContext = context;
+    _arena = {};
+}
+
+void
+GeometryPool::moveToArena(SharedGeometry& geom) const
+{
+    vsg::DataList arrays;
+    for (auto& array : geom.arrays)
+        arrays.emplace_back(array->data);
+
+    vsg::ref_ptr<GeometryArena> arena;
+    {
+        std::scoped_lock lock(_mutex);
+        if (!_arena)
+        {
+            _arena = GeometryArena::create(_arenaSize, (std::uint32_t)geom.verts->size(), (std::uint32_t)arrays.size(), _defaultIndices);
+        }
+        arena = _arena;
+    }
+
+    auto entry = arena->add(arrays, _arenaContext);
+    if (!entry)
+    {
+        if (arena->leased() >= arena->capacity())
+        {
+            static std::once_flag warned;
+            std::call_once(warned, [&]() {
+                Log()->warn(LC "Geometry arena is full ({} geometries); increase geometryArenaSize", arena->capacity());
+                });
+        }
+        return;
+    }
+
+    // the draw now reaches into the arena, and the geometry keeps no buffers of its own
+    geom.arenaEntry = entry;
+    geom.arrays.clear();
+    geom.indices = {};
+    geom.commands = {
+        vsg::DrawIndexed::create(
+            (std::uint32_t)geom.indexArray->size(), // index count
+            1,                                      // instance count
+            0,                                      // first index
+            entry->vertexOffset,                    // vertex offset
+            0) };                                   // first instance
+}
+
 void
 GeometryPool::createKeyForTileKey(const TileKey& key, unsigned tileSize, GeometryKey& out) const
 {
@@ -397,6 +531,25 @@ GeometryPool::clear()
     _sharedGeometries.clear();
 }
 
+std::size_t
+GeometryPool::bytes() const
+{
+    std::scoped_lock lock(_mutex);
+
+    std::size_t total = _defaultIndices ? _defaultIndices->dataSize() : 0;
+
+    for (auto& entry : _sharedGeometries)
+    {
+        auto& geom = entry.second;
+        if (geom->verts) total += geom->verts->dataSize();
+        if (geom->normals) total += geom->normals->dataSize();
+        if (geom->uvs) total += geom->uvs->dataSize();
+        if (geom->indexArray && geom->indexArray != _defaultIndices) total += geom->indexArray->dataSize();
+    }
+
+    return total;
+}
+
 void
 GeometryPool::sweep(VSGContext& context)
 {
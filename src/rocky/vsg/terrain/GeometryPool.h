@@ -9,7 +9,8 @@
 #include <rocky/TileKey.h>
 #include <rocky/IOTypes.h>
 #include <rocky/vsg/VSGContext.h>
-#include <map>
+#include <rocky/vsg/terrain/GeometryArena.h>
+#include <unordered_map>
 
 #define VERTEX_VISIBLE       1 // draw it
 #define VERTEX_BOUNDARY      2 // vertex lies on a skirt boundary
@@ -23,7 +24,7 @@ namespace ROCKY_NAMESPACE
     class MeshEditor;
     class TerrainSettings;
 
-    class SharedGeometry : public vsg::Inherit<vsg::Geometry, SharedGeometry>
+    class ROCKY_EXPORT SharedGeometry : public vsg::Inherit<vsg::Geometry, SharedGeometry>
     {
     public:
         SharedGeometry() = default;
@@ -35,6 +36,30 @@ namespace ROCKY_NAMESPACE
         bool hasConstraints = false;
         vsg::ref_ptr<vsg::vec3Array> verts, normals, uvs; // originals
         vsg::ref_ptr<vsg::ushortArray> indexArray; // original indices
+
+        //! Makes a per-tile instance that shares this geometry's vertex and index
+        //! buffers but has its own draw command.
+        vsg::ref_ptr<SharedGeometry> instance();
+
+        //! Sets the firstInstance of the draw commands, which the terrain
+        //! shaders use to find the tile in the tile table.
+        void setFirstInstance(std::uint32_t value);
+
+        //! Pooled geometry this is an instance of, if any
+        vsg::ref_ptr<SharedGeometry> source;
+
+        //! Tile table slot the draw refers to, if any
+        vsg::ref_ptr<vsg::Object> lease;
+
+        //! Arena slot holding the vertices, if any. Geometries in an arena have
+        //! no buffers of their own; their draws bind the arena's instead.
+        vsg::ref_ptr<GeometryArena::Entry> arenaEntry;
+
+    public:
+
+        void compile(vsg::Context& context) override;
+
+        void record(vsg::CommandBuffer& commandBuffer) const override;
     };
 
 
@@ -95,6 +120,20 @@ namespace ROCKY_NAMESPACE
     };
 }
 
+namespace std {
+    // std::hash specialization for GeometryKey
+    template<> struct hash<rocky::GeometryKey> {
+        inline size_t operator()(const rocky::GeometryKey& k) const {
+            std::uint64_t h =
+                ((std::uint64_t)(std::uint32_t)k.lod << 40) ^
+                ((std::uint64_t)(std::uint32_t)k.tileY << 16) ^
+                ((std::uint64_t)k.size << 1) ^
+                (std::uint64_t)k.patch;
+            return std::hash<std::uint64_t>()(h);
+        }
+    };
+}
+
 
 namespace ROCKY_NAMESPACE
 {
@@ -113,13 +152,13 @@ namespace ROCKY_NAMESPACE
      * This object creates and returns geometries based on TileKeys, sharing instances
      * whenever possible.
      */
-    class GeometryPool
+    class ROCKY_EXPORT GeometryPool
     {
     public:
         //! Construct the geometry pool
         GeometryPool(const SRS& renderingSRS);
 
-        using SharedGeometries = std::map<GeometryKey, vsg::ref_ptr<SharedGeometry>>;
+        using SharedGeometries = std::unordered_map<GeometryKey, vsg::ref_ptr<SharedGeometry>>;
 
         struct Settings {
             uint32_t tileSize = 17u;
@@ -146,6 +185,19 @@ namespace ROCKY_NAMESPACE
         //! Number of geometries in the pool
         inline std::size_t size() const;
 
+        //! Approximate size of the vertex and index data in the pool. Each array
+        //! lives in CPU memory and again in GPU memory.
+        std::size_t bytes() const;
+
+        //! Carves pooled geometries out of one shared set of vertex buffers
+        //! (see GeometryArena) instead of giving each its own. Geometries that
+        //! don't fit fall back on their own buffers. Call before creating any geometry.
+        //! @param capacity Number of geometries the arena can hold; zero disables it
+        void setArenaSize(std::uint32_t capacity, VSGContext context);
+
+        //! Shared vertex storage, once the first pooled geometry creates it
+        inline vsg::ref_ptr<GeometryArena> arena() const;
+
         //! Whether to pool geometries with compatible keys.
         bool enabled = true;
 
@@ -159,6 +211,9 @@ namespace ROCKY_NAMESPACE
         mutable SharedGeometries _sharedGeometries;
         mutable vsg::ref_ptr<vsg::ushortArray> _defaultIndices;
         Settings _defaultIndicesSettings;
+        std::uint32_t _arenaSize = 0;
+        VSGContext _arenaContext;
+        mutable vsg::ref_ptr<GeometryArena> _arena;
 
         void createKeyForTileKey(
             const TileKey& tileKey,
@@ -170,6 +225,9 @@ namespace ROCKY_NAMESPACE
             const Settings& settings,
             Cancelable* progress) const;
 
+        // moves a new pooled geometry's vertices into the arena, if there's room
+        void moveToArena(SharedGeometry& geom) const;
+
         // builds a primitive set to use for any tile without a mask
         vsg::ref_ptr<vsg::ushortArray> createIndices(
             const Settings& settings) const;
@@ -180,5 +238,10 @@ namespace ROCKY_NAMESPACE
         return _sharedGeometries.size();
     }
 
+    vsg::ref_ptr<GeometryArena> GeometryPool::arena() const {
+        std::scoped_lock lock(_mutex);
+        return _arena;
+    }
+
 }
 
@@ -67,7 +67,8 @@ SurfaceNode::recomputeBound()
         _proxyGeom = vsg::Geometry::create();
         _proxyGeom->assignArrays(vsg::DataList{ _proxyVerts });
         _proxyGeom->assignIndices(geom->indexArray);
-        _proxyGeom->commands = geom->commands;
+        // the pooled draw may point into the geometry arena, so draw the proxy on its own
+        _proxyGeom->commands = { vsg::DrawIndexed::create((std::uint32_t)geom->indexArray->size(), 1, 0, 0, 0) };
     }
 
     if (_elevationRaster)
@@ -43,6 +43,11 @@ namespace ROCKY_NAMESPACE
         //! Force a recompute of the bounding box and culling information
         const vsg::dsphere& recomputeBound();
 
+        //! Size of the vertex data this surface keeps for intersections
+        inline std::size_t proxyBytes() const {
+            return _proxyVerts ? _proxyVerts->dataSize() : 0;
+        }
+
         vsg::dsphere worldBoundingSphere;
         vsg::dbox localbbox;
 
@@ -44,6 +44,11 @@ TerrainEngine::TerrainEngine(
     {
         geometryPool.enabled = false;
     }
+
+    if (settings.geometryArenaSize.value() > 0u)
+    {
+        geometryPool.setArenaSize(settings.geometryArenaSize.value(), context);
+    }
 }
 
 
@@ -60,9 +65,14 @@ TerrainEngine::createTile(const TileKey& key, vsg::ref_ptr<TerrainTileNode> pare
     // Get a shared geometry from the pool that corresponds to this tile key:
     auto geometry = geometryPool.getPooledGeometry(key, geomSettings, nullptr);
 
+    // with a tile table, each tile needs its own draw command to carry its slot
+    if (geometry && stateFactory.tileTable)
+        geometry = geometry->instance();
+
     // Make the new terrain tile
     auto tile = TerrainTileNode::create();
     tile->key = key;
+    tile->id = key.id();
     tile->renderModel.descriptors = stateFactory.defaultTileDescriptors;
     tile->doNotExpire = (parent == nullptr);
     tile->stategroup = vsg::StateGroup::create();
@@ -82,8 +92,8 @@ TerrainEngine::createTile(const TileKey& key, vsg::ref_ptr<TerrainTileNode> pare
     // Generate its state objects:
     tile->renderModel = stateFactory.updateRenderModel(tile->renderModel, {}, context);
 
-    // install the bind command.
-    tile->stategroup->add(tile->renderModel.descriptors.bind);
+    // install the bind command (or table slot).
+    stateFactory.applyRenderModel(*tile, context);
 
     return tile;
 }
@@ -101,5 +111,8 @@ bool TerrainEngine::update(VSGContext context)
         changes = true;
     }
 
+    // tile priorities depend on the camera, so refresh them once per frame
+    pool->refresh_priorities();
+
     return changes;
 }
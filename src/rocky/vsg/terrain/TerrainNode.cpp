@@ -195,6 +195,24 @@ TerrainNode::setMap(Map::Ptr in_map, const Profile& in_profile, const SRS& in_re
 void
 TerrainNode::reset(VSGContext context)
 {
+    // the tile table changes the pipeline layout, so rebuild the terrain state to match
+    if (tileTableSize.value() != _tileTableSize)
+    {
+        _tileTableSize = tileTableSize.value();
+
+        for (auto& command : stateCommands)
+            context->dispose(command);
+
+        stateCommands.clear();
+
+        terrainState.setTileTableSize(tileTableSize.value(), context);
+
+        if (!terrainState.setupTerrainStateGroup(*this, context))
+        {
+            status = Failure("Failed to set up terrain state group");
+        }
+    }
+
     // reset all profile nodes:
     for (auto& child : this->children)
     {
@@ -238,6 +256,62 @@ bool
 TerrainNode::update(VSGContext context)
 {
     bool changes = false;
+
+    // hand the latest camera prediction to the pagers
+    const bool prefetching = prefetchFrames.value() > 0;
+    if (prefetching || _prefetching)
+    {
+        TerrainTilePager::Prefetch prefetch;
+
+        // switching on or off starts a new course too
+        bool newCourse = prefetching != _prefetching;
+
+        if (prefetching)
+        {
+            std::scoped_lock lock(_predictionsMutex);
+
+            // only views that recorded in the latest frame; a closed view stops sampling
+            std::uint64_t latest = 0u;
+            for (auto& p : _predictions)
+            {
+                if (p && p->lastSampleFrame != ViewPrediction::never)
+                    latest = std::max(latest, p->lastSampleFrame.load());
+            }
+
+            for (auto& p : _predictions)
+            {
+                if (!p || p->lastSampleFrame == ViewPrediction::never || p->lastSampleFrame + 1 < latest)
+                    continue;
+
+                auto& view = prefetch.views.emplace_back();
+                view.eyes = p->predictor.predict(
+                    (double)prefetchFrames.value() * p->predictor.frameTime(),
+                    std::min(prefetchFrames.value(), 8u));
+                view.lodScale = p->lodScale;
+                view.viewportHeight = p->viewportHeight;
+
+                if (p->predictor.revision() != p->revision)
+                {
+                    p->revision = p->predictor.revision();
+                    newCourse = true;
+                }
+            }
+        }
+
+        // Turned off, this hands over no views on a new revision, which stops
+        // the pagers and cancels what they queued for the old course.
+        if (newCourse)
+            ++_prefetchRevision;
+
+        prefetch.revision = _prefetchRevision;
+        _prefetching = prefetching;
+
+        for (auto& child : children)
+        {
+            if (auto c = child.cast<TerrainProfileNode>())
+                c->tiles().setPrefetch(TerrainTilePager::Prefetch(prefetch));
+        }
+    }
     for (auto& child : children)
     {
         if (auto c = child.cast<TerrainProfileNode>())
@@ -247,9 +321,77 @@ TerrainNode::update(VSGContext context)
     // check for settings change
     terrainState.updateSettings(*this);
 
+    // bring the tile table up to date before the next record
+    if (terrainState.tileTable)
+        terrainState.tileTable->update(context);
+
     return changes;
 }
 
+void
+TerrainNode::accept(vsg::RecordTraversal& rv) const
+{
+    auto frame = rv.getFrameStamp()->frameCount;
+
+    // each view samples its own camera, once per frame
+    ViewPrediction* p = prefetchFrames.value() > 0 ? &prediction(rv.getCommandBuffer()->viewID) : nullptr;
+    if (p && p->lastSampleFrame.exchange(frame) != frame)
+    {
+        auto state = rv.getState();
+        auto inverseView = vsg::inverse(state->modelviewMatrixStack.top());
+        auto eye = inverseView * vsg::dvec3(0.0, 0.0, 0.0);
+
+        // the tiles subdivide based on the LOD distance, so find its ratio to the
+        // real distance using a point straight ahead of the camera
+        auto ahead = inverseView * vsg::dvec3(0.0, 0.0, -1.0);
+        p->lodScale = std::max(state->lodDistance(vsg::dsphere(ahead, 0.0)), 0.0);
+
+        auto& vds = state->_commandBuffer->viewDependentState;
+        if (vds && vds->viewportData && vds->viewportData->size() > 0)
+            p->viewportHeight = (double)vds->viewportData->at(0)[3];
+
+        auto time = std::chrono::duration<double>(rv.getFrameStamp()->time.time_since_epoch()).count();
+        p->predictor.sample(eye, time);
+    }
+
+    // Tiles bind the geometry arena once and then skip it for as long as it
+    // stays bound. Outside this traversal, anything may rebind the buffers.
+    GeometryArena::unbind();
+    Inherit::accept(rv);
+    GeometryArena::unbind();
+}
+
+TerrainNode::ViewPrediction&
+TerrainNode::prediction(std::uint32_t viewID) const
+{
+    std::scoped_lock lock(_predictionsMutex);
+
+    if (viewID >= _predictions.size())
+        _predictions.resize(viewID + 1);
+
+    if (!_predictions[viewID])
+        _predictions[viewID] = std::make_unique<ViewPrediction>();
+
+    return *_predictions[viewID];
+}
+
+TerrainTilePager::Usage
+TerrainNode::usage() const
+{
+    TerrainTilePager::Usage total;
+    for (auto& child : children)
+    {
+        if (auto c = child.cast<TerrainProfileNode>())
+        {
+            auto usage = c->tiles().usage();
+            total.tiles += usage.tiles;
+            total.memory += usage.memory;
+            total.evicted += usage.evicted;
+        }
+    }
+    return total;
+}
+
 const TerrainSettings&
 TerrainProfileNode::settings() const
 {
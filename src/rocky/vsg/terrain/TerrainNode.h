@@ -10,9 +10,13 @@
 #include <rocky/vsg/terrain/TerrainTileHost.h>
 #include <rocky/vsg/terrain/TerrainState.h>
 #include <rocky/vsg/terrain/TerrainTilePager.h>
+#include <rocky/vsg/terrain/CameraPredictor.h>
 #include <rocky/Result.h>
 #include <rocky/Profile.h>
 #include <rocky/Layer.h>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace ROCKY_NAMESPACE
 {
@@ -97,6 +101,17 @@ namespace ROCKY_NAMESPACE
         //! @return true if any updates were applied
         bool update(VSGContext context);
 
+        //! Resident tiles and approximate memory usage, summed over all profiles
+        TerrainTilePager::Usage usage() const;
+
+        //! Predicts a view's camera motion for prefetching tiles (see prefetchFrames).
+        //! The terrain samples each view's camera once per frame as it records;
+        //! set a path on it to prefetch for a known camera animation.
+        //! @param viewID ID of the view (vsg::View::viewID)
+        CameraPredictor& cameraPredictor(std::uint32_t viewID = 0) {
+            return prediction(viewID).predictor;
+        }
+
         //! Map containing data model for the terrain
         std::shared_ptr<const Map> map;
 
@@ -118,10 +133,34 @@ namespace ROCKY_NAMESPACE
         //! Serialize to JSON
         std::string to_json() const;
 
+    public:
+
+        void accept(vsg::RecordTraversal& rv) const override;
+
     private:
 
         Result<> createProfiles(VSGContext);
         CallbackSubs _callbacks;
         std::vector<Layer::Ptr> _terrainLayers;
+        unsigned _tileTableSize = 0u;
+
+        // one view's camera, as sampled by its record traversal
+        struct ViewPrediction
+        {
+            static constexpr std::uint64_t never = ~std::uint64_t(0);
+
+            CameraPredictor predictor;
+            std::atomic<std::uint64_t> lastSampleFrame = { never };
+            std::atomic<double> lodScale = { 1.0 };
+            std::atomic<double> viewportHeight = { 0.0 };
+            std::uint64_t revision = 0u; // predictor revision last handed to the pagers
+        };
+
+        mutable std::mutex _predictionsMutex;
+        mutable std::vector<std::unique_ptr<ViewPrediction>> _predictions; // by view ID
+        bool _prefetching = false;
+        std::uint64_t _prefetchRevision = 0u; // revision handed to the pagers
+
+        ViewPrediction& prediction(std::uint32_t viewID) const;
     };
 }
@@ -25,6 +25,13 @@ TerrainSettings::from_json(std::string_view JSON)
     get_to(j, "skirtRatio", skirtRatio);
     get_to(j, "backgroundColor", backgroundColor);
     get_to(j, "concurrency", concurrency);
+    get_to(j, "loadBatchSize", loadBatchSize);
+    get_to(j, "layerConcurrency", layerConcurrency);
+    get_to(j, "textureCompression", textureCompression);
+    get_to(j, "tileTableSize", tileTableSize);
+    get_to(j, "geometryArenaSize", geometryArenaSize);
+    get_to(j, "memoryBudget", memoryBudget);
+    get_to(j, "prefetchFrames", prefetchFrames);
     get_to(j, "wireOverlay", wireOverlay);
     get_to(j, "lighting", lighting);
 
@@ -44,6 +51,13 @@ TerrainSettings::to_json() const
     set(j, "skirtRatio", skirtRatio);
     set(j, "backgroundColor", backgroundColor);
     set(j, "concurrency", concurrency);
+    set(j, "loadBatchSize", loadBatchSize);
+    set(j, "layerConcurrency", layerConcurrency);
+    set(j, "textureCompression", textureCompression);
+    set(j, "tileTableSize", tileTableSize);
+    set(j, "geometryArenaSize", geometryArenaSize);
+    set(j, "memoryBudget", memoryBudget);
+    set(j, "prefetchFrames", prefetchFrames);
     set(j, "wireOverlay", wireOverlay);
     set(j, "lighting", lighting);
     return j.dump();
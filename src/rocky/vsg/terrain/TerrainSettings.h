@@ -57,17 +57,50 @@ namespace ROCKY_NAMESPACE
         //! Number of threads dedicated to loading terrain data
         option<unsigned> concurrency = 6;
 
+        //! Maximum number of sibling tiles to load together in a single job.
+        //! Siblings share most of their source data (ancestor fallbacks,
+        //! reprojected source tiles), which a batch fetches only once.
+        //! A value of 1 loads every tile in its own job.
+        option<unsigned> loadBatchSize = 4;
+
+        //! Maximum number of map layers to fetch at once while loading
+        //! a single tile. A value of 1 fetches the layers one at a time.
+        option<unsigned> layerConcurrency = 4;
+
+        //! Block compression for terrain imagery, applied in the loader threads
+        //! before upload: "none", "bc1" (8:1, 1-bit alpha) or "bc3" (4:1, full alpha).
+        //! Falls back to "none" on a device without BC texture support. Compressed
+        //! tiles have no mipmaps.
+        option<std::string> textureCompression = { "none" };
+
+        //! Number of slots in the terrain tile table. When non-zero, all tiles
+        //! share one descriptor set of texture arrays instead of binding one
+        //! descriptor set each. It must cover the number of resident tiles;
+        //! tiles that don't fit render as untextured placeholders. Takes
+        //! effect when the terrain resets. Zero disables the table, as does a
+        //! device without dynamic indexing of sampled image arrays.
+        option<unsigned> tileTableSize = 0;
+
+        //! Number of tile geometries to hold in one shared set of vertex
+        //! buffers. Tile draws then bind those buffers once per frame instead
+        //! of once per tile. Pooled geometries that don't fit get buffers of
+        //! their own. Takes effect when the terrain resets. Zero disables it.
+        option<unsigned> geometryArenaSize = 0;
+
+        //! Approximate memory budget for resident terrain tiles, in megabytes.
+        //! When the tiles outgrow it, the pager pages out the least recently
+        //! visible leaf tiles and holds off on subdividing. Zero means no limit.
+        option<unsigned> memoryBudget = 0;
+
+        //! Number of frames ahead to predict the camera's motion and page in
+        //! the tiles it will need, at a lower priority than the tiles it needs
+        //! now. Zero disables prefetching.
+        option<unsigned> prefetchFrames = 0;
+
         //! Whether to render a wireframe overlay on the terrain
         option<bool> wireOverlay = false;
 
         //! Whether to apply lighting to the terrain surface
         option<bool> lighting = false;
-
-    public: // internal runtime settings, not serialized.
-
-        //! TEMPORARY.
-        //! To deal with multi-threaded Record (b/c of multiple command graphs)
-        //! without using an unnecessary lock in the single-threaded case
-        bool supportMultiThreadedRecord = false;
     };
 }
@@ -7,6 +7,7 @@
 #include "TerrainNode.h"
 #include "TerrainTileNode.h"
 #include "TerrainSettings.h"
+#include "GeometryPool.h"
 #include "../VSGUtils.h"
 #include "../PipelineState.h"
 
@@ -18,6 +19,8 @@
 #include <vsg/state/BindDescriptorSet.h>
 #include <vsg/state/ViewDependentState.h>
 
+#include <mutex>
+
 #define TERRAIN_VERT_SHADER "shaders/rocky.terrain.vert"
 #define TERRAIN_FRAG_SHADER "shaders/rocky.terrain.frag"
 
@@ -44,6 +47,22 @@
 
 using namespace ROCKY_NAMESPACE;
 
+namespace
+{
+    // Viewer::compile will not compile descriptors directly, so we need a holder that
+    // implements Compilable...
+    struct CompileDescriptors : public vsg::Inherit<vsg::Compilable, CompileDescriptors>
+    {
+        vsg::Descriptors descriptors;
+
+        void compile(vsg::Context& context) override {
+            for (auto& descriptor : descriptors)
+                if (descriptor)
+                    descriptor->compile(context);
+        }
+    };
+}
+
 TerrainState::TerrainState(VSGContext context)
 {
     // set up the texture samplers and placeholder images we will use to render terrain.
@@ -83,6 +102,19 @@ TerrainState::createDefaultDescriptors(VSGContext& context)
     if (context->sharedObjects)
         context->sharedObjects->share(texturedefs.color.sampler);
 
+    // same, minus the mipmaps
+    texturedefs.color.compressedSampler = vsg::Sampler::create();
+    texturedefs.color.compressedSampler->minFilter = VK_FILTER_LINEAR;
+    texturedefs.color.compressedSampler->magFilter = VK_FILTER_LINEAR;
+    texturedefs.color.compressedSampler->maxLod = 0;
+    texturedefs.color.compressedSampler->addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    texturedefs.color.compressedSampler->addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    texturedefs.color.compressedSampler->addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    texturedefs.color.compressedSampler->anisotropyEnable = VK_TRUE;
+    texturedefs.color.compressedSampler->maxAnisotropy = 4.0f;
+    if (context->sharedObjects)
+        context->sharedObjects->share(texturedefs.color.compressedSampler);
+
     texturedefs.elevation = { ELEVATION_TEX_NAME, ELEVATION_TEX_BINDING, vsg::Sampler::create(), {} };
     texturedefs.elevation.sampler->maxLod = 16;
     texturedefs.elevation.sampler->minFilter = VK_FILTER_LINEAR;
@@ -176,6 +208,14 @@ TerrainState::createShaderSet(VSGContext& context) const
         return { };
     }
 
+    if (_tileTableSize > 0)
+    {
+        // the table size dimensions the texture arrays in the shaders (constant_id = 0)
+        auto tableSize = vsg::intValue::create((int)_tileTableSize);
+        vertexShader->specializationConstants = { { 0, tableSize } };
+        fragmentShader->specializationConstants = { { 0, tableSize } };
+    }
+
     vsg::ShaderStages shaderStages{ vertexShader, fragmentShader };
 
     shaderSet = vsg::ShaderSet::create(shaderStages);
@@ -187,11 +227,16 @@ TerrainState::createShaderSet(VSGContext& context) const
     //shaderSet->addAttributeBinding(ATTR_VERTEX_NEIGHBOR, "", 3, VK_FORMAT_R32G32B32A32_SFLOAT, vsg::vec3Array::create(1));
     //shaderSet->addAttributeBinding(ATTR_NORMAL_NEIGHBOR, "", 4, VK_FORMAT_R32G32B32A32_SFLOAT, vsg::vec3Array::create(1));
 
+    // With a tile table, the textures become arrays indexed by tile and the
+    // per-tile uniforms become one SSBO of them.
+    auto textureCount = std::max(_tileTableSize, 1u);
+    auto tileDescriptorType = _tileTableSize > 0 ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+
     // "binding" (4th param) must match "layout(location=X) uniform" in the shader
-    shaderSet->addDescriptorBinding(texturedefs.elevation.name, "", 0, texturedefs.elevation.uniform_binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_VERTEX_BIT, {});
-    shaderSet->addDescriptorBinding(texturedefs.color.name, "", 0, texturedefs.color.uniform_binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, {});
+    shaderSet->addDescriptorBinding(texturedefs.elevation.name, "", 0, texturedefs.elevation.uniform_binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, textureCount, VK_SHADER_STAGE_VERTEX_BIT, {});
+    shaderSet->addDescriptorBinding(texturedefs.color.name, "", 0, texturedefs.color.uniform_binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, textureCount, VK_SHADER_STAGE_FRAGMENT_BIT, {});
     //shaderSet->addDescriptorBinding(texturedefs.normal.name, "", 0, texturedefs.normal.uniform_binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, {});
-    shaderSet->addDescriptorBinding(TILE_UBO_NAME, "", 0, TILE_UBO_BINDING, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, {});
+    shaderSet->addDescriptorBinding(TILE_UBO_NAME, "", 0, TILE_UBO_BINDING, tileDescriptorType, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, {});
     shaderSet->addDescriptorBinding(SETTINGS_UBO_NAME, "", 0, SETTINGS_UBO_BINDING, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, {});
     
     PipelineUtils::addViewDependentData(shaderSet, VK_SHADER_STAGE_FRAGMENT_BIT);
@@ -216,6 +261,16 @@ TerrainState::createPipelineConfig(VSGContext& context) const
     // Apply any custom compile settings / defines:
     config->shaderHints = context->shaderCompileSettings;
 
+    if (_tileTableSize > 0)
+    {
+        // copy the shared settings so the define doesn't leak into other pipelines
+        config->shaderHints = context->shaderCompileSettings ?
+            vsg::ShaderCompileSettings::create(*context->shaderCompileSettings) :
+            vsg::ShaderCompileSettings::create();
+
+        config->shaderHints->defines.insert("ROCKY_TILE_TABLE");
+    }
+
     // activate the arrays we intend to use
     config->enableArray(ATTR_VERTEX, VK_VERTEX_INPUT_RATE_VERTEX, 12);
     config->enableArray(ATTR_NORMAL, VK_VERTEX_INPUT_RATE_VERTEX, 12);
@@ -278,7 +333,36 @@ TerrainState::setupTerrainStateGroup(vsg::StateGroup& stateGroup, VSGContext& co
     // Descriptors are the global terrain uniform buffer and the VSG view-dependent buffer.
     stateGroup.add(pipelineConfig->bindGraphicsPipeline);
     stateGroup.add(vsg::BindViewDescriptorSets::create(VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineConfig->layout, VSG_VIEW_DEPENDENT_DESCRIPTOR_SET_INDEX));
-    
+
+    if (_tileTableSize > 0)
+    {
+        // empty slots render as a flat, untextured tile
+        TerrainTileDescriptors::Uniforms placeholder;
+        placeholder.elevation_matrix = glm::fmat4(1.0f);
+        placeholder.color_matrix = glm::fmat4(1.0f);
+        placeholder.model_matrix = glm::fmat4(1.0f);
+
+        auto uniforms = vsg::ubyteArray::create(sizeof(TerrainTileDescriptors::Uniforms));
+        *static_cast<TerrainTileDescriptors::Uniforms*>(uniforms->dataPointer()) = placeholder;
+
+        // The table replaces every per-tile descriptor set, so the terrain binds
+        // its descriptors once here instead of once per tile.
+        tileTable = TerrainTileTable::create(
+            _tileTableSize,
+            pipelineConfig->layout,
+            defaultTileDescriptors.elevation,
+            defaultTileDescriptors.color,
+            uniforms,
+            TILE_UBO_BINDING,
+            _terrainDescriptors.ubo);
+
+        stateGroup.add(tileTable);
+    }
+    else
+    {
+        tileTable = {};
+    }
+
     return true;
 }
 
@@ -313,13 +397,15 @@ TerrainState::updateRenderModel(const TerrainTileRenderModel& oldRenderModel, co
             data->properties.dataVariance = vsg::STATIC_DATA_UNREF_AFTER_TRANSFER;
 
             descriptors.color = vsg::DescriptorImage::create(
-                texturedefs.color.sampler,
+                renderModel.color.image->compressed() ? texturedefs.color.compressedSampler : texturedefs.color.sampler,
                 data,
                 texturedefs.color.uniform_binding,
                 0, // array element (TODO: increment if we change to an array)
                 VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
 
             descriptors.color->setValue("name", renderModel.color.name);
+
+            renderModel.colorBytes = renderModel.color.image->sizeInBytes();
         }
     }
 
@@ -354,6 +440,8 @@ TerrainState::updateRenderModel(const TerrainTileRenderModel& oldRenderModel, co
                 VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
 
             descriptors.elevation->setValue("name", renderModel.elevation.name);
+
+            renderModel.elevationBytes = renderModel.elevation.image->sizeInBytes();
         }
     }
 
@@ -365,6 +453,30 @@ TerrainState::updateRenderModel(const TerrainTileRenderModel& oldRenderModel, co
     uniforms.model_matrix = renderModel.modelMatrix;
     uniforms.min_height = renderModel.minHeight;
     uniforms.max_height = renderModel.maxHeight;
+
+    if (tileTable)
+    {
+        // The textures go into the shared table instead of a descriptor set
+        // of their own, so compile them by themselves.
+        auto compilable = CompileDescriptors::create();
+        compilable->descriptors = { descriptors.elevation, descriptors.color };
+        vsgcontext->compile(compilable);
+
+        descriptors.entry = tileTable->add(descriptors.elevation, descriptors.color, ubo);
+        descriptors.uniforms = {};
+        descriptors.bind = {};
+
+        if (!descriptors.entry)
+        {
+            static std::once_flag warned;
+            std::call_once(warned, [&]() {
+                Log()->warn("Terrain tile table is full ({} slots); increase tileTableSize", tileTable->size());
+                });
+        }
+
+        return renderModel;
+    }
+
     descriptors.uniforms = vsg::DescriptorBuffer::create(ubo, TILE_UBO_BINDING);
 
     // make the descriptor set, and include the terrain settings UBO
@@ -387,6 +499,88 @@ TerrainState::updateRenderModel(const TerrainTileRenderModel& oldRenderModel, co
     return renderModel;
 }
 
+void
+TerrainState::applyRenderModel(TerrainTileNode& tile, VSGContext& vsgcontext) const
+{
+    auto& descriptors = tile.renderModel.descriptors;
+
+    tile.memory = tile.computeMemory();
+
+    if (tileTable)
+    {
+        // Point the tile's draw at its slot in the table, and keep the slot
+        // leased for as long as the draw refers to it. Tiles without a slot
+        // fall back on the placeholder in slot zero.
+        auto geometry = tile.stategroup->children.front().cast<SharedGeometry>();
+        if (geometry)
+        {
+            if (geometry->lease)
+                vsgcontext->dispose(geometry->lease);
+
+            geometry->lease = descriptors.entry;
+            geometry->setFirstInstance(descriptors.entry ? descriptors.entry->slot : 0u);
+        }
+    }
+    else
+    {
+        for (auto& command : tile.stategroup->stateCommands)
+            vsgcontext->dispose(command);
+
+        tile.stategroup->stateCommands = { descriptors.bind };
+    }
+}
+
+void
+TerrainState::setTileTableSize(std::uint32_t size, VSGContext& context)
+{
+    if (size > 0)
+    {
+        if (auto device = context->device())
+        {
+            // Both texture arrays live in one descriptor set and the fragment stage
+            // samples a few other textures as well, so leave some headroom.
+            constexpr std::uint32_t reserved = 16u;
+            auto& limits = device->getPhysicalDevice()->getProperties().limits;
+            auto perStage = std::min(limits.maxPerStageDescriptorSampledImages, limits.maxPerStageDescriptorSamplers);
+            auto perSet = std::min(limits.maxDescriptorSetSampledImages, limits.maxDescriptorSetSamplers);
+            auto limit = std::min(
+                perStage > reserved ? perStage - reserved : 0u,
+                perSet > 2 * reserved ? (perSet - reserved) / 2 : 0u);
+
+            if (size > limit)
+            {
+                Log()->warn("Terrain tile table size {} exceeds the device limit of {}", size, limit);
+                size = limit;
+            }
+
+            // the fragment shader indexes the texture arrays with each tile's slot
+            if (size > 0 && !context->deviceFeatures().shaderSampledImageArrayDynamicIndexing)
+            {
+                Log()->warn("Terrain tile table needs the shaderSampledImageArrayDynamicIndexing device feature; disabling it");
+                size = 0;
+            }
+        }
+
+        // slot zero is a placeholder, so a useful table has at least two
+        if (size < 2)
+            size = 0;
+    }
+
+    if (size != _tileTableSize)
+    {
+        _tileTableSize = size;
+        tileTable = {};
+
+        shaderSet = createShaderSet(context);
+        if (!shaderSet)
+        {
+            status = Failure(Failure::ResourceUnavailable,
+                "Terrain shaders are missing or corrupt. "
+                "Did you set ROCKY_FILE_PATH to point at the rocky share folder?");
+        }
+    }
+}
+
 void
 TerrainState::updateSettings(const TerrainSettings& settings)
 {    
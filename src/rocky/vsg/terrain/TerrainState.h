@@ -6,6 +6,7 @@
 #pragma once
 
 #include <rocky/vsg/VSGContext.h>
+#include <rocky/vsg/terrain/TerrainTileTable.h>
 #include <rocky/Color.h>
 #include <rocky/Image.h>
 
@@ -13,6 +14,7 @@ namespace ROCKY_NAMESPACE
 {
     struct TerrainTileModel;
     class TerrainSettings;
+    class TerrainTileNode;
 
     //! Holds any terrain-wide textures and uniforms.
     struct TerrainDescriptors
@@ -44,6 +46,9 @@ namespace ROCKY_NAMESPACE
         vsg::ref_ptr<vsg::DescriptorImage> elevation;
         vsg::ref_ptr<vsg::DescriptorBuffer> uniforms;
         vsg::ref_ptr<vsg::StateCommand> bind;
+
+        //! Slot in the terrain's tile table (instead of bind) when it has one
+        vsg::ref_ptr<TerrainTileTable::Entry> entry;
     };
 
     //! One texture source image and its matrix.
@@ -63,6 +68,11 @@ namespace ROCKY_NAMESPACE
         float minHeight = 0.0f;
         float maxHeight = 0.0f;
 
+        //! Size of the textures this model created itself, as opposed to
+        //! sharing them with the parent tile it inherited from
+        std::size_t colorBytes = 0;
+        std::size_t elevationBytes = 0;
+
         TerrainTileDescriptors descriptors;
 
         void applyScaleBias(const glm::dmat4& sb)
@@ -94,13 +104,28 @@ namespace ROCKY_NAMESPACE
 
         //! Integrates data from the new data model into an existing render model,
         //! and creates or updates all the necessary descriptors and commands.
-        //! After calling this, you will need to install the find bind command
-        //! in your stategroup.
+        //! After calling this, you will need to call applyRenderModel to
+        //! install the result in the tile.
         TerrainTileRenderModel updateRenderModel(
             const TerrainTileRenderModel& oldRenderModel,
             const TerrainTileModel& newDataModel,
             VSGContext& runtime) const;
 
+        //! Installs a tile's current render model in its scene graph, disposing
+        //! of whatever it replaces. Call from the update pass, or before the tile
+        //! joins the scene graph.
+        void applyRenderModel(TerrainTileNode& tile, VSGContext& runtime) const;
+
+        //! Switches between one descriptor set per tile (size = 0) and a shared
+        //! tile table with the given number of slots. Call this before
+        //! setupTerrainStateGroup.
+        void setTileTableSize(std::uint32_t size, VSGContext& context);
+
+        //! Number of slots in the tile table, or zero if there isn't one
+        inline std::uint32_t tileTableSize() const {
+            return _tileTableSize;
+        }
+
         void updateSettings(const TerrainSettings&);
 
         //! Status of the factory.
@@ -121,6 +146,10 @@ namespace ROCKY_NAMESPACE
         //! Terrain tiles copy and use this until new data becomes available.
         TerrainTileDescriptors defaultTileDescriptors;
 
+        //! Table of per-tile textures and uniforms shared by all tiles,
+        //! when tileTableSize() > 0.
+        vsg::ref_ptr<TerrainTileTable> tileTable;
+
     protected:
 
         //! Creates all the default texture information,
@@ -151,6 +180,10 @@ namespace ROCKY_NAMESPACE
 
             // default placeholder texture data
             vsg::ref_ptr<vsg::Data> defaultData;
+
+            // sampler for block-compressed images, which carry no mipmaps and
+            // can't have them generated on the GPU
+            vsg::ref_ptr<vsg::Sampler> compressedSampler;
         };
 
         //! stock samplers to use for terrain textures
@@ -163,5 +196,7 @@ namespace ROCKY_NAMESPACE
 
         // terrain-wide settings, etc.
         TerrainDescriptors _terrainDescriptors;
+
+        std::uint32_t _tileTableSize = 0u;
     };
 }
@@ -155,6 +155,10 @@ TerrainTileNode::inheritFrom(vsg::ref_ptr<TerrainTileNode> parent)
     renderModel = parent->renderModel;
     renderModel.applyScaleBias(sb);
 
+    // the textures still belong to the parent
+    renderModel.colorBytes = 0;
+    renderModel.elevationBytes = 0;
+
     revision = parent->revision;
 
     // copy the parent's elevation data and recompute the bounding sphere
@@ -162,3 +166,25 @@ TerrainTileNode::inheritFrom(vsg::ref_ptr<TerrainTileNode> parent)
 
     renderModel.modelMatrix = to_glm(surface->matrix);
 }
+
+TerrainTileMemory
+TerrainTileNode::computeMemory() const
+{
+    TerrainTileMemory m;
+
+    // the pooled geometry is shared, so only the intersection proxy counts here.
+    m.geometry = surface ? surface->proxyBytes() : 0;
+
+    // textures keep their CPU copy for intersection and for subtiles to inherit.
+    m.color = renderModel.colorBytes;
+    m.elevation = renderModel.elevationBytes;
+
+    // in a tile table, the uniforms live in the table and not in the tile.
+    if (renderModel.descriptors.uniforms)
+        m.descriptors = sizeof(TerrainTileDescriptors::Uniforms);
+
+    m.cpu = m.geometry + m.color + m.elevation + m.descriptors;
+    m.gpu = m.color + m.elevation + m.descriptors;
+
+    return m;
+}
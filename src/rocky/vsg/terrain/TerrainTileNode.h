@@ -18,6 +18,29 @@ namespace ROCKY_NAMESPACE
     class TerrainSettings;
     class TerrainTileHost;
 
+    //! Approximate memory held by terrain tiles, in bytes
+    struct TerrainTileMemory
+    {
+        std::size_t geometry = 0;    // vertex data
+        std::size_t color = 0;       // color textures
+        std::size_t elevation = 0;   // elevation textures
+        std::size_t descriptors = 0; // uniform buffers
+        std::size_t cpu = 0;         // total held in CPU memory
+        std::size_t gpu = 0;         // total held in GPU memory
+
+        TerrainTileMemory& operator += (const TerrainTileMemory& rhs) {
+            geometry += rhs.geometry, color += rhs.color, elevation += rhs.elevation;
+            descriptors += rhs.descriptors, cpu += rhs.cpu, gpu += rhs.gpu;
+            return *this;
+        }
+
+        TerrainTileMemory& operator -= (const TerrainTileMemory& rhs) {
+            geometry -= rhs.geometry, color -= rhs.color, elevation -= rhs.elevation;
+            descriptors -= rhs.descriptors, cpu -= rhs.cpu, gpu -= rhs.gpu;
+            return *this;
+        }
+    };
+
     /**
      * TileNode represents a single tile. TileNode has 5 children:
      * one SurfaceNode that renders the actual tile content under a MatrixTransform;
@@ -27,6 +50,7 @@ namespace ROCKY_NAMESPACE
     {
     public:
         TileKey key;
+        TileID id; // compact form of key, for tile tables
         bool doNotExpire = false;
         Revision revision = 0;
         TerrainTileRenderModel renderModel;       
@@ -38,6 +62,13 @@ namespace ROCKY_NAMESPACE
         mutable std::atomic<vsg::time_point> lastTraversalTime;
         mutable std::atomic<float> lastTraversalRange = { FLT_MAX };
 
+        //! Memory held by the render model installed in the scene graph
+        //! (updated by TerrainState::applyRenderModel)
+        TerrainTileMemory memory;
+
+        //! Calculates the memory held by the current render model
+        TerrainTileMemory computeMemory() const;
+
         //! Update this node (placeholder).
         //! @return true if any changes occur.
         bool update(const vsg::FrameStamp*, const IOOptions&) { return false; }
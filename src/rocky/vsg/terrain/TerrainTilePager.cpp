@@ -18,6 +18,34 @@ using namespace ROCKY_NAMESPACE;
 
 #define RP_DEBUG if(false) Log()->info
 
+namespace
+{
+    // Configures a tile model factory for the terrain settings.
+    TerrainTileModelFactory makeTileModelFactory(const TerrainSettings& settings, const VSGContext& context)
+    {
+        TerrainTileModelFactory factory;
+        factory.compositeColorLayers = true;
+        factory.maxConcurrentLayers = std::max(1u, settings.layerConcurrency.value());
+
+        auto compression = util::toLower(settings.textureCompression.value());
+        if (compression == "bc1" || compression == "bc3")
+        {
+            if (context->deviceFeatures().textureCompressionBC)
+            {
+                factory.colorCompression = compression == "bc1" ? Image::BC1_RGBA_UNORM : Image::BC3_RGBA_UNORM;
+            }
+            else
+            {
+                static std::once_flag warned;
+                std::call_once(warned, [&]() {
+                    Log()->warn(LC "The device doesn't support BC textures; textureCompression \"{}\" falls back to \"none\"", compression); });
+            }
+        }
+
+        return factory;
+    }
+}
+
 //----------------------------------------------------------------------------
 
 TerrainTilePager::TerrainTilePager(const TerrainSettings& settings, TerrainTileHost* host) :
@@ -39,6 +67,14 @@ TerrainTilePager::releaseAll()
 
     _tiles.clear();
     _tracker.reset();
+    _usage = {};
+    _prefetch = {};
+    _prefetched.clear();
+
+    // the buffered pings point at tiles we no longer hold
+    std::scoped_lock buffersLock(_pingBuffersMutex);
+    for (auto& buffer : _pingBuffers)
+        buffer->pings.clear();
     _createChildren.clear();
     _loadData.clear();
     _mergeData.clear();
@@ -48,18 +84,57 @@ TerrainTilePager::releaseAll()
 void
 TerrainTilePager::ping(TerrainTileNode* tile, const TerrainTileNode* parent, vsg::RecordTraversal& rv)
 {
-    if (_settings.supportMultiThreadedRecord)
-        _mutex.lock();
+    // The tiles are part of the scene graph being recorded, so they will
+    // still be around when update() gets to the ping.
+    pingBuffer().pings.emplace_back(Ping{ tile, parent });
+}
 
-    // first, update the tracker to keep this tile alive.
-    auto& info = _tiles[tile->key];
-    if (!info.tile)
-        info.tile = tile;
+TerrainTilePager::PingBuffer&
+TerrainTilePager::pingBuffer()
+{
+    // Each thread remembers its buffers for the last few pagers it pinged,
+    // so finding one almost never takes a lock. Pager UIDs are never reused,
+    // so an entry left over from a deleted pager can't match a new one.
+    struct Cached
+    {
+        UID pager = -1;
+        PingBuffer* buffer = nullptr;
+    };
+    thread_local Cached cache[4];
+    thread_local unsigned next = 0;
 
-    if (info.trackerToken)
-        info.trackerToken = _tracker.update(info.trackerToken);
-    else
-        info.trackerToken = _tracker.emplace(info.tile);
+    for (auto& entry : cache)
+    {
+        if (entry.pager == _uid)
+            return *entry.buffer;
+    }
+
+    std::scoped_lock lock(_pingBuffersMutex);
+
+    auto id = std::this_thread::get_id();
+
+    auto iter = std::find_if(_pingBuffers.begin(), _pingBuffers.end(),
+        [&](auto& buffer) { return buffer->thread == id; });
+
+    if (iter == _pingBuffers.end())
+    {
+        _pingBuffers.emplace_back(std::make_unique<PingBuffer>());
+        _pingBuffers.back()->thread = id;
+        iter = std::prev(_pingBuffers.end());
+    }
+
+    cache[next++ % 4] = Cached{ _uid, iter->get() };
+    return **iter;
+}
+
+void
+TerrainTilePager::process(const Ping& ping)
+{
+    auto tile = ping.tile;
+    auto parent = ping.parent;
+
+    // first, update the tracker to keep this tile alive.
+    auto& info = touch(tile);
 
     // next, see if the tile needs anything.
     // "progressive" means do not load LOD N+1 until LOD N is complete.
@@ -70,7 +145,7 @@ TerrainTilePager::ping(TerrainTileNode* tile, const TerrainTileNode* parent, vsg
         // If this tile is fully merged, and it needs children, queue them up to load.
         if (info.dataMerger.available() && tile->needsSubtiles)
         {
-            _createChildren.push_back(tile->key);
+            _createChildren.push_back(tile->id);
         }
 
         if (parent == nullptr)
@@ -78,21 +153,21 @@ TerrainTilePager::ping(TerrainTileNode* tile, const TerrainTileNode* parent, vsg
             // If this is a root tile, and it needs data, queue that up:
             if (info.dataLoader.empty())
             {
-                _loadData.emplace_back(tile->key);
+                _loadData.emplace_back(tile->id);
             }
         }
         else
         {
             // If this is a non-root tile that needs data, check to make sure the 
             // parent's tile is done loaded before queueing that up.
-            auto& parent_info = _tiles[parent->key];
+            auto& parent_info = _tiles[parent->id];
             if (!parent_info.tile)
             {
                 ROCKY_SOFT_ASSERT_AND_RETURN(parent_info.tile, void());
             }
             if (parent_info.tile && parent_info.dataMerger.available() && info.dataLoader.empty())
             {
-                _loadData.push_back(tile->key);
+                _loadData.push_back(tile->id);
             }
         }
     }
@@ -102,17 +177,14 @@ TerrainTilePager::ping(TerrainTileNode* tile, const TerrainTileNode* parent, vsg
     // the (synchronous) update cycle in VSG.
     if (info.dataLoader.available() && info.dataMerger.empty())
     {
-        _mergeData.push_back(tile->key);
+        _mergeData.push_back(tile->id);
     }
 
     // Tile updates are TBD.
     if (tile->needsUpdate)
     {
-        _updateData.push_back(tile->key);
+        _updateData.push_back(tile->id);
     }
-
-    if (_settings.supportMultiThreadedRecord)
-        _mutex.unlock();
 }
 
 bool
@@ -120,6 +192,18 @@ TerrainTilePager::update(const vsg::FrameStamp* fs, const IOOptions& io, std::sh
 {
     std::scoped_lock lock(_mutex);
 
+    // catch up on the pings recorded since the last update
+    {
+        std::scoped_lock buffersLock(_pingBuffersMutex);
+        for (auto& buffer : _pingBuffers)
+        {
+            for (auto& ping : buffer->pings)
+                process(ping);
+
+            buffer->pings.clear();
+        }
+    }
+
     bool changes = false;
 
     changes =
@@ -136,9 +220,9 @@ TerrainTilePager::update(const vsg::FrameStamp* fs, const IOOptions& io, std::sh
     //    << "needsMerge=" << _mergeData.size() << std::endl;
 
     // update any tiles that asked for it
-    for (auto& key : _updateData)
+    for (auto& id : _updateData)
     {
-        auto iter = _tiles.find(key);
+        auto iter = _tiles.find(id);
         if (iter != _tiles.end())
         {
             if (iter->second.tile->update(fs, io))
@@ -147,11 +231,14 @@ TerrainTilePager::update(const vsg::FrameStamp* fs, const IOOptions& io, std::sh
     }
     _updateData.clear();
 
+    const std::size_t budget = (std::size_t)_settings.memoryBudget.value() * 1048576u;
+    const bool subdivide = canSubdivide(_usage.memory, budget);
+
     // launch any "new subtiles" requests
-    for (auto& key : _createChildren)
+    for (auto& id : _createChildren)
     {
-        auto iter = _tiles.find(key);
-        if (iter != _tiles.end())
+        auto iter = _tiles.find(id);
+        if (iter != _tiles.end() && subdivide)
         {
             requestCreateChildren(iter->second, engine); // parent, context
             iter->second.tile->needsSubtiles = false;
@@ -162,12 +249,43 @@ TerrainTilePager::update(const vsg::FrameStamp* fs, const IOOptions& io, std::sh
     _createChildren.clear();
 
     // launch any data loading requests
-    for (auto& key : _loadData)
+    const unsigned batchSize = std::max(1u, _settings.loadBatchSize.value());
+    if (batchSize == 1u)
     {
-        auto iter = _tiles.find(key);
-        if (iter != _tiles.end())
+        for (auto& id : _loadData)
+        {
+            auto iter = _tiles.find(id);
+            if (iter != _tiles.end())
+            {
+                requestLoadData(iter->second, io, engine);
+            }
+
+            changes = true;
+        }
+    }
+    else if (!_loadData.empty())
+    {
+        // group the requests by parent so siblings load together
+        std::unordered_map<TileID, std::vector<TileInfo*>> siblings;
+        for (auto& id : _loadData)
+        {
+            auto iter = _tiles.find(id);
+            if (iter != _tiles.end())
+            {
+                auto& group = siblings[iter->second.tile->key.createParentKey().id()];
+                if (std::find(group.begin(), group.end(), &iter->second) == group.end())
+                    group.push_back(&iter->second);
+            }
+        }
+
+        std::vector<TileInfo*> batch;
+        for (auto& [parentID, group] : siblings)
         {
-            requestLoadData(iter->second, io, engine);
+            for (unsigned i = 0; i < group.size(); i += batchSize)
+            {
+                batch.assign(group.begin() + i, group.begin() + std::min(i + batchSize, (unsigned)group.size()));
+                requestLoadDataBatch(batch, io, engine);
+            }
         }
 
         changes = true;
@@ -175,9 +293,9 @@ TerrainTilePager::update(const vsg::FrameStamp* fs, const IOOptions& io, std::sh
     _loadData.clear();
 
     // schedule any data merging requests
-    for (auto& key : _mergeData)
+    for (auto& id : _mergeData)
     {
-        auto iter = _tiles.find(key);
+        auto iter = _tiles.find(id);
         if (iter != _tiles.end())
         {
             requestMergeData(iter->second, io, engine);
@@ -187,6 +305,10 @@ TerrainTilePager::update(const vsg::FrameStamp* fs, const IOOptions& io, std::sh
     }
     _mergeData.clear();
 
+    // get a head start on the tiles the camera is about to need
+    if (subdivide && prefetch(fs, io, engine))
+        changes = true;
+
     // Flush unused tiles (i.e., tiles that failed to ping) out of the system.
     // Tiles ping their children all at once; this should in theory prevent
     // a child from expiring without its siblings.
@@ -197,8 +319,7 @@ TerrainTilePager::update(const vsg::FrameStamp* fs, const IOOptions& io, std::sh
         {
             if (!tile->doNotExpire)
             {
-                auto key = tile->key;
-                auto parent_iter = _tiles.find(key.createParentKey());
+                auto parent_iter = _tiles.find(tile->key.createParentKey().id());
                 if (parent_iter != _tiles.end())
                 {
                     auto parent = parent_iter->second.tile;
@@ -214,13 +335,38 @@ TerrainTilePager::update(const vsg::FrameStamp* fs, const IOOptions& io, std::sh
                         tile->needsSubtiles = false;
                     }
                 }
-                _tiles.erase(key);
+                _tiles.erase(tile->id);
                 return true;
             }
             return false;
         };
 
         _tracker.flush(~0, dispose);
+
+        // tally up what the resident tiles are holding
+        Usage usage;
+        usage.evicted = _usage.evicted;
+        for (auto& [id, info] : _tiles)
+        {
+            if (info.tile)
+            {
+                usage.memory += info.tile->memory;
+                ++usage.tiles;
+            }
+        }
+
+        auto poolBytes = engine->geometryPool.bytes();
+        usage.memory.geometry += poolBytes;
+        usage.memory.cpu += poolBytes;
+        usage.memory.gpu += poolBytes;
+
+        _usage = usage;
+
+        if (budget > 0u && std::max(_usage.memory.cpu, _usage.memory.gpu) > budget)
+        {
+            evict(budget, engine);
+            changes = true;
+        }
     }
 
     // synchronize
@@ -229,11 +375,229 @@ TerrainTilePager::update(const vsg::FrameStamp* fs, const IOOptions& io, std::sh
     return changes;
 }
 
+TerrainTilePager::TileInfo&
+TerrainTilePager::touch(TerrainTileNode* tile)
+{
+    auto& info = _tiles[tile->id];
+    if (!info.tile)
+        info.tile = tile;
+
+    if (info.trackerToken)
+        info.trackerToken = _tracker.update(info.trackerToken);
+    else
+        info.trackerToken = _tracker.emplace(info.tile);
+
+    return info;
+}
+
+void
+TerrainTilePager::setPrefetch(Prefetch&& value)
+{
+    std::scoped_lock lock(_mutex);
+    _prefetch = std::move(value);
+}
+
+bool
+TerrainTilePager::prefetch(const vsg::FrameStamp* fs, const IOOptions& io, std::shared_ptr<TerrainEngine> engine)
+{
+    bool changes = false;
+
+    // A change of course means the work queued for the old one is probably
+    // wasted, so cancel whatever the camera didn't end up looking at.
+    if (_prefetch.revision != _prefetchRevision)
+    {
+        for (auto& id : _prefetched)
+        {
+            auto iter = _tiles.find(id);
+            if (iter != _tiles.end())
+            {
+                auto& info = iter->second;
+                if (info.tile->lastTraversalFrame + 1 < fs->frameCount)
+                {
+                    if (info.dataLoader.working())
+                        info.dataLoader.reset();
+
+                    if (info.childrenCreator.working())
+                        info.childrenCreator.reset();
+
+                    changes = true;
+                }
+            }
+        }
+
+        _prefetched.clear();
+        _prefetchRevision = _prefetch.revision;
+    }
+
+    auto predicted = [](const Prefetch::View& view) {
+        return !view.eyes.empty() && view.viewportHeight > 0.0;
+        };
+
+    if (std::none_of(_prefetch.views.begin(), _prefetch.views.end(), predicted))
+        return changes;
+
+    // same screen-space test the tiles use to decide when to subdivide during record
+    const double tileHeight = _settings.tilePixelSize.value() + _settings.pixelError.value();
+
+    auto subtilesInRange = [&](const TerrainTileNode* tile)
+        {
+            for (auto& view : _prefetch.views)
+            {
+                if (!predicted(view))
+                    continue;
+
+                const double min_screen_height_ratio = tileHeight / view.viewportHeight;
+
+                for (auto& eye : view.eyes)
+                {
+                    double range = vsg::length(tile->bound.center - eye);
+                    if (range < tile->bound.r || tile->bound.r > range * view.lodScale * min_screen_height_ratio)
+                        return true;
+                }
+            }
+            return false;
+        };
+
+    // Walk down from the root tiles following the predicted eyes. Work on a tile
+    // only starts once its parent is merged, just like the record traversal.
+    std::vector<TileInfo*> stack;
+    for (auto& [id, info] : _tiles)
+    {
+        if (id.level() == _firstLOD && info.tile)
+            stack.emplace_back(&info);
+    }
+
+    while (!stack.empty())
+    {
+        auto& info = *stack.back();
+        stack.pop_back();
+
+        auto tile = info.tile;
+
+        if (!info.dataMerger.available())
+        {
+            if (info.dataLoader.empty())
+            {
+                requestLoadData(info, io, engine);
+                _prefetched.emplace_back(tile->id);
+                changes = true;
+            }
+            else if (info.dataLoader.available() && info.dataMerger.empty())
+            {
+                requestMergeData(info, io, engine);
+                changes = true;
+            }
+            continue;
+        }
+
+        if (tile->key.level >= _settings.maxLevel.value() || !subtilesInRange(tile))
+            continue;
+
+        if (tile->subtilesExist())
+        {
+            for (unsigned i = 0; i < 4; ++i)
+            {
+                stack.emplace_back(&touch(tile->subTile(i)));
+            }
+        }
+        else if (info.childrenCreator.empty())
+        {
+            requestCreateChildren(info, engine);
+            _prefetched.emplace_back(tile->id);
+            changes = true;
+        }
+    }
+
+    return changes;
+}
+
+TerrainTilePager::Usage
+TerrainTilePager::usage() const
+{
+    std::scoped_lock lock(_mutex);
+    return _usage;
+}
+
+void
+TerrainTilePager::evict(std::size_t budget, std::shared_ptr<TerrainEngine> engine)
+{
+    // Candidates are tiles whose four subtiles are all leaves. Paging out the
+    // quad sends the parent back to rendering its own, lower resolution data.
+    std::vector<EvictionCandidate> candidates;
+
+    for (auto& [id, info] : _tiles)
+    {
+        auto& tile = info.tile;
+        if (!tile || !tile->subtilesExist())
+            continue;
+
+        EvictionCandidate c;
+        c.parent = id;
+        bool leaves = true;
+
+        for (unsigned i = 0; i < 4 && leaves; ++i)
+        {
+            auto subtile = tile->subTile(i);
+            leaves = !subtile->subtilesExist();
+            c.lastFrame = std::max(c.lastFrame, subtile->lastTraversalFrame.load());
+            c.range = std::min(c.range, subtile->lastTraversalRange.load());
+
+            // only registered subtiles count toward the usage
+            auto iter = _tiles.find(subtile->id);
+            if (iter != _tiles.end() && iter->second.tile)
+                c.memory += iter->second.tile->memory;
+        }
+
+        if (leaves)
+            candidates.emplace_back(c);
+    }
+
+    auto count = selectEvictions(candidates, _usage.memory, budget);
+
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        auto parentIter = _tiles.find(candidates[k].parent);
+        if (parentIter == _tiles.end())
+            continue;
+
+        auto& info = parentIter->second;
+        auto parent = info.tile;
+
+        for (unsigned i = 0; i < 4; ++i)
+        {
+            auto iter = _tiles.find(parent->subTile(i)->id);
+            if (iter != _tiles.end())
+            {
+                if (iter->second.tile)
+                {
+                    _usage.memory -= iter->second.tile->memory;
+                    --_usage.tiles;
+                }
+
+                if (iter->second.trackerToken)
+                    _tracker.erase(iter->second.trackerToken);
+
+                _tiles.erase(iter);
+                ++_usage.evicted;
+            }
+        }
+
+        // Feed the subtiles to the garbage disposal so any vulkan objects
+        // are safely destroyed, and let the parent subdivide again later.
+        engine->context->dispose(parent->children[1]);
+        parent->children.resize(1);
+        parent->needsSubtiles = false;
+        info.childrenCreator.reset();
+    }
+
+    RP_DEBUG("Evicted to budget; {} tiles resident", _usage.tiles);
+}
+
 vsg::ref_ptr<TerrainTileNode>
-TerrainTilePager::getTile(const TileKey& key) const
+TerrainTilePager::getTile(const TileID& id) const
 {
     std::scoped_lock lock(_mutex);
-    auto iter = _tiles.find(key);
+    auto iter = _tiles.find(id);
     return
         iter != _tiles.end() ? iter->second.tile :
         vsg::ref_ptr<TerrainTileNode>(nullptr);
@@ -248,6 +612,10 @@ TerrainTilePager::requestCreateChildren(TileInfo& info, std::shared_ptr<TerrainE
     if (!info.childrenCreator.empty())
         return;
 
+    // the tile table can't hold tiles beyond the TileID packing limits
+    if (!info.tile->key.createChildKey(3).id().valid())
+        return;
+
     RP_DEBUG("requestLoadSubtiles -> {}", info.tile->key.str());
 
     vsg::observer_ptr<TerrainTileNode> weak_parent(info.tile);
@@ -281,16 +649,20 @@ TerrainTilePager::requestCreateChildren(TileInfo& info, std::shared_ptr<TerrainE
 
         if (result)
         {
-            engine->context->compile(result);
-
-            engine->context->onNextUpdate([result, engine, weak_parent]()
+            // No need to wait for the compile; the children join the scene in
+            // the update following it, and this thread is free to load more.
+            engine->context->compileAsync(result, [result, engine, weak_parent](const vsg::CompileResult&)
                 {
-                    auto parent = weak_parent.ref_ptr();
-                    if (parent)
-                    {
-                        parent->addChild(result);
-                    }
-                    engine->context->requestFrame();
+                    engine->context->onNextUpdate([result, engine, weak_parent]()
+                        {
+                            // a canceled prefetch may have been requested again in the meantime
+                            auto parent = weak_parent.ref_ptr();
+                            if (parent && !parent->subtilesExist())
+                            {
+                                parent->addChild(result);
+                            }
+                            engine->context->requestFrame();
+                        });
                 });
 
             engine->context->requestFrame();
@@ -339,8 +711,7 @@ TerrainTilePager::requestLoadData(TileInfo& info, const IOOptions& in_io, std::s
         if (p.canceled())
             return false;
 
-        TerrainTileModelFactory factory;
-        factory.compositeColorLayers = true;
+        auto factory = makeTileModelFactory(engine->settings, engine->context);
 
         auto dataModel = factory.createTileModel(engine->map.get(), key, io.with(p));
 
@@ -380,6 +751,104 @@ TerrainTilePager::requestLoadData(TileInfo& info, const IOOptions& in_io, std::s
         } );
 }
 
+void
+TerrainTilePager::requestLoadDataBatch(std::vector<TileInfo*>& batch, const IOOptions& in_io, std::shared_ptr<TerrainEngine> engine) const
+{
+    // Items hold their tiles weakly, so a tile that pages out before its
+    // turn can go away and stop counting toward the batch's priority.
+    struct Item
+    {
+        TileKey key;
+        vsg::observer_ptr<TerrainTileNode> tile;
+        jobs::future<bool> promise;
+    };
+
+    auto items = std::make_shared<std::vector<Item>>();
+
+    for (auto info : batch)
+    {
+        // make sure we're not already working on it
+        if (!info->tile || info->dataLoader.working() || info->dataLoader.available())
+            continue;
+
+        RP_DEBUG("requestLoadData (batched) -> {}", info->tile->key.str());
+
+        auto& item = items->emplace_back(Item{ info->tile->key, vsg::observer_ptr<TerrainTileNode>(info->tile) });
+        info->dataLoader = item.promise;
+    }
+
+    if (items->empty())
+        return;
+
+    const IOOptions io(in_io);
+
+    // Loads the tiles one after the other. The shared retainer keeps each source
+    // image resident until the whole batch is done, so siblings that need the same
+    // ancestor fallback or reprojected source tile will find it in the cache.
+    auto load_batch = [items, engine, io]() mutable
+    {
+        auto batch_io = io;
+        batch_io.retainer = std::make_shared<ImageRetainer>();
+
+        auto factory = makeTileModelFactory(engine->settings, engine->context);
+
+        for (auto& item : *items)
+        {
+            // canceled means the tile went away before we got to it
+            if (item.promise.canceled())
+                continue;
+
+            auto tile = item.tile.ref_ptr();
+            if (!tile)
+            {
+                item.promise.resolve(false);
+                continue;
+            }
+
+            auto dataModel = factory.createTileModel(engine->map.get(), item.key, batch_io.with(item.promise));
+
+            bool loaded = false;
+            if (!dataModel.empty())
+            {
+                tile->renderModel = engine->stateFactory.updateRenderModel(
+                    tile->renderModel,
+                    dataModel,
+                    engine->context);
+
+                engine->context->requestFrame();
+                loaded = true;
+            }
+
+            item.promise.resolve(loaded);
+        }
+    };
+
+    // a batch runs at the priority of its most important tile that's still wanted
+    auto priority_func = [items]() -> float
+    {
+        float priority = -FLT_MAX;
+        for (auto& item : *items)
+        {
+            if (item.promise.canceled())
+                continue;
+
+            vsg::ref_ptr<TerrainTileNode> tile = item.tile.ref_ptr();
+            if (tile)
+                priority = std::max(priority, -(sqrt(tile->lastTraversalRange) * tile->key.level));
+        }
+        return priority;
+    };
+
+    jobs::dispatch(
+        load_batch,
+        jobs::context {
+            "load data batch " + items->front().key.str(),
+            jobs::get_pool(engine->loadSchedulerName),
+            priority_func,
+            nullptr
+        });
+}
+
 void
 TerrainTilePager::requestMergeData(TileInfo& info, const IOOptions& in_io, std::shared_ptr<TerrainEngine> engine) const
 {
@@ -391,7 +860,7 @@ TerrainTilePager::requestMergeData(TileInfo& info, const IOOptions& in_io, std::
         return;
     }
 
-    auto key = info.tile->key;
+    auto id = info.tile->id;
 
     // if the loader didn't load anything, we're done.
     if (info.dataLoader.value() == false)
@@ -401,15 +870,12 @@ TerrainTilePager::requestMergeData(TileInfo& info, const IOOptions& in_io, std::
     }
 
     // operation to dispose of the old state command and replace it with a new one:
-    auto merge = [key, engine](Cancelable& c)
+    auto merge = [id, engine](Cancelable& c)
     {
-        auto tile = engine->host->tiles().getTile(key);
+        auto tile = engine->host->tiles().getTile(id);
         if (tile)
         {
-            for (auto c : tile->stategroup->stateCommands)
-                engine->context->dispose(c);
-
-            tile->stategroup->stateCommands = { tile->renderModel.descriptors.bind };
+            engine->stateFactory.applyRenderModel(*tile, engine->context);
 
             tile->surface->setElevation(
                 tile->renderModel.elevation.image,
@@ -8,8 +8,10 @@
 #include <rocky/vsg/VSGContext.h>
 #include <rocky/vsg/terrain/TerrainTileNode.h>
 #include <rocky/SentryTracker.h>
+#include <algorithm>
 #include <chrono>
-#include <map>
+#include <thread>
+#include <unordered_map>
 
 namespace ROCKY_NAMESPACE
 {
@@ -38,7 +40,76 @@ namespace ROCKY_NAMESPACE
             jobs::future<bool> dataMerger;
         };
 
-        using TileTable = std::map<TileKey, TileInfo>;
+        using TileTable = std::unordered_map<TileID, TileInfo>;
+
+        //! Resources held by the resident tiles
+        struct Usage
+        {
+            //! Number of resident tiles
+            std::size_t tiles = 0;
+
+            //! Memory held by the resident tiles and the shared geometry pool
+            TerrainTileMemory memory;
+
+            //! Total number of tiles paged out to stay within the memory budget
+            std::size_t evicted = 0;
+        };
+
+        //! Where the camera is expected to go, for prefetching tiles
+        struct Prefetch
+        {
+            //! One view's predicted camera
+            struct View
+            {
+                //! Predicted eye positions in world coordinates, soonest first
+                std::vector<vsg::dvec3> eyes;
+
+                //! Ratio of the LOD distance (vsg::State::lodDistance) to the
+                //! straight-line distance from the eye
+                double lodScale = 1.0;
+
+                //! Height of the viewport in pixels
+                double viewportHeight = 0.0;
+            };
+
+            //! Prediction for each view that's recording
+            std::vector<View> views;
+
+            //! Changes when the prediction changes course
+            std::uint64_t revision = 0;
+        };
+
+        //! A quad of leaf tiles that could be paged out to fit the memory budget
+        struct EvictionCandidate
+        {
+            //! Tile whose four subtiles are all leaves
+            TileID parent;
+
+            //! Most recent frame in which any of the subtiles was visible
+            std::uint64_t lastFrame = 0u;
+
+            //! Closest any of the subtiles came to the eye
+            float range = FLT_MAX;
+
+            //! Memory held by the subtiles
+            TerrainTileMemory memory;
+        };
+
+        //! Whether tiles may subdivide given the memory they hold. Subdivision
+        //! stops a little (5%) short of the budget, so that paging out and
+        //! subdividing don't take turns on the same tiles.
+        //! @param budget Memory budget in bytes; zero means unlimited
+        static inline bool canSubdivide(const TerrainTileMemory& usage, std::size_t budget);
+
+        //! Sorts the candidates least recently visible first, then farthest
+        //! first, and picks how many to page out to fit within the budget.
+        //! @param usage Memory held by all the resident tiles
+        //! @param budget Memory budget in bytes
+        //! @return Number of candidates, from the front, to page out
+        static inline std::size_t selectEvictions(
+            std::vector<EvictionCandidate>& candidates,
+            TerrainTileMemory usage,
+            std::size_t budget);
 
     public:
         //! Consturct the tile manager.
@@ -47,7 +118,9 @@ namespace ROCKY_NAMESPACE
         ~TerrainTilePager();
 
         //! TerrainTileNode will call this to let us know that it's alive
-        //! and that it may need something.
+        //! and that it may need something. The ping lands in a buffer owned
+        //! by the calling thread and takes effect in the next update, so
+        //! recording threads never wait on each other.
         //! ONLY call during record.
         void ping(
             TerrainTileNode* tile,
@@ -67,10 +140,16 @@ namespace ROCKY_NAMESPACE
             const IOOptions& io,
             std::shared_ptr<TerrainEngine> engine);
 
-        //! Fetches a tile by its key.
-        //! @param key TileKey for which to fetch a tile
+        //! Resources held by the resident tiles as of the last update.
+        Usage usage() const;
+
+        //! Sets the camera prediction that the next update will prefetch tiles for.
+        void setPrefetch(Prefetch&& value);
+
+        //! Fetches a tile by its ID.
+        //! @param id TileID (TileKey::id) of the tile to fetch
         //! @return The tile, if it exists
-        vsg::ref_ptr<TerrainTileNode> getTile(const TileKey& key) const;
+        vsg::ref_ptr<TerrainTileNode> getTile(const TileID& id) const;
 
         TileTable _tiles;
         Tracker _tracker;
@@ -79,15 +158,59 @@ namespace ROCKY_NAMESPACE
         TerrainTileHost* _host;
         const TerrainSettings& _settings;
 
-        std::vector<TileKey> _createChildren;
-        std::vector<TileKey> _loadData;
-        std::vector<TileKey> _mergeData;
-        std::vector<TileKey> _updateData;
+        std::vector<TileID> _createChildren;
+        std::vector<TileID> _loadData;
+        std::vector<TileID> _mergeData;
+        std::vector<TileID> _updateData;
 
         unsigned _firstLOD = 0u;
+        Usage _usage;
+        Prefetch _prefetch;
+        std::uint64_t _prefetchRevision = 0u;
+        std::vector<TileID> _prefetched;
 
     private:
 
+        struct Ping
+        {
+            TerrainTileNode* tile;
+            const TerrainTileNode* parent;
+        };
+
+        //! Pings recorded by one thread since the last update
+        struct PingBuffer
+        {
+            std::thread::id thread;
+            std::vector<Ping> pings;
+        };
+
+        const UID _uid = createUID();
+        std::mutex _pingBuffersMutex;
+        std::vector<std::unique_ptr<PingBuffer>> _pingBuffers;
+
+        //! The calling thread's ping buffer
+        PingBuffer& pingBuffer();
+
+        //! Keeps a pinged tile alive and queues up whatever it needs.
+        void process(const Ping& ping);
+
+        //! Registers a tile if necessary and keeps it from expiring this frame.
+        TileInfo& touch(TerrainTileNode* tile);
+
+        //! Walks the tiles along the predicted camera path and queues up low
+        //! priority work for any that are missing, not yet loaded, or ready to subdivide.
+        //! @return true if any work was queued or canceled
+        bool prefetch(
+            const vsg::FrameStamp* fs,
+            const IOOptions& io,
+            std::shared_ptr<TerrainEngine> engine);
+
+        //! Pages out quads of leaf tiles, least recently visible first, until
+        //! the resident tiles fit in the memory budget.
+        void evict(
+            std::size_t budget,
+            std::shared_ptr<TerrainEngine> engine);
+
         //! Loads the geometry for 4 new subtiles, and inherits their data models from a parent.
         void requestCreateChildren(
             TileInfo& info,
@@ -99,10 +222,37 @@ namespace ROCKY_NAMESPACE
             const IOOptions& io,
             std::shared_ptr<TerrainEngine> terrain) const;
 
+        //! Loads new data for a group of (usually sibling) tiles in a single job.
+        void requestLoadDataBatch(
+            std::vector<TileInfo*>& batch,
+            const IOOptions& io,
+            std::shared_ptr<TerrainEngine> terrain) const;
+
         //! Merges the new data model loaded in loadData.
         void requestMergeData(
             TileInfo& info,
             const IOOptions& io,
             std::shared_ptr<TerrainEngine> terrain) const;
     };
+
+    // inlines
+    bool TerrainTilePager::canSubdivide(const TerrainTileMemory& usage, std::size_t budget)
+    {
+        return budget == 0u || std::max(usage.cpu, usage.gpu) < budget - budget / 20u;
+    }
+
+    std::size_t TerrainTilePager::selectEvictions(std::vector<EvictionCandidate>& candidates, TerrainTileMemory usage, std::size_t budget)
+    {
+        std::sort(candidates.begin(), candidates.end(), [](const EvictionCandidate& lhs, const EvictionCandidate& rhs)
+            {
+                return lhs.lastFrame != rhs.lastFrame ? lhs.lastFrame < rhs.lastFrame : lhs.range > rhs.range;
+            });
+
+        std::size_t count = 0u;
+        while (count < candidates.size() && std::max(usage.cpu, usage.gpu) > budget)
+        {
+            usage -= candidates[count++].memory;
+        }
+        return count;
+    }
 }
@@ -0,0 +1,210 @@
+/**
+ * rocky c++
+ * Copyright 2025 Pelican Mapping
+ * MIT License
+ */
+#include "TerrainTileTable.h"
+
+#include <vsg/state/BindDescriptorSet.h>
+#include <vsg/state/DescriptorBuffer.h>
+#include <vsg/state/DescriptorImage.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace ROCKY_NAMESPACE;
+
+TerrainTileTable::Entry::~Entry()
+{
+    if (_table)
+        _table->release(*this);
+}
+
+TerrainTileTable::TerrainTileTable(
+    std::uint32_t size,
+    vsg::ref_ptr<vsg::PipelineLayout> layout,
+    vsg::ref_ptr<vsg::DescriptorImage> elevation,
+    vsg::ref_ptr<vsg::DescriptorImage> color,
+    vsg::ref_ptr<vsg::ubyteArray> uniforms,
+    std::uint32_t uniformsBinding,
+    vsg::ref_ptr<vsg::Descriptor> settings) :
+
+    _size(std::max(size, 2u)),
+    _stride((std::uint32_t)uniforms->dataSize()),
+    _defaultElevation(elevation),
+    _defaultColor(color),
+    _defaultUniforms(uniforms)
+{
+    // slot zero is a permanent placeholder for tiles that could not get a slot.
+    // Hand out the low slots first.
+    _free.reserve(_size - 1);
+    for (auto slot = _size - 1; slot > 0; --slot)
+        _free.push_back(slot);
+
+    // every slot starts out with the placeholder textures:
+    auto elevationArray = vsg::DescriptorImage::create(
+        vsg::ImageInfoList(_size, elevation->imageInfoList.front()),
+        elevation->dstBinding, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+
+    auto colorArray = vsg::DescriptorImage::create(
+        vsg::ImageInfoList(_size, color->imageInfoList.front()),
+        color->dstBinding, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+
+    for (unsigned i = 0; i < numCopies; ++i)
+    {
+        auto& copy = _copies.emplace_back();
+
+        copy.data = vsg::ubyteArray::create(_size * _stride);
+        for (std::uint32_t slot = 0; slot < _size; ++slot)
+            std::memcpy(copy.data->data() + slot * _stride, uniforms->data(), _stride);
+
+        copy.ssbo = vsg::DescriptorBuffer::create(copy.data, uniformsBinding, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+
+        auto descriptorSet = vsg::DescriptorSet::create(
+            layout->setLayouts[0],
+            vsg::Descriptors{ elevationArray, colorArray, copy.ssbo, settings });
+
+        copy.bind = vsg::BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, descriptorSet);
+    }
+
+    // occupy the same state slot as the bind command we stand in for
+    slot = _copies.front().bind->slot;
+}
+
+vsg::ref_ptr<TerrainTileTable::Entry>
+TerrainTileTable::add(vsg::ref_ptr<vsg::DescriptorImage> elevation, vsg::ref_ptr<vsg::DescriptorImage> color, vsg::ref_ptr<vsg::ubyteArray> uniforms)
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(elevation && color && uniforms, {});
+    ROCKY_SOFT_ASSERT_AND_RETURN(uniforms->dataSize() == _stride, {});
+
+    std::scoped_lock lock(_mutex);
+
+    if (_free.empty())
+        return {};
+
+    auto entry = Entry::create();
+    entry->slot = _free.back();
+    entry->_table = vsg::ref_ptr<TerrainTileTable>(this);
+    entry->_elevation = elevation;
+    entry->_color = color;
+    _free.pop_back();
+
+    _writes.emplace_back(Write{ ++_seq, entry->slot, elevation, color, uniforms, {}, {} });
+
+    return entry;
+}
+
+void
+TerrainTileTable::release(Entry& entry)
+{
+    std::scoped_lock lock(_mutex);
+
+    // Reset the slot to the placeholders, but hold on to the old textures until
+    // every copy of the descriptor set has stopped pointing at them.
+    _writes.emplace_back(Write{ ++_seq, entry.slot, _defaultElevation, _defaultColor, _defaultUniforms,
+        entry._elevation, entry._color });
+
+    _free.push_back(entry.slot);
+}
+
+std::uint32_t
+TerrainTileTable::leased() const
+{
+    std::scoped_lock lock(_mutex);
+    return _size - 1 - (std::uint32_t)_free.size();
+}
+
+void
+TerrainTileTable::update(VSGContext& context)
+{
+    // nothing to write into until the descriptor sets exist
+    if (!_device)
+        return;
+
+    std::scoped_lock lock(_mutex);
+
+    // Once the current copy has been recorded it belongs to the GPU, so move on
+    // to the next one. That copy was last recorded at least numCopies-1 frames ago.
+    if (_recorded.exchange(false))
+    {
+        _current = (_current + 1) % numCopies;
+    }
+
+    auto& copy = _copies[_current];
+
+    if (_writes.empty() || _writes.back().seq <= copy.applied)
+        return;
+
+    auto deviceID = _device->deviceID;
+    auto descriptorSet = copy.bind->descriptorSet->vk(deviceID);
+
+    std::vector<VkDescriptorImageInfo> imageInfos;
+    imageInfos.reserve(_writes.size() * 2);
+
+    std::vector<VkWriteDescriptorSet> vkWrites;
+    vkWrites.reserve(_writes.size() * 2);
+
+    auto write = [&](std::uint32_t slot, const vsg::DescriptorImage& descriptor, std::uint32_t binding)
+        {
+            auto& info = descriptor.imageInfoList.front();
+            if (info && info->imageView && info->sampler)
+            {
+                auto& vkInfo = imageInfos.emplace_back();
+                vkInfo.sampler = info->sampler->vk(deviceID);
+                vkInfo.imageView = info->imageView->vk(deviceID);
+                vkInfo.imageLayout = info->imageLayout;
+
+                auto& vkWrite = vkWrites.emplace_back();
+                vkWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                vkWrite.dstSet = descriptorSet;
+                vkWrite.dstBinding = binding;
+                vkWrite.dstArrayElement = slot;
+                vkWrite.descriptorCount = 1;
+                vkWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                vkWrite.pImageInfo = &vkInfo;
+            }
+        };
+
+    for (auto& w : _writes)
+    {
+        if (w.seq > copy.applied)
+        {
+            write(w.slot, *w.elevation, _defaultElevation->dstBinding);
+            write(w.slot, *w.color, _defaultColor->dstBinding);
+            std::memcpy(copy.data->data() + w.slot * _stride, w.uniforms->data(), _stride);
+        }
+    }
+
+    if (!vkWrites.empty())
+    {
+        vkUpdateDescriptorSets(_device->vk(), (std::uint32_t)vkWrites.size(), vkWrites.data(), 0, nullptr);
+    }
+
+    context->upload(copy.ssbo->bufferInfoList);
+
+    copy.applied = _writes.back().seq;
+
+    // drop the writes that every copy has seen, along with any retired textures.
+    auto oldest = std::min_element(_copies.begin(), _copies.end(),
+        [](const Copy& lhs, const Copy& rhs) { return lhs.applied < rhs.applied; })->applied;
+
+    while (!_writes.empty() && _writes.front().seq <= oldest)
+        _writes.pop_front();
+}
+
+void
+TerrainTileTable::compile(vsg::Context& context)
+{
+    if (!_device)
+        _device = context.device;
+
+    for (auto& copy : _copies)
+        copy.bind->compile(context);
+}
+
+void
+TerrainTileTable::record(vsg::CommandBuffer& commandBuffer) const
+{
+    _copies[_current].bind->record(commandBuffer);
+    _recorded = true;
+}
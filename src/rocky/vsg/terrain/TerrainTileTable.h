@@ -0,0 +1,132 @@
+/**
+ * rocky c++
+ * Copyright 2025 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+
+#include <rocky/vsg/VSGContext.h>
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+namespace ROCKY_NAMESPACE
+{
+    /**
+     * Table of textures and uniforms shared by all the tiles in a terrain.
+     *
+     * Instead of giving each tile its own descriptor set, every tile leases a
+     * slot in one big descriptor set that holds arrays of color and elevation
+     * textures and an SSBO of per-tile uniforms. A tile passes its slot to the
+     * shaders as the firstInstance of its draw, so the whole terrain renders
+     * with a single descriptor set bind and merging a tile allocates nothing
+     * from the descriptor pools.
+     *
+     * The table keeps a small ring of copies of its descriptor set. Changes
+     * queue up and land in the next copy during the update pass, so we never
+     * write to a descriptor set that an in-flight frame is still reading.
+     */
+    class ROCKY_EXPORT TerrainTileTable : public vsg::Inherit<vsg::StateCommand, TerrainTileTable>
+    {
+    public:
+        //! A tile's lease on one slot. The slot goes back to the table when
+        //! the last reference to the entry goes away.
+        class Entry : public vsg::Inherit<vsg::Object, Entry>
+        {
+        public:
+            //! Index of the slot in the table
+            std::uint32_t slot = 0;
+
+            ~Entry();
+
+        private:
+            vsg::ref_ptr<TerrainTileTable> _table;
+            vsg::ref_ptr<vsg::DescriptorImage> _elevation, _color;
+            friend class TerrainTileTable;
+        };
+
+        //! Construct a tile table.
+        //! @param size Number of slots in the table, including the placeholder slot zero
+        //! @param layout Terrain pipeline layout; the table occupies descriptor set 0
+        //! @param elevation Placeholder elevation texture for empty slots
+        //! @param color Placeholder color texture for empty slots
+        //! @param uniforms Placeholder per-tile uniform block for empty slots
+        //! @param uniformsBinding Binding point of the per-tile uniforms SSBO
+        //! @param settings Terrain-wide settings UBO that shares the descriptor set
+        TerrainTileTable(
+            std::uint32_t size,
+            vsg::ref_ptr<vsg::PipelineLayout> layout,
+            vsg::ref_ptr<vsg::DescriptorImage> elevation,
+            vsg::ref_ptr<vsg::DescriptorImage> color,
+            vsg::ref_ptr<vsg::ubyteArray> uniforms,
+            std::uint32_t uniformsBinding,
+            vsg::ref_ptr<vsg::Descriptor> settings);
+
+        //! Leases a slot and queues its contents for the next frame. The
+        //! textures must already be compiled. Thread-safe.
+        //! @return the new entry, or nullptr if the table is full
+        vsg::ref_ptr<Entry> add(
+            vsg::ref_ptr<vsg::DescriptorImage> elevation,
+            vsg::ref_ptr<vsg::DescriptorImage> color,
+            vsg::ref_ptr<vsg::ubyteArray> uniforms);
+
+        //! Applies queued changes to the descriptor set the next frame
+        //! will use. Call once per update pass, before recording.
+        void update(VSGContext& context);
+
+        //! Number of slots in the table
+        inline std::uint32_t size() const {
+            return _size;
+        }
+
+        //! Number of slots currently leased
+        std::uint32_t leased() const;
+
+        //! Number of descriptor set copies the table cycles through. This must
+        //! exceed the number of frames VSG keeps in flight.
+        static constexpr unsigned numCopies = 4;
+
+    public:
+
+        void compile(vsg::Context& context) override;
+
+        void record(vsg::CommandBuffer& commandBuffer) const override;
+
+    private:
+
+        struct Write
+        {
+            std::uint64_t seq;
+            std::uint32_t slot;
+            vsg::ref_ptr<vsg::DescriptorImage> elevation, color;
+            vsg::ref_ptr<vsg::ubyteArray> uniforms;
+            // textures that stay alive until every copy stops referencing them
+            vsg::ref_ptr<vsg::DescriptorImage> retiredElevation, retiredColor;
+        };
+
+        struct Copy
+        {
+            vsg::ref_ptr<vsg::ubyteArray> data;
+            vsg::ref_ptr<vsg::DescriptorBuffer> ssbo;
+            vsg::ref_ptr<vsg::BindDescriptorSet> bind;
+            std::uint64_t applied = 0;
+        };
+
+        std::uint32_t _size = 0;
+        std::uint32_t _stride = 0;
+        vsg::ref_ptr<vsg::DescriptorImage> _defaultElevation, _defaultColor;
+        vsg::ref_ptr<vsg::ubyteArray> _defaultUniforms;
+
+        mutable std::mutex _mutex;
+        std::vector<std::uint32_t> _free;
+        std::deque<Write> _writes;
+        std::uint64_t _seq = 0;
+
+        std::vector<Copy> _copies;
+        unsigned _current = 0;
+        mutable std::atomic_bool _recorded = { false };
+        vsg::ref_ptr<vsg::Device> _device;
+
+        void release(Entry& entry);
+    };
+}
@@ -11,6 +11,7 @@
 #include <condition_variable>
 #include <cstdlib>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <type_traits>
@@ -492,21 +493,90 @@ namespace WEEJOBS_NAMESPACE
         {
             context ctx;
             std::function<bool()> _delegate;
+            float _priority = 0.0f; // cached result of ctx.priority()
+            std::uint64_t _sequence = 0u; // dispatch order, for FIFO among equals
 
+            //! Heap ordering: lower priority first, then later dispatch first,
+            //! so the front of a max-heap is the oldest highest-priority job.
             bool operator < (const job& rhs) const
             {
-                float lp = ctx.priority ? ctx.priority() : -FLT_MAX;
-                float rp = rhs.ctx.priority ? rhs.ctx.priority() : -FLT_MAX;
-                return lp < rp;
+                if (_priority != rhs._priority)
+                    return _priority < rhs._priority;
+                return _sequence > rhs._sequence;
             }
+
+            inline void update_priority()
+            {
+                _priority = ctx.priority ? ctx.priority() : 0.0f;
+            }
+        };
+
+        /**
+        * One worker's share of a job pool's queue: a max-heap on cached
+        * priority with its own lock.
+        */
+        struct job_queue
+        {
+            std::mutex mutex;
+            std::vector<job> heap;
+            std::atomic_uint size = { 0u };
+            std::chrono::steady_clock::time_point last_refresh = std::chrono::steady_clock::now();
+
+            // Must hold mutex.
+            inline void push(job&& j)
+            {
+                heap.emplace_back(std::move(j));
+                std::push_heap(heap.begin(), heap.end());
+                size = (unsigned)heap.size();
+            }
+
+            // Must hold mutex.
+            inline bool pop(job& output)
+            {
+                if (heap.empty())
+                    return false;
+                std::pop_heap(heap.begin(), heap.end());
+                output = std::move(heap.back());
+                heap.pop_back();
+                size = (unsigned)heap.size();
+                return true;
+            }
+
+            // Must hold mutex.
+            inline void refresh()
+            {
+                for (auto& j : heap)
+                    j.update_priority();
+                std::make_heap(heap.begin(), heap.end());
+                last_refresh = std::chrono::steady_clock::now();
+            }
+        };
+
+        //! Identifies the pool and queue of the calling thread if it's a worker.
+        struct worker_id
+        {
+            class jobpool* pool = nullptr;
+            unsigned index = 0u;
         };
 
+        inline worker_id& this_worker()
+        {
+            static thread_local worker_id id;
+            return id;
+        }
+
         inline bool steal_job(class jobpool* thief, detail::job& stolen);
     }
 
     /**
     * A priority-sorted collection of jobs that are running or waiting
     * to run in a thread pool.
+    *
+    * Each worker thread owns a queue. Jobs dispatched from a worker go into
+    * its own queue (keeping fork-join work local); jobs dispatched from other
+    * threads are spread round-robin. A worker takes the highest priority job
+    * from its own queue and steals from its siblings only when that is empty,
+    * so workers rarely contend for the same lock.
     */
     class jobpool
     {
@@ -567,13 +637,46 @@ namespace WEEJOBS_NAMESPACE
             _can_steal_work = value;
         }
 
+        //! Re-evaluate the priority function of every queued job.
+        //! Priorities are cached when a job is dispatched, and refreshed here
+        //! so that dequeueing is O(log n) instead of a full scan.
+        //! Call this whenever priorities may have changed (e.g., once per frame);
+        //! the pool also calls it itself when the cached values become older than
+        //! the refresh interval.
+        void refresh_priorities()
+        {
+            for (unsigned i = 0; i < num_queues(); ++i)
+            {
+                std::lock_guard<std::mutex> lock(_queues[i]->mutex);
+                _queues[i]->refresh();
+            }
+        }
+
+        //! Maximum age of cached job priorities before the pool refreshes
+        //! them automatically. Zero means only refresh on demand.
+        //! Default = 100ms.
+        void set_priority_refresh_interval(std::chrono::steady_clock::duration value)
+        {
+            _priority_refresh_interval = value;
+        }
+
         //! Discard all queued jobs
         void cancel_all()
         {
-            std::lock_guard<std::mutex> lock(_queue_mutex);
-            _queue.clear();
-            _metrics.canceled += _metrics.pending;
-            _metrics.pending = 0;
+            for (unsigned i = 0; i < num_queues(); ++i)
+            {
+                auto& q = *_queues[i];
+                std::lock_guard<std::mutex> lock(q.mutex);
+                for (auto& queuedjob : q.heap)
+                {
+                    if (queuedjob.ctx.group != nullptr)
+                        queuedjob.ctx.group->release();
+                }
+                _metrics.canceled += (unsigned)q.heap.size();
+                _metrics.pending -= (unsigned)q.heap.size();
+                q.heap.clear();
+                q.size = 0u;
+            }
         }
 
         //! Schedule an asynchronous task on this scheduler
@@ -592,13 +695,24 @@ namespace WEEJOBS_NAMESPACE
 
                 if (_target_concurrency > 0)
                 {
-                    std::lock_guard<std::mutex> lock(_queue_mutex);
+                    detail::job job{ context, delegate };
+                    job.update_priority();
+                    job._sequence = _sequence++;
 
-                    _queue.emplace_back(detail::job{ context, delegate });
+                    // local push if we're one of our own workers, otherwise round-robin
+                    auto& me = detail::this_worker();
+                    unsigned n = num_queues();
+                    unsigned index = me.pool == this ? me.index % n : _next_queue++ % n;
 
+                    // count it before it's visible, so a worker can't pop it and decrement first
                     _metrics.pending++;
                     _metrics.total++;
-                    _block.notify_one();
+                    {
+                        std::lock_guard<std::mutex> lock(_queues[index]->mutex);
+                        _queues[index]->push(std::move(job));
+                    }
+
+                    wake(false);
                 }
                 else
                 {
@@ -613,47 +727,55 @@ namespace WEEJOBS_NAMESPACE
             }
         }
 
-        //! removes the highest priority job from the queue and places it
-        //! in output. Returns true if a job was taken, false if the queue
+        //! Removes the highest priority job from the queue at index "first" and
+        //! places it in output; if that queue is empty, steals from the other
+        //! queues in the pool. Returns true if a job was taken, false if the pool
         //! was empty.
-        inline bool _take_job(detail::job& output, bool lock)
+        inline bool _take_job(detail::job& output, unsigned first = 0u)
         {
-            if (lock)
-            {
-                std::lock_guard<std::mutex> lock(_queue_mutex);
-                return _take_job(output, false);
-            }
-            else if (!_done && !_queue.empty())
-            {
-                auto ptr = _queue.end();
-                float highest_priority = -FLT_MAX;
-                for (auto iter = _queue.begin(); iter != _queue.end(); ++iter)
-                {
-                    float priority = iter->ctx.priority != nullptr ?
-                        iter->ctx.priority() :
-                        0.0f;
+            if (_done)
+                return false;
 
-                    if (ptr == _queue.end() || priority > highest_priority)
-                    {
-                        ptr = iter;
-                        highest_priority = priority;
-                    }
-                }
+            unsigned n = num_queues();
+            auto interval = _priority_refresh_interval.load();
 
-                if (ptr == _queue.end())
-                    ptr = _queue.begin();
+            for (unsigned i = 0; i < n; ++i)
+            {
+                auto& q = *_queues[(first + i) % n];
+                if (q.size == 0u)
+                    continue;
 
-                output = std::move(*ptr);
-                if (_queue.size() > 1)
-                    *ptr = std::move(_queue.back());
-                _queue.resize(_queue.size() - 1);
+                std::lock_guard<std::mutex> lock(q.mutex);
 
-                _metrics.pending--;
-                return true;
+                if (interval.count() > 0 && std::chrono::steady_clock::now() - q.last_refresh > interval)
+                    q.refresh();
+
+                if (q.pop(output))
+                {
+                    _metrics.pending--;
+                    return true;
+                }
             }
             return false;
         }
 
+        //! Number of job queues currently in use
+        inline unsigned num_queues() const
+        {
+            return _num_queues.load(std::memory_order_acquire);
+        }
+
+        //! Wake up sleeping workers
+        inline void wake(bool all)
+        {
+            // taking the lock orders this with the predicate check in run()
+            { std::lock_guard<std::mutex> lock(_sleep_mutex); }
+            if (all)
+                _block.notify_all();
+            else
+                _block.notify_one();
+        }
+
         //! Construct a new job pool.
         //! Do not call this directly - call getPool(name) instead.
         jobpool(const std::string& name, unsigned concurrency) :
@@ -661,7 +783,8 @@ namespace WEEJOBS_NAMESPACE
         {
             _metrics.name = name;
             _metrics.concurrency = 0;
-            _queue.reserve(256);
+            _queues[0] = std::make_unique<detail::job_queue>();
+            _num_queues = 1u;
         }
 
         //! Pulls queued jobs and runs them in whatever thread run() is called from.
@@ -677,13 +800,19 @@ namespace WEEJOBS_NAMESPACE
         //! Wait for all threads to exit (after calling stop_threads)
         inline void join_threads();
 
-        bool _can_steal_work = true;
-        std::vector<detail::job> _queue;
-        mutable std::mutex _queue_mutex; // protect access to the queue
+        std::atomic_bool _can_steal_work = { true };
+        static constexpr unsigned max_queues = 64u;
+        std::unique_ptr<detail::job_queue> _queues[max_queues]; // one per worker; never shrinks
+        std::atomic_uint _num_queues = { 0u }; // number of _queues in use
+        std::atomic_uint _next_queue = { 0u }; // round-robin target for external dispatch
+        std::atomic_uint64_t _sequence = { 0u }; // next job sequence number
+        std::atomic<std::chrono::steady_clock::duration> _priority_refresh_interval = { std::chrono::milliseconds(100) };
+        unsigned _next_worker_index = 0u; // index of the next thread spawned
+        std::mutex _sleep_mutex; // protects waiting on _block
         mutable std::mutex _quit_mutex; // protects access to _done
         std::atomic<unsigned> _target_concurrency; // target number of concurrent threads in the pool
         std::condition_variable_any _block; // thread waiter block
-        bool _done = false; // set to true when threads should exit
+        std::atomic_bool _done = { false }; // set to true when threads should exit
         std::vector<std::thread> _threads; // threads in the pool
         metrics_t _metrics; // metrics for this pool
     };
@@ -777,7 +906,7 @@ namespace WEEJOBS_NAMESPACE
 
                     for (auto pool : instance()._pools)
                     {
-                        pool->_block.notify_all();
+                        pool->wake(true);
                     }
                 }
             }
@@ -908,45 +1037,34 @@ namespace WEEJOBS_NAMESPACE
 
     inline void jobpool::run()
     {
+        unsigned index = detail::this_worker().index;
+
         while (!_done)
         {
             detail::job next;
-            bool have_next = false;
-            {
-                if (_can_steal_work && instance()._stealing_allowed)
-                {
-                    {
-                        std::unique_lock<std::mutex> lock(_queue_mutex);
+            bool have_next = _take_job(next, index);
 
-                        // work-stealing enabled: wait until any queue is non-empty
-                        _block.wait(lock, [this]() { return get_metrics()->total_pending() > 0 || _done; });
+            if (!have_next && !_done && _can_steal_work && instance()._stealing_allowed)
+            {
+                have_next = detail::steal_job(this, next);
+            }
 
-                        if (!_done && !_queue.empty())
-                        {
-                            have_next = _take_job(next, false);
-                        }
-                    }
+            if (!have_next)
+            {
+                std::unique_lock<std::mutex> lock(_sleep_mutex);
 
-                    if (!_done && !have_next)
-                    {
-                        have_next = detail::steal_job(this, next);
-                    }
+                if (_can_steal_work && instance()._stealing_allowed)
+                {
+                    // work-stealing enabled: wait until any queue is non-empty
+                    _block.wait(lock, [this]() { return get_metrics()->total_pending() > 0 || _done; });
                 }
                 else
                 {
-                    std::unique_lock<std::mutex> lock(_queue_mutex);
-
-                    // wait until just our local queue is non-empty
-                    _block.wait(lock, [this] { return !_queue.empty() || _done; });
-
-                    if (!_done && !_queue.empty())
-                    {
-                        have_next = _take_job(next, false);
-                    }
+                    // wait until just our local queues are non-empty
+                    _block.wait(lock, [this] { return _metrics.pending > 0 || _done; });
                 }
             }
-
-            if (have_next)
+            else
             {
                 _metrics.running++;
 
@@ -991,8 +1109,18 @@ namespace WEEJOBS_NAMESPACE
         {
             _metrics.concurrency++;
 
-            _threads.push_back(std::thread([this]
+            // give the new worker its own queue
+            unsigned index = _next_worker_index++;
+            if (index < max_queues && index >= num_queues())
+            {
+                _queues[index] = std::make_unique<detail::job_queue>();
+                _num_queues.store(index + 1, std::memory_order_release);
+            }
+
+            _threads.push_back(std::thread([this, index]
                 {
+                    detail::this_worker() = { this, index };
+
                     if (instance()._set_thread_name)
                     {
                         instance()._set_thread_name(_metrics.name.c_str());
@@ -1007,22 +1135,28 @@ namespace WEEJOBS_NAMESPACE
     {
         _done = true;
 
-        // Clear out the queue
-        std::lock_guard<std::mutex> lock(_queue_mutex);
-
-        // reset any group semaphores so that JobGroup.join()
-        // will not deadlock.
-        for (auto& queuedjob : _queue)
+        // Clear out the queues
+        for (unsigned i = 0; i < num_queues(); ++i)
         {
-            if (queuedjob.ctx.group != nullptr)
+            auto& q = *_queues[i];
+            std::lock_guard<std::mutex> lock(q.mutex);
+
+            // reset any group semaphores so that JobGroup.join()
+            // will not deadlock.
+            for (auto& queuedjob : q.heap)
             {
-                queuedjob.ctx.group->release();
+                if (queuedjob.ctx.group != nullptr)
+                {
+                    queuedjob.ctx.group->release();
+                }
             }
+            _metrics.pending -= (unsigned)q.heap.size();
+            q.heap.clear();
+            q.size = 0u;
         }
-        _queue.clear();
 
         // wake up all threads so they can exit
-        _block.notify_all();
+        wake(true);
     }
 
     //! Wait for all threads to exit (after calling stop_threads)
@@ -1052,9 +1186,9 @@ namespace WEEJOBS_NAMESPACE
             {
                 if (pool != thief)
                 {
-                    if (static_cast<std::size_t>(pool->_queue.size()) > max_num_jobs)
+                    if (static_cast<std::size_t>(pool->_metrics.pending) > max_num_jobs)
                     {
-                        max_num_jobs = pool->_queue.size();
+                        max_num_jobs = pool->_metrics.pending;
                         pool_with_most_jobs = pool;
                     }
                 }
@@ -1063,7 +1197,7 @@ namespace WEEJOBS_NAMESPACE
 
         if (pool_with_most_jobs)
         {
-            return pool_with_most_jobs->_take_job(stolen, true);
+            return pool_with_most_jobs->_take_job(stolen);
         }
 
         return false;
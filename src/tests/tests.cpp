@@ -2,11 +2,31 @@
 #include "catch.hpp"
 
 #include <rocky/rocky.h>
+#include <rocky/DiskCache.h>
+#include <rocky/SentryTracker.h>
+#include <rocky/TerrainTileModelFactory.h>
+#include <rocky/vsg/ecs/LineSystem.h>
+#include <rocky/vsg/terrain/CameraPredictor.h>
+#include <rocky/vsg/terrain/GeometryArena.h>
+#include <rocky/vsg/terrain/GeometryPool.h>
+#include <rocky/vsg/terrain/TerrainTilePager.h>
+#include <rocky/vsg/terrain/TerrainTileTable.h>
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <numeric>
 #include <random>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 #define ROCKY_EXPOSE_JSON_FUNCTIONS
 #include <rocky/json.h>
 
+#ifdef ROCKY_HAS_HTTPLIB
+#include <httplib.h>
+#endif
+
 using namespace ROCKY_NAMESPACE;
 using namespace ROCKY_NAMESPACE::util;
 
@@ -19,6 +39,37 @@ namespace
             return ResultVoidOK;
         }
     };
+
+    // Image layer that takes a while to produce each tile, like a slow server
+    class SlowImageLayer : public Inherit<ImageLayer, SlowImageLayer>
+    {
+    public:
+        Result<> openImplementation(const IOOptions& io) override {
+            auto r = super::openImplementation(io);
+            profile = Profile("global-geodetic");
+            return r;
+        }
+        Result<GeoImage> createTileImplementation(const TileKey& key, const IOOptions& io) const override {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            return GeoImage(Image::create(Image::R8G8B8A8_UNORM, 16, 16), key.extent());
+        }
+    };
+
+    class SlowElevationLayer : public Inherit<ElevationLayer, SlowElevationLayer>
+    {
+    public:
+        Result<> openImplementation(const IOOptions& io) override {
+            auto r = super::openImplementation(io);
+            profile = Profile("global-geodetic");
+            return r;
+        }
+        Result<GeoImage> createTileImplementation(const TileKey& key, const IOOptions& io) const override {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            auto hf = Heightfield::create(17, 17);
+            hf.fill(0.0f);
+            return GeoImage(hf.image, key.extent());
+        }
+    };
 }
 
 TEST_CASE("strings")
@@ -108,6 +159,100 @@ TEST_CASE("TileKey")
     CHECK(TileKey(2, 0, 0, p).quadKey() == "000");
     CHECK(TileKey(2, 1, 0, p).quadKey() == "001");
     CHECK(TileKey(2, 5, 1, p).quadKey() == "103");
+
+    // compact IDs
+    TileKey key(12, 3071, 1024, p);
+    CHECK(key.id().valid());
+    CHECK(key.id().level() == 12);
+    CHECK(key.id().x() == 3071);
+    CHECK(key.id().y() == 1024);
+    CHECK(TileKey(key.id()) == key);
+    CHECK(key.id() == TileKey(12, 3071, 1024, Profile("global-geodetic")).id());
+    CHECK(key.id() != TileKey(12, 3071, 1024, Profile("spherical-mercator")).id());
+    CHECK(key.id() != key.createParentKey().id());
+    CHECK(key.createChildKey(3).id() != key.createChildKey(2).id());
+    CHECK(TileKey(25, (1u << 26) - 1, 0, p).id().valid());
+    CHECK(TileKey(26, 1u << 26, 0, p).id().valid() == false);
+    CHECK(TileKey().id().valid() == false);
+    CHECK(TileKey(TileID()).valid() == false);
+
+    // hashing: equal keys agree, and neighbors spread across the low bits
+    std::hash<TileKey> hasher;
+    CHECK(hasher(key) == hasher(TileKey(12, 3071, 1024, Profile("global-geodetic"))));
+    CHECK(hasher(TileKey(26, 1u << 26, 0, p)) != hasher(TileKey(26, 1u << 26, 1, p)));
+    std::unordered_set<std::size_t> buckets;
+    for (unsigned x = 0; x < 32; ++x)
+        for (unsigned y = 0; y < 32; ++y)
+            buckets.insert(hasher(TileKey(10, x, y, p)) & 1023);
+    CHECK(buckets.size() > 512);
+}
+
+TEST_CASE("Tile table", "[.benchmark]")
+{
+    // Compares tile tables keyed by TileKey and by TileID, with 50k resident
+    // tiles gathered along random paths down a global-geodetic quadtree.
+    // Hidden by default; run with: rocky_tests "[.benchmark]"
+    const std::size_t count = 50000;
+    Profile p("global-geodetic");
+
+    std::mt19937 rng(42);
+    std::vector<TileKey> keys;
+    {
+        std::unordered_set<TileKey> unique;
+        while (unique.size() < count)
+        {
+            TileKey key(0, rng() % 2, 0, p);
+            for (unsigned level = 0; level < 18 && unique.size() < count; ++level)
+            {
+                if (unique.emplace(key).second)
+                    keys.emplace_back(key);
+                key = key.createChildKey(rng() % 4);
+            }
+        }
+    }
+
+    std::vector<TileKey> lookups(keys);
+    std::shuffle(lookups.begin(), lookups.end(), rng);
+
+    // the pager computes each tile's ID once, when it creates the tile
+    std::vector<TileID> ids, idLookups;
+    for (auto& key : keys)
+        ids.emplace_back(key.id());
+    for (auto& key : lookups)
+        idLookups.emplace_back(key.id());
+
+    auto us = [](auto d) { return std::chrono::duration_cast<std::chrono::microseconds>(d).count(); };
+
+    auto run = [&](const std::string& name, auto& table, auto& inserts, auto& finds)
+        {
+            std::size_t found = 0;
+            auto t0 = std::chrono::steady_clock::now();
+            for (auto& key : inserts)
+                table[key] = 1;
+            auto t1 = std::chrono::steady_clock::now();
+            for (int pass = 0; pass < 10; ++pass)
+                for (auto& key : finds)
+                    found += table.count(key);
+            auto t2 = std::chrono::steady_clock::now();
+            for (auto& key : finds)
+                table.erase(key);
+            auto t3 = std::chrono::steady_clock::now();
+
+            CHECK(found == count * 10);
+            CHECK(table.empty());
+
+            std::cout << "Tile table " << name << " (" << count << " tiles): insert " << us(t1 - t0)
+                << " us, 10x find " << us(t2 - t1) << " us, erase " << us(t3 - t2) << " us" << std::endl;
+        };
+
+    std::map<TileKey, int> ordered;
+    run("std::map<TileKey>", ordered, keys, lookups);
+
+    std::unordered_map<TileKey, int> hashed;
+    run("std::unordered_map<TileKey>", hashed, keys, lookups);
+
+    std::unordered_map<TileID, int> packed;
+    run("std::unordered_map<TileID>", packed, ids, idLookups);
 }
 
 TEST_CASE("Threading")
@@ -131,6 +276,331 @@ TEST_CASE("Threading")
     CHECK(f2.value() == 123);
 }
 
+TEST_CASE("SingleFlight")
+{
+    detail::SingleFlight<std::string, int> flight;
+
+    SECTION("Coalesce")
+    {
+        std::atomic_int calls = { 0 }, entered = { 0 }, joined = { 0 };
+        const int count = 8;
+
+        std::vector<std::thread> threads;
+        std::vector<int> results(count, 0);
+        for (int i = 0; i < count; ++i)
+        {
+            threads.emplace_back([&, i]()
+                {
+                    ++entered;
+                    bool j = false;
+                    results[i] = flight.run("key", [&]()
+                        {
+                            ++calls;
+                            // hold the flight open until everyone has arrived
+                            while (entered < count)
+                                std::this_thread::yield();
+                            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                            return 42;
+                        }, &j).value_or(0);
+                    if (j) ++joined;
+                });
+        }
+        for (auto& t : threads)
+            t.join();
+
+        CHECK(calls == 1);
+        CHECK(joined == count - 1);
+        CHECK(std::count(results.begin(), results.end(), 42) == count);
+        CHECK(flight.size() == 0);
+    }
+
+    SECTION("Leader throws")
+    {
+        std::atomic_bool started = { false };
+        std::atomic_int rethrown = { 0 };
+
+        std::thread leader([&]()
+            {
+                try {
+                    flight.run("throw", [&]() -> int
+                        {
+                            started = true;
+                            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                            throw std::runtime_error("failed");
+                        });
+                }
+                catch (const std::runtime_error&) { ++rethrown; }
+            });
+
+        while (!started)
+            std::this_thread::yield();
+
+        try {
+            flight.run("throw", []() -> int { throw std::runtime_error("failed"); });
+        }
+        catch (const std::runtime_error&) { ++rethrown; }
+
+        leader.join();
+        CHECK(rethrown == 2);
+        CHECK(flight.size() == 0);
+    }
+
+    SECTION("Follower canceled")
+    {
+        struct Canceled : public Cancelable {
+            std::atomic_bool value = { false };
+            bool canceled() const override { return value; }
+        } cancel;
+
+        std::atomic_bool started = { false }, release = { false };
+        std::thread leader([&]()
+            {
+                flight.run("slow", [&]()
+                    {
+                        started = true;
+                        while (!release)
+                            std::this_thread::yield();
+                        return 1;
+                    });
+            });
+
+        while (!started)
+            std::this_thread::yield();
+
+        std::thread canceler([&]()
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                cancel.value = true;
+            });
+
+        auto result = flight.run("slow", []() { return 2; }, nullptr, &cancel);
+        CHECK(result.has_value() == false);
+
+        release = true;
+        leader.join();
+        canceler.join();
+        CHECK(flight.size() == 0);
+    }
+}
+
+TEST_CASE("Concurrent IO")
+{
+    IOOptions io;
+    std::vector<int> results(10, 0);
+    std::atomic_int calls = { 0 };
+
+    auto start = std::chrono::steady_clock::now();
+    detail::concurrentIO((unsigned)results.size(), [&](unsigned i, const IOOptions&)
+        {
+            ++calls;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            results[i] = (int)i + 1;
+        }, io);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    CHECK(calls == 10);
+    CHECK(std::accumulate(results.begin(), results.end(), 0) == 55);
+
+    // the waits should overlap:
+    CHECK(elapsed < std::chrono::milliseconds(400));
+
+    // cap the fan-out:
+    std::atomic_int active = { 0 }, peak = { 0 };
+    calls = 0;
+    detail::concurrentIO(12u, [&](unsigned i, const IOOptions&)
+        {
+            ++calls;
+            int now = ++active;
+            for (int p = peak; now > p && !peak.compare_exchange_weak(p, now); );
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            --active;
+        }, io, 3u);
+
+    CHECK(calls == 12);
+    CHECK(peak <= 3);
+}
+
+TEST_CASE("Tile model layer fan-out")
+{
+    auto map = Map::create();
+    IOOptions io;
+    for (int i = 0; i < 4; ++i)
+    {
+        auto layer = SlowImageLayer::create();
+        layer->open(io);
+        map->add(layer);
+    }
+    auto elevation = SlowElevationLayer::create();
+    elevation->open(io);
+    map->add(elevation);
+
+    TerrainTileModelFactory factory;
+    factory.compositeColorLayers = false;
+    factory.maxConcurrentLayers = 5;
+
+    // Five 100ms layers; one after the other they would take 500ms.
+    auto build = [&](unsigned x)
+        {
+            auto start = std::chrono::steady_clock::now();
+            auto model = factory.createTileModel(map.get(), TileKey(1, x, 0, Profile("global-geodetic")), io);
+            CHECK(model.colorLayers.size() == 4);
+            return std::chrono::steady_clock::now() - start;
+        };
+
+    SECTION("From a loader thread")
+    {
+        CHECK(build(0) < std::chrono::milliseconds(300));
+    }
+
+    SECTION("From an I/O thread")
+    {
+        // nested fan-outs must still run in parallel when they start on an I/O thread
+        auto elapsed = jobs::dispatch([&](Cancelable&) { return build(1); },
+            jobs::context{ "fan-out test", detail::ioPool() }).join();
+
+        CHECK(elapsed < std::chrono::milliseconds(300));
+    }
+}
+
+TEST_CASE("Job priority")
+{
+    auto pool = jobs::get_pool("rocky::test_priority", 1);
+    auto group = jobs::jobgroup::create();
+    std::atomic_bool go = { false };
+    std::mutex mutex;
+    std::vector<int> order;
+
+    // occupy the only thread so everything else queues up:
+    jobs::dispatch([&]() { while (!go) std::this_thread::yield(); },
+        jobs::context{ "blocker", pool, []() { return FLT_MAX; }, group });
+
+    // id = priority * 10 + dispatch index
+    for (int id : { 10, 31, 22, 33 })
+    {
+        float priority = (float)(id / 10);
+        jobs::dispatch([&mutex, &order, id]() { std::scoped_lock lock(mutex); order.push_back(id); },
+            jobs::context{ "job", pool, [priority]() { return priority; }, group });
+    }
+
+    go = true;
+    group->join();
+
+    // highest priority first; equal priorities in dispatch order:
+    REQUIRE(order.size() == 4);
+    CHECK(order[0] == 31);
+    CHECK(order[1] == 33);
+    CHECK(order[2] == 22);
+    CHECK(order[3] == 10);
+}
+
+TEST_CASE("Job queue throughput", "[.benchmark]")
+{
+    // Measures dispatch and dequeue cost with a deep queue of prioritized jobs.
+    // Hidden by default; run with: rocky_tests "[.benchmark]"
+    const int count = 10000;
+    auto pool = jobs::get_pool("rocky::benchmark_queue", 1);
+    auto group = jobs::jobgroup::create();
+    std::atomic_bool go = { false };
+    std::atomic_int done = { 0 };
+
+    jobs::dispatch([&]() { while (!go) std::this_thread::yield(); },
+        jobs::context{ "blocker", pool, []() { return FLT_MAX; }, group });
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(0.0f, 1000.0f);
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i)
+    {
+        float p = dist(rng);
+        jobs::dispatch([&done]() { ++done; },
+            jobs::context{ "job", pool, [p]() { return p; }, group });
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    go = true;
+    group->join();
+    auto t2 = std::chrono::steady_clock::now();
+
+    CHECK(done == count);
+
+    auto us = [](auto d) { return std::chrono::duration_cast<std::chrono::microseconds>(d).count(); };
+    std::cout << "Job queue (" << count << " jobs): dispatch " << us(t1 - t0) << " us, dequeue+run "
+        << us(t2 - t1) << " us" << std::endl;
+}
+
+TEST_CASE("Job fork-join throughput", "[.benchmark]")
+{
+    // Measures scheduling overhead of many small jobs that spawn more jobs
+    // into the same pool, across all cores.
+    // Hidden by default; run with: rocky_tests "[.benchmark]"
+    const unsigned threads = std::max(2u, std::thread::hardware_concurrency());
+    const int rounds = 50, parents = 256, children = 8;
+    auto pool = jobs::get_pool("rocky::benchmark_forkjoin", threads);
+    std::atomic_int done = { 0 };
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r)
+    {
+        auto group = jobs::jobgroup::create();
+        for (int p = 0; p < parents; ++p)
+        {
+            jobs::dispatch([&done, pool, group]()
+                {
+                    for (int c = 0; c < children; ++c)
+                        jobs::dispatch([&done]() { ++done; }, jobs::context{ "child", pool, {}, group });
+                    ++done;
+                },
+                jobs::context{ "parent", pool, {}, group });
+        }
+        group->join();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    const int total = rounds * parents * (children + 1);
+    CHECK(done == total);
+
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+    std::cout << "Fork-join (" << threads << " threads, " << total << " jobs): " << us << " us, "
+        << (us > 0 ? (std::int64_t)total * 1000000 / us : 0) << " jobs/s" << std::endl;
+}
+
+TEST_CASE("Image kernel throughput", "[.benchmark]")
+{
+    // Compares per-pixel bilinear sampling against the batch kernels.
+    // Hidden by default; run with: rocky_tests "[.benchmark]"
+    const unsigned size = 512;
+    std::mt19937 engine(0);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    std::vector<glm::fvec2> uv(size * size);
+    for (auto& c : uv)
+        c = { unit(engine), unit(engine) };
+    std::vector<Image::Pixel> out(uv.size());
+
+    auto mps = [&](auto t0, auto t1) {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+        return us > 0 ? (double)uv.size() / (double)us : 0.0;
+        };
+
+    for (auto format : { Image::R8G8B8A8_UNORM, Image::R8G8B8A8_SRGB, Image::R16_UNORM, Image::R32_SFLOAT })
+    {
+        auto image = Image::create(format, size, size);
+        image->fill(Image::Pixel(0.25f, 0.5f, 0.75f, 1.0f));
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < uv.size(); ++i)
+            out[i] = image->read_bilinear(uv[i].x, uv[i].y);
+        auto t1 = std::chrono::steady_clock::now();
+        image->read_bilinear(uv.data(), (unsigned)uv.size(), out.data());
+        auto t2 = std::chrono::steady_clock::now();
+        auto sharp = image->sharpen();
+        auto t3 = std::chrono::steady_clock::now();
+
+        std::cout << "Format " << format << ": bilinear scalar " << mps(t0, t1) << " MP/s, batch "
+            << mps(t1, t2) << " MP/s; sharpen " << mps(t2, t3) << " MP/s" << std::endl;
+    }
+}
+
 TEST_CASE("Math")
 {
     CHECK(is_identity(glm::fmat4(1)));
@@ -218,6 +688,147 @@ TEST_CASE("Image")
     CHECK(glm::epsilonEqual(value.g, 0.65f, 0.01f));
     CHECK(glm::epsilonEqual(value.b, 0.0f, 0.01f));
     CHECK(glm::epsilonEqual(value.a, 1.0f, 0.01f));
+
+    SECTION("Adopted data")
+    {
+        auto buffer = std::make_shared<std::vector<unsigned char>>(16 * 16 * 4, (unsigned char)255);
+        std::weak_ptr<std::vector<unsigned char>> weak = buffer;
+
+        auto adopted = Image::create(Image::R8G8B8A8_UNORM, 16, 16, 1, buffer->data(), buffer);
+        buffer = nullptr;
+        CHECK(adopted->ownsData() == false);
+        CHECK(adopted->data<unsigned char>() == weak.lock()->data()); // no copy
+        CHECK(glm::epsilonEqual(adopted->read(3, 3).r, 1.0f, 0.01f));
+
+        // moving hands off the owner:
+        Image moved(std::move(*adopted));
+        CHECK(moved.valid());
+        CHECK(adopted->valid() == false);
+        CHECK(weak.expired() == false);
+
+        // releasing adopted data yields a private copy:
+        auto released = moved.releaseData();
+        CHECK(released != nullptr);
+        CHECK(weak.expired() == true);
+        delete[] released;
+    }
+
+    SECTION("Batch kernels")
+    {
+        std::mt19937 engine(0);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        for (auto format : { Image::R8G8B8A8_UNORM, Image::R8G8B8A8_SRGB, Image::R16_UNORM, Image::R32_SFLOAT, Image::R8G8B8_UNORM })
+        {
+            auto src = Image::create(format, 64, 32);
+            std::vector<Image::Pixel> row(src->width());
+            for (unsigned t = 0; t < src->height(); ++t)
+            {
+                for (auto& p : row)
+                    p = Image::Pixel(unit(engine), unit(engine), unit(engine), unit(engine));
+                src->writeRow(row.data(), (unsigned)row.size(), 0, t);
+
+                // single-pixel reads agree with the row write:
+                std::vector<Image::Pixel> check(row.size());
+                src->readRow(check.data(), (unsigned)check.size(), 0, t);
+                CHECK(check[7] == src->read(7, t));
+            }
+
+            // batch bilinear reads agree with single ones:
+            std::vector<glm::fvec2> uv(500);
+            for (auto& c : uv)
+                c = { unit(engine), unit(engine) };
+            std::vector<Image::Pixel> batch(uv.size());
+            src->read_bilinear(uv.data(), (unsigned)uv.size(), batch.data());
+
+            unsigned mismatches = 0;
+            for (unsigned i = 0; i < uv.size(); ++i)
+                if (batch[i] != src->read_bilinear(uv[i].x, uv[i].y))
+                    ++mismatches;
+            CHECK(mismatches == 0);
+
+            auto sharp = src->sharpen();
+            REQUIRE(sharp);
+            CHECK(sharp->pixelFormat() == format);
+        }
+    }
+
+    SECTION("Block compression")
+    {
+        // smooth color ramps with an alpha gradient and a few transparent holes
+        auto src = Image::create(Image::R8G8B8A8_UNORM, 64, 36);
+        src->eachPixel([&](auto& i)
+            {
+                float u = (float)i.u(), v = (float)i.v();
+                float a = ((i.s() / 4 + i.t() / 4) % 7 == 0) ? 0.0f : 1.0f - 0.5f * v;
+                src->write(Image::Pixel(u, v, 0.5f + 0.4f * std::sin(6.0f * u) * std::cos(4.0f * v), a), i);
+            });
+
+        auto psnr = [&](const Image& a, const Image& b, unsigned first, unsigned last, bool opaqueOnly)
+            {
+                double se = 0.0, n = 0.0;
+                for (unsigned i = 0; i < a.sizeInPixels(); ++i)
+                {
+                    auto p = a.data<unsigned char>() + i * 4, q = b.data<unsigned char>() + i * 4;
+                    if (opaqueOnly && p[3] < 128)
+                        continue;
+                    for (unsigned c = first; c <= last; ++c, n += 1.0)
+                        se += ((double)p[c] - q[c]) * ((double)p[c] - q[c]);
+                }
+                return se == 0.0 ? 100.0 : 10.0 * std::log10(255.0 * 255.0 * n / se);
+            };
+
+        auto bc1 = src->compress(Image::BC1_RGBA_UNORM);
+        REQUIRE(bc1);
+        CHECK(bc1->compressed());
+        CHECK(bc1->sizeInBytes() == src->sizeInBytes() / 8);
+
+        auto bc1_out = bc1->decompress();
+        REQUIRE(bc1_out);
+        CHECK(bc1_out->pixelFormat() == Image::R8G8B8A8_UNORM);
+        CHECK(psnr(*src, *bc1_out, 0, 2, true) > 33.0);
+
+        // BC1 alpha is a 1-bit cutout:
+        unsigned alphaMismatches = 0;
+        for (unsigned i = 0; i < src->sizeInPixels(); ++i)
+            if ((src->data<unsigned char>()[i * 4 + 3] >= 128) != (bc1_out->data<unsigned char>()[i * 4 + 3] == 255))
+                ++alphaMismatches;
+        CHECK(alphaMismatches == 0);
+
+        auto bc3 = src->compress(Image::BC3_RGBA_UNORM);
+        REQUIRE(bc3);
+        CHECK(bc3->sizeInBytes() == src->sizeInBytes() / 4);
+
+        auto bc3_out = bc3->decompress();
+        REQUIRE(bc3_out);
+        CHECK(psnr(*src, *bc3_out, 0, 2, false) > 33.0);
+        CHECK(psnr(*src, *bc3_out, 3, 3, false) > 45.0);
+
+        // partial edge blocks and format conversion:
+        auto odd = Image::create(Image::R8G8B8_SRGB, 10, 7);
+        odd->fill(Image::Pixel(0.2f, 0.4f, 0.6f, 1.0f));
+        auto odd_bc = odd->compress(Image::BC1_RGBA_SRGB);
+        REQUIRE(odd_bc);
+        CHECK(odd_bc->sizeInBytes() == 3 * 2 * 8);
+        auto odd_out = odd_bc->decompress();
+        REQUIRE(odd_out);
+        CHECK(odd_out->pixelFormat() == Image::R8G8B8A8_SRGB);
+        CHECK(glm::all(glm::epsilonEqual(odd_out->read(9, 6), odd->read(9, 6), 0.02f)));
+
+        CHECK(src->compress(Image::R8G8B8A8_UNORM) == nullptr);
+    }
+
+    SECTION("In-place stream")
+    {
+        std::string str = "rocky";
+        util::imemstream in(str);
+        in.seekg(0, std::ios::end);
+        CHECK(in.tellg() == 5);
+        in.seekg(1, std::ios::beg);
+        std::string rest;
+        in >> rest;
+        CHECK(rest == "ocky");
+    }
 }
 
 TEST_CASE("Heightfield")
@@ -382,6 +993,36 @@ TEST_CASE("SRS")
         CHECK((b.valid() && b.xmin == 166000 && b.xmax == 834000 && b.ymin == 1116915 && b.ymax == 10000000));
     }
 
+    SECTION("Approximate grid transform")
+    {
+        // a 256x256 tile of spherical mercator, reprojected to UTM:
+        const unsigned size = 256;
+        auto xform = SRS::SPHERICAL_MERCATOR.to(SRS("epsg:32632"));
+        REQUIRE(xform.valid());
+
+        std::vector<glm::dvec3> exact(size * size);
+        double x0 = 700000.0, y0 = 5600000.0, cell = 40000.0 / (double)size;
+        for (unsigned r = 0; r < size; ++r)
+            for (unsigned c = 0; c < size; ++c)
+                exact[r * size + c] = { x0 + cell * c, y0 + cell * r, 0.0 };
+
+        auto approx = exact;
+        CHECK(xform.transformArray(exact.data(), exact.size()));
+        CHECK(xform.transformGrid(approx.data(), size, size, 0.1));
+
+        double worst = 0.0;
+        for (unsigned i = 0; i < exact.size(); ++i)
+            worst = std::max(worst, glm::distance(glm::dvec2(exact[i]), glm::dvec2(approx[i])));
+        CHECK(worst < 0.2);
+
+        // zero error means exact:
+        for (unsigned r = 0; r < size; ++r)
+            for (unsigned c = 0; c < size; ++c)
+                approx[r * size + c] = { x0 + cell * c, y0 + cell * r, 0.0 };
+        CHECK(xform.transformGrid(approx.data(), size, size, 0.0));
+        CHECK(approx == exact);
+    }
+
     SECTION("Quadrilateralized Spherical Cube SRS")
     {
         double E = 1.0;
@@ -703,6 +1344,113 @@ TEST_CASE("IO")
         }
     }
 
+#ifdef ROCKY_HAS_HTTPLIB
+    SECTION("Connection reuse")
+    {
+        // local stand-in for a tile server
+        httplib::Server server;
+        server.Get(R"(/tiles/(\d+))", [](const httplib::Request& req, httplib::Response& res)
+            {
+                res.set_content(std::string(1024, (char)std::stoi(req.matches[1])), "application/octet-stream");
+            });
+        int port = server.bind_to_any_port("127.0.0.1");
+        REQUIRE(port > 0);
+        std::thread listener([&]() { server.listen_after_bind(); });
+        while (!server.is_running())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        auto before = URI::connectionStats();
+        const int count = 16;
+        IOOptions io;
+        for (int i = 0; i < count; ++i)
+        {
+            URI uri("http://127.0.0.1:" + std::to_string(port) + "/tiles/" + std::to_string(i));
+            auto r = uri.read(io);
+            REQUIRE(r.ok());
+            CHECK(r.value().content.data.size() == 1024);
+        }
+        auto after = URI::connectionStats();
+
+        // sequential requests to one host should share a single keep-alive connection
+        CHECK(after.created - before.created == 1);
+        CHECK(after.reused - before.reused == count - 1);
+
+        server.stop();
+        listener.join();
+    }
+
+    SECTION("I/O threads following a shared read")
+    {
+        // local server that holds its response until we release it
+        httplib::Server server;
+        std::atomic_bool release = { false };
+        server.Get("/tile", [&](const httplib::Request&, httplib::Response& res)
+            {
+                while (!release)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                res.set_content("tile", "text/plain");
+            });
+        int port = server.bind_to_any_port("127.0.0.1");
+        REQUIRE(port > 0);
+        std::thread listener([&]() { server.listen_after_bind(); });
+        while (!server.is_running())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        IOOptions io;
+        URI uri("http://127.0.0.1:" + std::to_string(port) + "/tile");
+        auto pool = detail::ioPool();
+        const unsigned threads = pool->concurrency();
+
+        // occupy every I/O thread..
+        std::atomic_bool go = { false };
+        std::atomic_uint busy = { 0u };
+        for (unsigned i = 0; i < threads; ++i)
+            jobs::dispatch([&]() { ++busy; while (!go) std::this_thread::yield(); }, jobs::context{ "blocker", pool });
+        while (busy < threads)
+            std::this_thread::yield();
+
+        // ..lead the read from a thread outside the pool..
+        std::atomic_bool leaderOK = { false };
+        std::thread leader([&]() { leaderOK = uri.read(io).ok(); });
+        while (io.services().uriReads.size() == 0)
+            std::this_thread::yield();
+
+        // ..then free the pool for jobs that join that read. If the leader's fetch
+        // needed an I/O thread, nothing would ever run it.
+        std::vector<jobs::future<Result<URIResponse>>> followers;
+        for (unsigned i = 0; i < threads; ++i)
+        {
+            followers.emplace_back(jobs::dispatch([&](Cancelable& c) { return uri.read(io.with(c)); },
+                jobs::context{ "follower", pool, []() { return FLT_MAX; } }));
+        }
+        go = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        release = true;
+
+        auto finished = [&]() {
+            return std::all_of(followers.begin(), followers.end(), [](auto& f) { return f.available(); }); };
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!finished() && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        REQUIRE(finished());
+
+        leader.join();
+        CHECK(leaderOK);
+        for (auto& follower : followers)
+        {
+            auto& r = follower.join();
+            CHECKED_IF(r.ok())
+            {
+                CHECK(r.value().content.data == "tile");
+            }
+        }
+
+        server.stop();
+        listener.join();
+    }
+#endif
+
     SECTION("URI")
     {
         URI file("C:/folder/filename.ext");
@@ -735,6 +1483,706 @@ TEST_CASE("IO")
     }
 }
 
+TEST_CASE("LRUCache")
+{
+    SECTION("Entry count")
+    {
+        util::LRUCache<int, int> cache(4);
+        for (int i = 0; i < 4; ++i)
+            cache.put(i, i * 10);
+        CHECK(cache.get(0).value_or(-1) == 0); // touch 0 so 1 is the LRU
+        cache.put(4, 40);
+        CHECK(cache.size() == 4);
+        CHECK(cache.get(1).has_value() == false);
+        CHECK(cache.get(0).has_value() == true);
+        CHECK(cache.get(4).value_or(-1) == 40);
+        CHECK(cache.hits() == 3);
+        CHECK(cache.misses() == 1);
+    }
+
+    SECTION("Byte budget")
+    {
+        util::LRUCache<std::string, std::string> cache(1000,
+            [](const std::string& value) { return value.size(); }, 1);
+
+        cache.put("a", std::string(400, 'a'));
+        cache.put("b", std::string(400, 'b'));
+        cache.put("c", std::string(10, 'c'));
+        CHECK(cache.size() == 810);
+        CHECK(cache.count() == 3);
+
+        // a big value pushes out the oldest entries until it fits:
+        cache.put("d", std::string(600, 'd'));
+        CHECK(cache.size() <= 1000);
+        CHECK(cache.get("a").has_value() == false);
+        CHECK(cache.get("b").has_value() == false);
+        CHECK(cache.get("c").has_value() == true);
+        CHECK(cache.get("d").has_value() == true);
+
+        // a value larger than the entire budget is not cached:
+        cache.put("e", std::string(2000, 'e'));
+        CHECK(cache.get("e").has_value() == false);
+        CHECK(cache.get("d").has_value() == true);
+    }
+
+    SECTION("Large entry")
+    {
+        // automatic sharding must not split a cost budget so far that big entries can't fit
+        util::LRUCache<std::string, std::string> cache(64 * 1024 * 1024,
+            [](const std::string& value) { return value.size(); });
+
+        cache.put("small", std::string(100, 's'));
+        cache.put("big", std::string(64 * 1024 * 1024 - 1024, 'b'));
+        CHECK(cache.get("big").has_value() == true);
+        CHECK(cache.get("small").has_value() == true);
+        CHECK(cache.count() == 2);
+    }
+
+    SECTION("Sharded")
+    {
+        util::LRUCache<int, int> cache(1024, {}, 8);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&cache, t]()
+                {
+                    for (int i = 0; i < 10000; ++i)
+                    {
+                        int key = (i * 7 + t) % 2048;
+                        if (!cache.get(key))
+                            cache.put(key, key);
+                    }
+                });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        CHECK(cache.size() <= 1024);
+        CHECK(cache.hits() + cache.misses() == 40000);
+        CHECK(cache.get(2047).value_or(2047) == 2047);
+    }
+}
+
+TEST_CASE("SentryTracker")
+{
+    detail::SentryTracker<int> tracker;
+    auto a = tracker.emplace(1);
+    auto b = tracker.emplace(2);
+    auto c = tracker.emplace(3);
+
+    // new entries survive the first flush
+    std::vector<int> disposed;
+    auto dispose = [&](int value) { disposed.push_back(value); return true; };
+    tracker.flush(~0u, dispose);
+    CHECK(disposed.empty());
+    CHECK(tracker._size == 3);
+
+    // entries that don't update before the next flush are disposed, except
+    // for erased ones, which are never handed to the disposal function
+    b = tracker.update(b);
+    tracker.erase(c);
+    CHECK(tracker._size == 2);
+    tracker.flush(~0u, dispose);
+    CHECK(disposed == std::vector<int>{ 1 });
+    CHECK(tracker._size == 1);
+    CHECK(tracker.snapshot() == std::vector<int>{ 2 });
+}
+
+TEST_CASE("Terrain eviction")
+{
+    const std::size_t MB = 1048576u;
+    Profile profile("global-geodetic");
+
+    auto quad = [&](unsigned x, std::uint64_t lastFrame, float range)
+        {
+            TerrainTilePager::EvictionCandidate c;
+            c.parent = TileKey(5, x, 0, profile).id();
+            c.lastFrame = lastFrame;
+            c.range = range;
+            c.memory.cpu = 10 * MB;
+            c.memory.gpu = 8 * MB;
+            return c;
+        };
+
+    TerrainTileMemory usage;
+    usage.cpu = 100 * MB;
+    usage.gpu = 90 * MB;
+
+    SECTION("Order")
+    {
+        std::vector<TerrainTilePager::EvictionCandidate> candidates = {
+            quad(0, 30, 100.0f), quad(1, 10, 100.0f), quad(2, 20, 500.0f), quad(3, 10, 900.0f), quad(4, 20, 50.0f) };
+
+        // nothing to page out under the budget, but still sorted
+        CHECK(TerrainTilePager::selectEvictions(candidates, usage, 200 * MB) == 0u);
+
+        std::vector<unsigned> order;
+        for (auto& c : candidates)
+            order.push_back(c.parent.x());
+
+        // least recently visible first, and the farthest among those seen in the same frame
+        const std::vector<unsigned> expected = { 3, 1, 2, 4, 0 };
+        CHECK(order == expected);
+    }
+
+    SECTION("Stops under budget")
+    {
+        std::vector<TerrainTilePager::EvictionCandidate> candidates = {
+            quad(0, 1, 0.0f), quad(1, 2, 0.0f), quad(2, 3, 0.0f), quad(3, 4, 0.0f) };
+
+        // the larger of cpu and gpu counts: 100 -> 90 -> 80 MB
+        CHECK(TerrainTilePager::selectEvictions(candidates, usage, 85 * MB) == 2u);
+        CHECK(TerrainTilePager::selectEvictions(candidates, usage, 80 * MB) == 2u);
+        CHECK(TerrainTilePager::selectEvictions(candidates, usage, 79 * MB) == 3u);
+
+        // runs out of candidates before reaching the budget
+        CHECK(TerrainTilePager::selectEvictions(candidates, usage, 1 * MB) == 4u);
+    }
+
+    SECTION("Subdivision hysteresis")
+    {
+        const std::size_t budget = 100 * MB;
+        TerrainTileMemory held;
+
+        CHECK(TerrainTilePager::canSubdivide(usage, 0u)); // unlimited
+
+        held.cpu = 94 * MB;
+        CHECK(TerrainTilePager::canSubdivide(held, budget));
+
+        // stops 5% short of the budget, on the larger of cpu and gpu
+        held.cpu = budget - budget / 20u;
+        CHECK(TerrainTilePager::canSubdivide(held, budget) == false);
+        held.cpu = 50 * MB;
+        held.gpu = 96 * MB;
+        CHECK(TerrainTilePager::canSubdivide(held, budget) == false);
+
+        // and stays stopped until eviction brings it back under that mark
+        std::vector<TerrainTilePager::EvictionCandidate> candidates = { quad(0, 1, 0.0f) };
+        held.gpu = 101 * MB;
+        CHECK(TerrainTilePager::selectEvictions(candidates, held, budget) == 1u);
+        held -= candidates.front().memory;
+        CHECK(TerrainTilePager::canSubdivide(held, budget));
+    }
+}
+
+TEST_CASE("CameraPredictor")
+{
+    const double dt = 1.0 / 60.0;
+
+    SECTION("Velocity")
+    {
+        CameraPredictor predictor;
+        CHECK(predictor.predict(1.0, 4).empty());
+
+        // heading east at 100 m/s
+        for (int i = 0; i < 8; ++i)
+            predictor.sample(vsg::dvec3(100.0 * dt * i, 0, 0), dt * i);
+
+        CHECK(predictor.frameTime() == Approx(dt));
+        auto revision = predictor.revision();
+
+        auto eyes = predictor.predict(1.0, 4);
+        REQUIRE(eyes.size() == 4);
+        CHECK(eyes[0].x == Approx(100.0 * dt * 7 + 25.0));
+        CHECK(eyes[3].x == Approx(100.0 * dt * 7 + 100.0));
+        CHECK(eyes[3].y == Approx(0.0));
+
+        // turning north is a change of course
+        for (int i = 8; i < 16; ++i)
+            predictor.sample(vsg::dvec3(100.0 * dt * 7, 100.0 * dt * (i - 7), 0), dt * i);
+
+        CHECK(predictor.revision() > revision);
+        eyes = predictor.predict(1.0, 1);
+        REQUIRE(eyes.size() == 1);
+        CHECK(eyes[0].y > 100.0 * dt * 8);
+        revision = predictor.revision();
+
+        // and so is stopping
+        for (int i = 16; i < 24; ++i)
+            predictor.sample(vsg::dvec3(100.0 * dt * 7, 100.0 * dt * 9, 0), dt * i);
+
+        CHECK(predictor.revision() > revision);
+        CHECK(predictor.predict(1.0, 4).empty());
+    }
+
+    SECTION("Path")
+    {
+        CameraPredictor predictor;
+        predictor.sample(vsg::dvec3(0, 0, 0), 0.0);
+
+        auto revision = predictor.revision();
+        predictor.setPath({ { vsg::dvec3(0, 0, 0), 0.0 }, { vsg::dvec3(1000, 0, 0), 1.0 }, { vsg::dvec3(1000, 1000, 0), 2.0 } });
+        CHECK(predictor.revision() > revision);
+
+        // follows the path even though the camera hasn't moved yet
+        auto eyes = predictor.predict(1.5, 3);
+        REQUIRE(eyes.size() == 3);
+        CHECK(eyes[0].x == Approx(500.0));
+        CHECK(eyes[1].x == Approx(1000.0));
+        CHECK(eyes[2].y == Approx(500.0));
+
+        // stops at the end of the path
+        eyes = predictor.predict(10.0, 10);
+        REQUIRE(eyes.size() == 3);
+        CHECK(eyes.back().y == Approx(1000.0));
+
+        // and forgets it once the camera gets there
+        revision = predictor.revision();
+        for (int i = 1; i <= 8; ++i)
+            predictor.sample(vsg::dvec3(1000, 1000, 0), 2.0 + dt * i);
+        CHECK(predictor.revision() > revision);
+        CHECK(predictor.predict(1.0, 4).empty());
+    }
+}
+
+TEST_CASE("Terrain prefetch model", "[.benchmark]")
+{
+    // Replays a scripted fly-to through a simplified model of the terrain
+    // pager's scheduling and reports how long the destination takes to reach
+    // full resolution, with and without prefetching. It does not run
+    // TerrainTilePager itself: it uses the pager's screen-space test, and the
+    // real CameraPredictor, but each tile takes a fixed number of frames to
+    // load on one of a few workers. So it compares the prefetch policies, not
+    // the pager's actual timing.
+    // Hidden by default; run with: rocky_tests "[.benchmark]"
+    Profile profile("global-geodetic");
+    auto toECEF = SRS::WGS84.to(SRS::ECEF);
+
+    const double fps = 60.0;
+    const unsigned flightFrames = 240, maxFrames = 3000;
+    const unsigned loadFrames = 6, workers = 8, maxLevel = 14;
+    const unsigned prefetchFrames = 60;
+    const double ratio = (256.0 + 128.0) / 1080.0; // tilePixelSize + pixelError over viewport height
+
+    auto geodetic = [&](double lon, double lat, double alt)
+        {
+            glm::dvec3 out;
+            toECEF.transform(glm::dvec3(lon, lat, alt), out);
+            return vsg::dvec3(out.x, out.y, out.z);
+        };
+
+    // arcing flight from high over North America down to a low view of the Alps
+    const vsg::dvec3 start = geodetic(-100.0, 40.0, 2e6), end = geodetic(10.0, 45.0, 2e3);
+    auto eyeAt = [&](unsigned frame)
+        {
+            double t = std::min((double)frame / (double)flightFrames, 1.0);
+            double s = t * t * (3.0 - 2.0 * t);
+            double alt = 2e6 + (2e3 - 2e6) * s + std::sin(M_PI * s) * 3e6;
+            auto dir = vsg::normalize(start * (1.0 - s) + end * s);
+            auto ground = geodetic(-100.0 + 110.0 * s, 40.0 + 5.0 * s, 0.0);
+            return dir * vsg::length(ground) + dir * alt;
+        };
+
+    std::map<TileKey, Sphere> bounds;
+    auto subtilesInRange = [&](const TileKey& key, const std::vector<vsg::dvec3>& eyes)
+        {
+            auto iter = bounds.find(key);
+            if (iter == bounds.end())
+                iter = bounds.emplace(key, key.extent().createWorldBoundingSphere(0.0, 0.0)).first;
+
+            vsg::dvec3 center(iter->second.center.x, iter->second.center.y, iter->second.center.z);
+            double r = iter->second.radius;
+
+            for (auto& eye : eyes)
+            {
+                double range = vsg::length(center - eye);
+                if (range < r || r > range * ratio)
+                    return true;
+            }
+            return false;
+        };
+
+    enum Mode { Off, Velocity, Path };
+
+    auto run = [&](Mode mode, unsigned& loads)
+        {
+            std::set<TileKey> loaded;
+            std::map<TileKey, unsigned> working; // key -> frame done
+            std::vector<std::pair<TileKey, bool>> queue; // key, prefetch
+            CameraPredictor predictor;
+            std::uint64_t revision = 0;
+            loads = 0;
+
+            if (mode == Path)
+            {
+                std::vector<CameraPredictor::Waypoint> path;
+                for (unsigned f = 0; f <= flightFrames; f += flightFrames / 16)
+                    path.emplace_back(CameraPredictor::Waypoint{ eyeAt(f), (double)f / fps });
+                predictor.setPath(path);
+            }
+
+            // walks the quadtree the way the record traversal does; returns true
+            // if every tile it reaches is loaded.
+            auto walk = [&](const std::vector<vsg::dvec3>& eyes, bool prefetch)
+                {
+                    bool complete = true;
+                    std::vector<TileKey> stack = profile.allKeysAtLOD(0);
+                    while (!stack.empty())
+                    {
+                        auto key = stack.back();
+                        stack.pop_back();
+
+                        if (loaded.count(key) == 0)
+                        {
+                            complete = false;
+                            if (working.count(key) == 0)
+                            {
+                                auto i = std::find_if(queue.begin(), queue.end(), [&](auto& q) { return q.first == key; });
+                                if (i == queue.end())
+                                    queue.emplace_back(key, prefetch);
+                                else if (!prefetch)
+                                    i->second = false;
+                            }
+                        }
+                        else if (key.level < maxLevel && subtilesInRange(key, eyes))
+                        {
+                            for (unsigned q = 0; q < 4; ++q)
+                                stack.emplace_back(key.createChildKey(q));
+                        }
+                    }
+                    return complete;
+                };
+
+            for (unsigned frame = 0; frame < maxFrames; ++frame)
+            {
+                auto eye = eyeAt(frame);
+
+                // finish loads
+                for (auto i = working.begin(); i != working.end(); )
+                {
+                    if (i->second <= frame)
+                        loaded.insert(i->first), i = working.erase(i);
+                    else
+                        ++i;
+                }
+
+                // visible requests replace the previous frame's
+                queue.erase(std::remove_if(queue.begin(), queue.end(), [](auto& q) { return !q.second; }), queue.end());
+
+                bool complete = walk({ eye }, false);
+                if (complete && frame >= flightFrames)
+                    return frame;
+
+                if (mode != Off)
+                {
+                    predictor.sample(eye, (double)frame / fps);
+                    if (predictor.revision() != revision)
+                    {
+                        // change of course; drop the prefetches that haven't started
+                        queue.erase(std::remove_if(queue.begin(), queue.end(), [](auto& q) { return q.second; }), queue.end());
+                        revision = predictor.revision();
+                    }
+                    walk(predictor.predict(prefetchFrames / fps, 8), true);
+                }
+
+                // visible work first, then coarse before fine
+                std::stable_sort(queue.begin(), queue.end(), [](auto& a, auto& b)
+                    {
+                        return a.second != b.second ? !a.second : a.first.level < b.first.level;
+                    });
+
+                while (working.size() < workers && !queue.empty())
+                {
+                    working[queue.front().first] = frame + loadFrames;
+                    queue.erase(queue.begin());
+                    ++loads;
+                }
+            }
+            return maxFrames;
+        };
+
+    const char* names[] = { "off", "velocity", "path" };
+    for (auto mode : { Off, Velocity, Path })
+    {
+        unsigned loads = 0;
+        auto frames = run(mode, loads);
+        CHECK(frames < maxFrames);
+        std::cout << "Prefetch model " << names[mode] << ": full resolution " << (frames - flightFrames) * 1000.0 / fps
+            << " ms after arrival (" << loads << " tiles loaded)" << std::endl;
+    }
+}
+
+TEST_CASE("GeometryArena")
+{
+    auto indices = vsg::ushortArray::create(6);
+    auto arena = GeometryArena::create(4u, 289u, 3u, indices);
+    auto other = GeometryArena::create(4u, 289u, 3u, indices);
+
+    CHECK(arena->capacity() == 4u);
+    CHECK(arena->leased() == 0u);
+    CHECK(arena->bytes() == 0u); // not compiled until the first geometry arrives
+
+    // geometries must match the arena's vertex layout
+    VSGContext context;
+    CHECK(arena->add({ vsg::vec3Array::create(289) }, context) == nullptr);
+    CHECK(arena->add({ vsg::vec3Array::create(17), vsg::vec3Array::create(17), vsg::vec3Array::create(17) }, context) == nullptr);
+    CHECK(arena->leased() == 0u);
+
+    // consecutive draws into the same command buffer bind only once
+    int commandBuffers[2];
+    GeometryArena::unbind();
+    CHECK(arena->needsBind(&commandBuffers[0]));
+    CHECK(arena->needsBind(&commandBuffers[0]) == false);
+    CHECK(arena->needsBind(&commandBuffers[1]));
+    CHECK(other->needsBind(&commandBuffers[1]));
+    CHECK(arena->needsBind(&commandBuffers[1]));
+    GeometryArena::unbind();
+    CHECK(arena->needsBind(&commandBuffers[1]));
+    GeometryArena::unbind();
+}
+
+TEST_CASE("GeometryPool arena")
+{
+    // Without a device the arena can't compile, so geometries keep their own
+    // buffers; with one, they move into the arena and drop their own indices.
+    // Either way the pool must hand them out.
+    VSGContext context = VSGContextFactory::create(nullptr);
+    REQUIRE(context->status.ok());
+
+    Profile profile("global-geodetic");
+    GeometryPool pool(SRS::ECEF);
+    pool.setArenaSize(4u, context);
+
+    GeometryPool::Settings settings;
+    auto a = pool.getPooledGeometry(TileKey(2, 1, 1, profile), settings, nullptr);
+    auto b = pool.getPooledGeometry(TileKey(2, 2, 1, profile), settings, nullptr);
+    auto c = pool.getPooledGeometry(TileKey(3, 1, 2, profile), settings, nullptr);
+    REQUIRE(a.valid());
+    REQUIRE(b.valid());
+    REQUIRE(c.valid());
+    CHECK(a == b); // same LOD and row share a geometry
+    CHECK(a != c);
+    CHECK(pool.size() == 2u);
+
+    for (auto& geom : { a, c })
+    {
+        if (geom->arenaEntry)
+        {
+            CHECK(geom->indices == nullptr);
+            CHECK(geom->arrays.empty());
+            REQUIRE(geom->commands.size() == 1u);
+            auto draw = geom->commands.front().cast<vsg::DrawIndexed>();
+            REQUIRE(draw);
+            CHECK(draw->vertexOffset == geom->arenaEntry->vertexOffset);
+            CHECK(geom->instance()->arenaEntry == geom->arenaEntry);
+        }
+        else
+        {
+            CHECK(geom->indices.valid());
+        }
+    }
+
+    if (pool.arena())
+        CHECK(pool.arena()->leased() <= 2u);
+}
+
+TEST_CASE("Terrain tile table")
+{
+    // CPU-side objects only; the table doesn't touch the device until it's compiled
+    vsg::DescriptorSetLayoutBindings bindings{
+        { 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr },
+        { 1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr },
+        { 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_ALL, nullptr },
+        { 3, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_ALL, nullptr } };
+    auto layout = vsg::PipelineLayout::create(
+        vsg::DescriptorSetLayouts{ vsg::DescriptorSetLayout::create(bindings) }, vsg::PushConstantRanges{});
+
+    auto texture = [](std::uint32_t binding) {
+        return vsg::DescriptorImage::create(vsg::Sampler::create(), vsg::ubvec4Array2D::create(1, 1), binding);
+        };
+    auto uniforms = vsg::ubyteArray::create(64);
+    auto settings = vsg::DescriptorBuffer::create(vsg::ubyteArray::create(16), 3);
+
+    auto table = TerrainTileTable::create(4u, layout, texture(0), texture(1), uniforms, 2u, settings);
+    CHECK(table->size() == 4u);
+    CHECK(table->leased() == 0u);
+
+    // mismatched uniforms are rejected
+    CHECK(table->add(texture(0), texture(1), vsg::ubyteArray::create(32)) == nullptr);
+
+    // slot zero is the placeholder, so a 4-slot table leases 3, low slots first
+    auto a = table->add(texture(0), texture(1), vsg::ubyteArray::create(64));
+    auto b = table->add(texture(0), texture(1), vsg::ubyteArray::create(64));
+    auto c = table->add(texture(0), texture(1), vsg::ubyteArray::create(64));
+    REQUIRE((a && b && c));
+    CHECK(a->slot == 1u);
+    CHECK(b->slot == 2u);
+    CHECK(c->slot == 3u);
+    CHECK(table->leased() == 3u);
+
+    // full
+    CHECK(table->add(texture(0), texture(1), vsg::ubyteArray::create(64)) == nullptr);
+
+    // dropping the last reference to an entry frees its slot for the next tile
+    b = nullptr;
+    CHECK(table->leased() == 2u);
+    auto d = table->add(texture(0), texture(1), vsg::ubyteArray::create(64));
+    REQUIRE(d);
+    CHECK(d->slot == 2u);
+
+    a = nullptr, c = nullptr, d = nullptr;
+    CHECK(table->leased() == 0u);
+}
+
+TEST_CASE("Line batch packing")
+{
+    auto a = LineGeometryNode::create();
+    a->set(std::vector<vsg::dvec3>{ { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 } }, std::vector<vsg::vec4>{}, LineTopology::Strip);
+    auto b = LineGeometryNode::create();
+    b->set(std::vector<vsg::dvec3>{ { 0, 0, 5 }, { 0, 0, 6 } }, std::vector<vsg::vec4>{}, LineTopology::Strip);
+    b->setFirst(1);
+
+    // a appears twice, and the last line has no geometry
+    auto geometry = detail::packLineBatch({ a.get(), b.get(), a.get(), nullptr });
+    REQUIRE(geometry);
+    REQUIRE(geometry->arrays.size() == 4u);
+    REQUIRE(geometry->commands.size() == 1u);
+
+    auto current = geometry->arrays[0]->data.cast<vsg::vec3Array>();
+    auto indices = geometry->indices->data.cast<vsg::uintArray>();
+    REQUIRE(current);
+    REQUIRE(indices);
+    CHECK(current->size() == a->_current->size() + b->_current->size()); // shared geometry packed once
+    CHECK(indices->size() == a->_indices->size() + b->_indices->size());
+
+    auto draw = geometry->commands.front().cast<vsg::DrawIndexedIndirect>();
+    REQUIRE(draw);
+    REQUIRE(draw->drawCount == 4u);
+    auto* commands = static_cast<const VkDrawIndexedIndirectCommand*>(draw->bufferInfo->data->dataPointer());
+
+    // each line is its own instance
+    for (std::uint32_t m = 0; m < 4; ++m)
+    {
+        CHECK(commands[m].firstInstance == m);
+        CHECK(commands[m].instanceCount == 1u);
+        CHECK(commands[m].vertexOffset % 4 == 0); // keeps the shader's corner code intact
+    }
+
+    CHECK(commands[0].indexCount == a->_drawCommand->indexCount);
+    CHECK(commands[0].firstIndex == a->_drawCommand->firstIndex);
+    CHECK(commands[0].vertexOffset == 0);
+    CHECK(commands[2].firstIndex == commands[0].firstIndex);
+    CHECK(commands[2].vertexOffset == commands[0].vertexOffset);
+    CHECK(commands[3].indexCount == 0u);
+
+    // b's draw finds exactly b's vertices
+    auto& cb = commands[1];
+    CHECK(cb.indexCount == b->_drawCommand->indexCount);
+    CHECK(cb.firstIndex == a->_indices->size() + b->_drawCommand->firstIndex);
+    CHECK(cb.vertexOffset == (std::int32_t)a->_current->size());
+    for (std::uint32_t k = 0; k < cb.indexCount; ++k)
+    {
+        auto packed = current->at(cb.vertexOffset + indices->at(cb.firstIndex + k));
+        auto original = b->_current->at(b->_indices->at(b->_drawCommand->firstIndex + k));
+        CHECK(packed == original);
+    }
+
+    // hidden instances are the only ones the shader drops
+    CHECK(detail::LineBatch::hidden()[3][3] == 0.0f);
+    CHECK(vsg::mat4(vsg::translate(1.0, 2.0, 3.0) * vsg::rotate(0.5, 0.0, 0.0, 1.0))[3][3] == 1.0f);
+}
+
+TEST_CASE("Terrain draw binds", "[.benchmark]")
+{
+    // Counts the buffer binds and draws a frame of terrain tiles records, with
+    // and without the geometry arena. Each draw that brings its own buffers
+    // binds vertices and indices; arena draws bind only when the arena isn't
+    // already bound. Recording needs no GPU, so the binds are tallied with the
+    // same bookkeeping the tiles use.
+    // Hidden by default; run with: rocky_tests "[.benchmark]"
+    const unsigned tiles = 2000;
+    auto indices = vsg::ushortArray::create(6);
+    int commandBuffer;
+
+    std::mt19937 rng(42);
+
+    for (auto fit : { 0.0, 1.0, 0.9, 0.5 })
+    {
+        auto arena = GeometryArena::create(tiles, 289u, 3u, indices);
+        unsigned binds = 0, draws = 0;
+
+        GeometryArena::unbind();
+        for (unsigned i = 0; i < tiles; ++i)
+        {
+            bool inArena = std::uniform_real_distribution<double>(0.0, 1.0)(rng) < fit;
+            if (inArena)
+            {
+                if (arena->needsBind(&commandBuffer))
+                    binds += 2;
+            }
+            else
+            {
+                binds += 2;
+                GeometryArena::unbind();
+            }
+            ++draws;
+        }
+        GeometryArena::unbind();
+
+        std::cout << "Terrain draws, " << (int)(fit * 100.0) << "% in arena: "
+            << binds << " binds, " << draws << " draws per frame" << std::endl;
+    }
+}
+
+TEST_CASE("DiskCache")
+{
+    auto path = (std::filesystem::temp_directory_path() / "rocky_tests_disk_cache").string();
+    std::filesystem::remove_all(path);
+
+    Content content;
+    content.type = "image/png";
+    content.data = std::string(1000, 'x');
+
+    {
+        DiskCache cache(path, 4096);
+        REQUIRE(cache.status.ok());
+
+        cache.put("http://server/1.png", content);
+        cache.put("http://server/2.png", content, std::chrono::seconds(0)); // do not cache
+        cache.flush();
+
+        auto r = cache.get("http://server/1.png");
+        CHECKED_IF(r.has_value())
+        {
+            CHECK(r->type == content.type);
+            CHECK(r->data == content.data);
+        }
+        CHECK(!cache.get("http://server/2.png").has_value());
+
+        // overflow the capacity; the oldest entry should go
+        for (int i = 3; i < 8; ++i)
+            cache.put("http://server/" + std::to_string(i) + ".png", content);
+        cache.flush();
+        CHECK(cache.size() <= cache.capacity());
+        CHECK(!cache.get("http://server/3.png").has_value());
+        CHECK(cache.get("http://server/7.png").has_value());
+
+        // a second put of the same key wins, expiry and all
+        Content newer = content;
+        newer.data = std::string(1000, 'y');
+        cache.put("http://server/8.png", content, std::chrono::seconds(1));
+        cache.put("http://server/8.png", newer, std::chrono::seconds(3600));
+        cache.flush();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2100));
+        auto r8 = cache.get("http://server/8.png");
+        CHECKED_IF(r8.has_value())
+        {
+            CHECK(r8->data == newer.data);
+        }
+        CHECK(r8.has_value());
+    }
+
+    // entries survive a restart
+    {
+        DiskCache cache(path, 4096);
+        CHECK(cache.get("http://server/7.png").has_value());
+        cache.clear();
+        CHECK(cache.size() == 0);
+    }
+
+    std::filesystem::remove_all(path);
+}
+
 TEST_CASE("Earth File")
 {
     std::string earthFile = "https://raw.githubusercontent.com/gwaldron/osgearth/master/tests/readymap.earth";
@@ -765,6 +2213,120 @@ TEST_CASE("Earth File")
     }
 }
 
+namespace
+{
+    struct TestOperation : public vsg::Inherit<vsg::Operation, TestOperation>
+    {
+        std::function<void()> function;
+        TestOperation(std::function<void()> f) : function(f) { }
+        void run() override { function(); }
+    };
+}
+
+TEST_CASE("Update budget")
+{
+    VSGContext context = VSGContextFactory::create(nullptr);
+    REQUIRE(context->status.ok());
+
+    std::vector<int> order;
+    for (int i : { 3, 1, 4, 2, 5 })
+    {
+        context->onNextUpdate(TestOperation::create([&order, i]() { order.push_back(i); }),
+            [i]() { return (float)i; });
+    }
+
+    // with no budget, one operation per pass, highest priority first
+    context->updateBudget = std::chrono::microseconds(0);
+    context->onNextUpdate(TestOperation::create([&order]() { order.push_back(0); }), []() { return -1.0f; });
+    context->viewer()->updateOperations->run();
+    CHECK(order == std::vector<int>{ 5 });
+    CHECK(context->updateStats().ran == 1);
+    CHECK(context->updateStats().pending == 5);
+
+    // with room in the budget, everything in priority order
+    context->updateBudget = std::chrono::microseconds(1000000);
+    context->onNextUpdate(TestOperation::create([&order]() { order.push_back(6); }));
+    context->viewer()->updateOperations->run();
+    CHECK(order == std::vector<int>{ 5, 6, 4, 3, 2, 1, 0 });
+    CHECK(context->updateStats().ran == 6);
+    CHECK(context->updateStats().pending == 0);
+}
+
+TEST_CASE("Update budget drain", "[.benchmark]")
+{
+    // Frames needed to merge a burst of tiles that finished loading at once
+    // (as after a fast zoom), each merge taking about 100 us.
+    // Hidden by default; run with: rocky_tests "[.benchmark]"
+    const int count = 300;
+    VSGContext context = VSGContextFactory::create(nullptr);
+    REQUIRE(context->status.ok());
+
+    for (auto budget : { 0, 2000 })
+    {
+        context->updateBudget = std::chrono::microseconds(budget);
+
+        int done = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            context->onNextUpdate(TestOperation::create([&done]() {
+                auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(100);
+                while (std::chrono::steady_clock::now() < end);
+                ++done; }),
+                [i]() { return (float)i; });
+        }
+
+        int frames = 0;
+        while (done < count)
+        {
+            context->viewer()->updateOperations->run();
+            ++frames;
+        }
+
+        std::cout << "Update budget " << budget << " us: " << count << " merges in " << frames
+            << " frames (" << frames * 1000 / 60 << " ms at 60 Hz)" << std::endl;
+    }
+}
+
+TEST_CASE("Compile batching")
+{
+    // No windows means no compile manager, so every compile fails; this checks
+    // that requests from many threads all get answered, in shared batches.
+    VSGContext context = VSGContextFactory::create(nullptr);
+    REQUIRE(context->status.ok());
+
+    const int loaders = 6;
+    std::atomic_int failed = { 0 };
+    std::vector<std::thread> threads;
+    for (int i = 0; i < loaders; ++i)
+    {
+        threads.emplace_back([&]() {
+            if (!context->compile(vsg::Group::create()))
+                ++failed;
+            });
+    }
+    for (auto& t : threads)
+        t.join();
+
+    CHECK(failed == loaders);
+
+    std::atomic_int ready = { 0 };
+    for (int i = 0; i < loaders; ++i)
+    {
+        context->compileAsync(vsg::Group::create(), [&ready](const vsg::CompileResult&) { ++ready; });
+    }
+    while (ready < loaders)
+        std::this_thread::yield();
+
+    auto stats = context->compileStats();
+    CHECK(stats.objects == 2 * loaders);
+    CHECK(stats.batches >= 1);
+    CHECK(stats.batches <= stats.objects);
+
+    // every failed batch of more than one object is compiled again one by one
+    CHECK(stats.retries <= stats.objects);
+    CHECK((stats.retries > 0) == (stats.batches < stats.objects));
+}
+
 TEST_CASE("MapManipulator NaN fix")
 {
     // Test case for issue #105 - NaN error in MapManipulator.cpp